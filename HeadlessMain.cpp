@@ -0,0 +1,1355 @@
+// the OpenGL version include also includes all previous versions
+// Build note: Due to a minefield of preprocessor build flags, the gl_load.hpp must come after 
+// the version include.
+// Build note: Do NOT mistakenly include _int_gl_4_4.h.  That one doesn't define OpenGL stuff 
+// first.
+// Build note: Unlike main.cpp, there is no freeglut here.  The context comes from 
+// HeadlessGlContext (hidden window + WGL on Windows, EGL on Linux).  See ReadMeBuild.txt.
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "ThirdParty/glload/include/glload/gl_load.hpp"
+
+#ifdef WIN32
+#pragma comment(lib, "ThirdParty/glload/lib/glloadD.lib")
+#pragma comment(lib, "opengl32.lib")            // needed for glload::LoadFunctions()
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "Include/OpenGlErrorHandling.h"
+#include "Include/Headless/HeadlessGlContext.h"
+#include "Shaders/ShaderStorage.h"
+
+// for particles, where they live, and how to update them
+#include "ThirdParty/glm/vec2.hpp"
+#include "ThirdParty/glm/mat4x4.hpp"
+
+#include "Include/Buffers/SSBOs/ParticleSsbo.h"
+#include "Include/Particles/ParticleEmitterBar.h"
+#include "Include/ShaderControllers/ParticleReset.h"
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
+#include "Include/Simulation/GpuParticleSimulation.h"
+#include "Include/Simulation/CpuParticleSimulation.h"
+#include "Include/Simulation/CpuRadixSort.h"
+#include "Include/Simulation/CpuParticleKernels.h"
+#include "Include/Simulation/BackendComparison.h"
+#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ParticleScenes.comp"
+#include "Shaders/ParticleRegionBoundaries.comp"
+
+// for timing
+#include "Include/RenderFrameRate/Stopwatch.h"
+#include "Include/RenderFrameRate/GpuStopwatch.h"
+#include "Include/RenderFrameRate/CpuStageStopwatch.h"
+#include "Include/RenderFrameRate/FramePacer.h"
+
+
+// same file as main.cpp loads
+static const char *DEFAULT_COMPUTE_PROFILE_PATH = "ComputeProfile.txt";
+
+// --sort-benchmark runs every power of 2 keys from 2^MIN to 2^N
+// Note: 2^26 key/index pairs are 512MB, and the benchmark needs 4 copies of them.
+static const unsigned int MIN_SORT_BENCHMARK_LOG2 = 14;
+static const unsigned int MAX_SORT_BENCHMARK_LOG2 = 26;
+
+// each sort's or kernel's time (see --sort-benchmark and --kernel-benchmark) is the best of this many
+static const unsigned int BENCHMARK_REPETITIONS = 3;
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Everything that can be changed from the command line.  Defaults match main.cpp.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct HeadlessOptions
+{
+    HeadlessOptions() :
+        _numFrames(1000),
+        _numWarmupFrames(10),
+        _numParticles(20000),
+        _growToParticles(0),
+        _backend("gpu"),
+        _numCpuThreads(0),
+        _simdLevelName("auto"),
+        _particlesPerEmitterPerFrame(20),
+        _numScenes(1),
+        _randomSeed(ShaderControllers::ParticleReset::DEFAULT_RANDOM_SEED),
+        _useShaderCache(true),
+        _submitShadersFirst(true),
+        _particleWorkGroupSize(0),
+        _sortWorkGroupSize(0),
+        _profilePath(DEFAULT_COMPUTE_PROFILE_PATH),
+        _tune(false),
+        _sortBenchmarkMaxLog2(0),
+        _kernelBenchmark(false),
+        _numCompareFrames(0),
+        _repeatCheck(false),
+        _debugContext(false)
+    {
+    }
+
+    unsigned int _numFrames;
+    unsigned int _numWarmupFrames;
+    unsigned int _numParticles;
+
+    // 0 means "never"; the buffer grows (see ParticleSsbo::Resize(...)) after the warmup
+    unsigned int _growToParticles;
+
+    // "gpu" or "cpu" (see IParticleSimulation)
+    std::string _backend;
+
+    // 0 means one per hardware thread
+    unsigned int _numCpuThreads;
+
+    // "auto" or a CpuParticleKernels::SimdLevelName(...)
+    std::string _simdLevelName;
+    unsigned int _particlesPerEmitterPerFrame;
+    unsigned int _numScenes;
+    unsigned int _randomSeed;
+    bool _useShaderCache;
+    bool _submitShadersFirst;
+
+    // 0 means "whatever the profile (or the default) says"
+    unsigned int _particleWorkGroupSize;
+    unsigned int _sortWorkGroupSize;
+
+    // empty if --no-profile
+    std::string _profilePath;
+    bool _tune;
+
+    // 0 means "don't"; otherwise the biggest sort benchmark is 2^this keys
+    unsigned int _sortBenchmarkMaxLog2;
+    bool _kernelBenchmark;
+
+    // 0 means "don't"; otherwise how many frames to check the GPU against the CPU
+    unsigned int _numCompareFrames;
+
+    // run twice with the same seed and check that the particles come out byte for byte the same
+    bool _repeatCheck;
+
+    // "NAME" or "NAME=VALUE"
+    std::vector<std::string> _featureDefines;
+    bool _debugContext;
+};
+
+// the pipeline, in the order that it is run every frame
+enum HeadlessStage
+{
+    STAGE_RESET = 0,
+    STAGE_UPDATE,
+    STAGE_SORT,
+    STAGE_COLLIDE,
+    STAGE_COUNT_NEARBY,
+    NUM_STAGES
+};
+static const char *STAGE_NAMES[NUM_STAGES] =
+{
+    "reset",
+    "update",
+    "sort",
+    "collide",
+    "count nearby"
+};
+
+// the headless stage whose GPU timer covers each compute shader stage (the sort's programs are 
+// all timed together)
+static const HeadlessStage TIMER_STAGE_FOR_COMPUTE_STAGE[ShaderControllers::NUM_COMPUTE_STAGES] =
+{
+    STAGE_RESET,
+    STAGE_UPDATE,
+    STAGE_SORT,
+    STAGE_SORT,
+    STAGE_SORT,
+    STAGE_SORT,
+    STAGE_SORT,
+    STAGE_COLLIDE,
+    STAGE_COUNT_NEARBY
+};
+
+// what --tune tries for each stage
+static const unsigned int TUNE_WORK_GROUP_SIZES[] = { 64, 128, 256, 512, 1024 };
+static const unsigned int TUNE_ITEMS_PER_THREAD[] = { 1, 2, 4 };
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    What one run of the simulation measured.  Times are in seconds.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct HeadlessResults
+{
+    double _startupTime;
+    double _averageStageTimes[NUM_STAGES];
+    double _minStageTimes[NUM_STAGES];
+    double _maxStageTimes[NUM_STAGES];
+    double _averageFrameTime;
+    double _wallTime;
+    double _averageFrameWaitTime;
+    double _barriersPerFrame;
+    unsigned int _numActiveParticles;
+
+    // more than the --particles option if --grow-to grew it
+    unsigned int _particleCapacity;
+
+    // the stage times are CPU times if so, otherwise GPU times
+    bool _timedOnCpu;
+
+    // the particle buffer after the last frame; only read with --repeat-check
+    std::vector<Particle> _finalParticles;
+};
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    programName     argv[0]
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void PrintUsage(const char *programName)
+{
+    printf("usage: %s [options]\n", programName);
+    printf("    --frames N          frames to measure (default 1000)\n");
+    printf("    --warmup N          frames to run before measuring (default 10)\n");
+    printf("    --particles N       particle buffer size (default 20000)\n");
+    printf("    --grow-to N         grow the buffer (by doubling) to hold at least N particles after the warmup\n");
+    printf("    --backend gpu|cpu   where the simulation runs (default gpu)\n");
+    printf("    --threads N         threads for the CPU backend (default: one per hardware thread)\n");
+    printf("    --simd LEVEL        auto, scalar, sse4.1, or avx2 for the CPU backend's update and sort keys \n");
+    printf("                        (default auto: the widest that the CPU has)\n");
+    printf("    --emit N            particles per emitter per frame (default 20)\n");
+    printf("    --scenes N          independent copies of the scene in the one buffer (default 1, max %d)\n", MAX_PARTICLE_SCENES);
+    printf("    --seed N            random seed for the emitters\n");
+    printf("    --no-shader-cache   compile every shader from source (see ShaderStorage::UseProgramBinaryCache)\n");
+    printf("    --serial-shaders    let each controller compile its own shaders (no up-front submission)\n");
+    printf("    --particle-group-size N  work group size for reset/update/collide/count (default %d)\n", PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X);
+    printf("    --sort-group-size N      work group size for the sort, power of 2 (default %d)\n", PARALLEL_SORT_WORK_GROUP_SIZE_X);
+    printf("    --define NAME[=VALUE]    add a #define to every compute shader (repeatable)\n");
+    printf("    --profile PATH      per-stage work group sizes to load, or to save with --tune (default %s)\n", DEFAULT_COMPUTE_PROFILE_PATH);
+    printf("    --no-profile        ignore the profile and start from the defaults\n");
+    printf("    --tune              time every stage at each work group size and items per thread and \n");
+    printf("                        save the fastest to the profile\n");
+    printf("    Note: The group size options override the profile.\n");
+    printf("    --sort-benchmark N  time CpuRadixSort against std::sort and std::stable_sort on 2^%u to 2^N \n", 
+        MIN_SORT_BENCHMARK_LOG2);
+    printf("                        random keys (N <= %u) with --threads threads, then quit without \n", MAX_SORT_BENCHMARK_LOG2);
+    printf("                        running the simulation\n");
+    printf("    --kernel-benchmark  time each SIMD level of the CPU update and sort key loops on one thread \n");
+    printf("                        with --particles particles, then quit without running the simulation\n");
+    printf("    --compare N         check each GPU stage against the CPU backend for N frames, then time both \n");
+    printf("                        backends and print their stage times side by side\n");
+    printf("    --repeat-check      run twice with the same seed and check that the particles come out \n");
+    printf("                        byte for byte the same\n");
+    printf("    --debug             make a debug context and print OpenGL messages\n");
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Reads the command line into the options.
+Parameters: 
+    argc        The number of strings in argv.
+    argv        A pointer to an array of null-terminated, C-style strings.
+    options     Receives the values.
+Returns:
+    False if the command line didn't make sense (or asked for help), otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool ParseCommandLine(int argc, char *argv[], HeadlessOptions &options)
+{
+    for (int argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char *arg = argv[argIndex];
+        bool hasValue = (argIndex + 1 < argc);
+        if (strcmp(arg, "--help") == 0)
+        {
+            return false;
+        }
+        else if (strcmp(arg, "--debug") == 0)
+        {
+            options._debugContext = true;
+        }
+        else if (strcmp(arg, "--no-shader-cache") == 0)
+        {
+            options._useShaderCache = false;
+        }
+        else if (strcmp(arg, "--serial-shaders") == 0)
+        {
+            options._submitShadersFirst = false;
+        }
+        else if (strcmp(arg, "--no-profile") == 0)
+        {
+            options._profilePath.clear();
+        }
+        else if (strcmp(arg, "--tune") == 0)
+        {
+            options._tune = true;
+        }
+        else if (strcmp(arg, "--profile") == 0 && hasValue)
+        {
+            options._profilePath = argv[++argIndex];
+        }
+        else if (strcmp(arg, "--frames") == 0 && hasValue)
+        {
+            options._numFrames = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--warmup") == 0 && hasValue)
+        {
+            options._numWarmupFrames = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--particles") == 0 && hasValue)
+        {
+            options._numParticles = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--grow-to") == 0 && hasValue)
+        {
+            options._growToParticles = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--backend") == 0 && hasValue)
+        {
+            options._backend = argv[++argIndex];
+        }
+        else if (strcmp(arg, "--threads") == 0 && hasValue)
+        {
+            options._numCpuThreads = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--simd") == 0 && hasValue)
+        {
+            options._simdLevelName = argv[++argIndex];
+        }
+        else if (strcmp(arg, "--kernel-benchmark") == 0)
+        {
+            options._kernelBenchmark = true;
+        }
+        else if (strcmp(arg, "--sort-benchmark") == 0 && hasValue)
+        {
+            options._sortBenchmarkMaxLog2 = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--compare") == 0 && hasValue)
+        {
+            options._numCompareFrames = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--repeat-check") == 0)
+        {
+            options._repeatCheck = true;
+        }
+        else if (strcmp(arg, "--emit") == 0 && hasValue)
+        {
+            options._particlesPerEmitterPerFrame = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--scenes") == 0 && hasValue)
+        {
+            options._numScenes = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--seed") == 0 && hasValue)
+        {
+            options._randomSeed = strtoul(argv[++argIndex], 0, 0);
+        }
+        else if (strcmp(arg, "--particle-group-size") == 0 && hasValue)
+        {
+            options._particleWorkGroupSize = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--sort-group-size") == 0 && hasValue)
+        {
+            options._sortWorkGroupSize = strtoul(argv[++argIndex], 0, 10);
+        }
+        else if (strcmp(arg, "--define") == 0 && hasValue)
+        {
+            options._featureDefines.push_back(argv[++argIndex]);
+        }
+        else
+        {
+            fprintf(stderr, "unknown or incomplete argument '%s'\n", arg);
+            return false;
+        }
+    }
+
+    if (options._numParticles == 0)
+    {
+        fprintf(stderr, "--particles must be > 0\n");
+        return false;
+    }
+    if (options._numScenes == 0 || options._numScenes > MAX_PARTICLE_SCENES)
+    {
+        fprintf(stderr, "--scenes must be 1-%d\n", MAX_PARTICLE_SCENES);
+        return false;
+    }
+    if (options._backend != "gpu" && options._backend != "cpu")
+    {
+        fprintf(stderr, "--backend must be gpu or cpu\n");
+        return false;
+    }
+    CpuParticleKernels::SimdLevel simdLevel = CpuParticleKernels::SIMD_LEVEL_SCALAR;
+    if (options._simdLevelName != "auto" && !CpuParticleKernels::SimdLevelFromName(options._simdLevelName, simdLevel))
+    {
+        fprintf(stderr, "--simd must be auto, scalar, sse4.1, or avx2\n");
+        return false;
+    }
+    if (options._tune && options._backend != "gpu")
+    {
+        fprintf(stderr, "--tune only tunes the compute shaders (use --backend gpu)\n");
+        return false;
+    }
+    if (options._sortBenchmarkMaxLog2 != 0 && 
+        (options._sortBenchmarkMaxLog2 < MIN_SORT_BENCHMARK_LOG2 || options._sortBenchmarkMaxLog2 > MAX_SORT_BENCHMARK_LOG2))
+    {
+        fprintf(stderr, "--sort-benchmark must be %u-%u\n", MIN_SORT_BENCHMARK_LOG2, MAX_SORT_BENCHMARK_LOG2);
+        return false;
+    }
+    if (options._tune && options._growToParticles > 0)
+    {
+        fprintf(stderr, "--tune and --grow-to don't go together\n");
+        return false;
+    }
+    if (options._tune && options._numCompareFrames > 0)
+    {
+        fprintf(stderr, "--tune and --compare don't go together\n");
+        return false;
+    }
+    if (options._repeatCheck && (options._tune || options._numCompareFrames > 0))
+    {
+        fprintf(stderr, "--repeat-check doesn't go with --tune or --compare\n");
+        return false;
+    }
+    if (options._tune && options._profilePath.empty())
+    {
+        fprintf(stderr, "--tune needs somewhere to save the profile (drop --no-profile)\n");
+        return false;
+    }
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Sets the CPU simulation's SIMD level if the options name one (otherwise it keeps the best
+    one that the CPU has).
+Parameters:
+    options     The --simd option.
+    simulation  Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void ApplySimdLevel(const HeadlessOptions &options, CpuParticleSimulation &simulation)
+{
+    CpuParticleKernels::SimdLevel simdLevel = CpuParticleKernels::SIMD_LEVEL_SCALAR;
+    if (CpuParticleKernels::SimdLevelFromName(options._simdLevelName, simdLevel))
+    {
+        // already checked that it's a level, but the CPU might not have it, in which case it 
+        // says so and keeps the default
+        simulation.SetSimdLevel(simdLevel);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives the simulation the same emitters as main.cpp, once per scene, and the random seed.
+
+    Note: No window, so no window space transform.
+    Also Note: The scenes overlap in space, but they don't interact (see ParticleScenes.comp).
+Parameters:
+    options     The scene count and the random seed.
+    simulation  Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void AddEmitters(const HeadlessOptions &options, IParticleSimulation &simulation)
+{
+    simulation.SetRandomSeed(options._randomSeed);
+    float minVel = 0.1f;
+    float maxVel = 0.5f;
+    ParticleEmitterBar::SHARED_PTR barEmitter1 = std::make_shared<ParticleEmitterBar>(
+        glm::vec2(-0.8f, +0.2f), glm::vec2(-0.8f, -0.2f), glm::vec2(+1.0f, 0.0f), minVel, maxVel);
+    barEmitter1->SetTransform(glm::mat4());
+    ParticleEmitterBar::SHARED_PTR barEmitter2 = std::make_shared<ParticleEmitterBar>(
+        glm::vec2(+0.8f, +0.2f), glm::vec2(+0.8f, -0.2f), glm::vec2(-1.0f, +0.1f), minVel, maxVel);
+    barEmitter2->SetTransform(glm::mat4());
+    for (unsigned int sceneId = 0; sceneId < options._numScenes; sceneId++)
+    {
+        simulation.AddEmitter(barEmitter1, sceneId);
+        simulation.AddEmitter(barEmitter2, sceneId);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Creates the same simulation as main.cpp (same emitters, same buffers), minus rendering, 
+    on the backend that the options ask for, and runs it as fast as it will go.  Every stage 
+    is timed on the GPU with timestamp queries and on the CPU with a stopwatch, and the 
+    results get whichever one says where the work actually happened.
+
+    The simulation cleans up its programs and buffers in its destructor, so everything is 
+    gone again by the time that this returns and it can be called once per variant.
+Parameters:
+    options     The particle count, frame counts, backend, etc.
+    variant     Work group sizes, items per thread, and feature defines for the compute shaders.
+                Ignored by the CPU backend.
+    results     Receives the measurements.
+Returns:
+    False if the simulation couldn't grow to --grow-to (results is then incomplete), 
+    otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool RunSimulation(const HeadlessOptions &options, 
+    const ShaderControllers::ComputeShaderVariant &variant, HeadlessResults &results)
+{
+    Stopwatch startupTimer;
+    startupTimer.Start();
+    IParticleSimulation::UNIQUE_PTR simulation = nullptr;
+
+    // for the worker stats; null for the GPU backend
+    CpuParticleSimulation *cpuSimulation = nullptr;
+    if (options._backend == "cpu")
+    {
+        auto newCpuSimulation = std::make_unique<CpuParticleSimulation>(options._numParticles, options._numCpuThreads);
+        ApplySimdLevel(options, *newCpuSimulation);
+        cpuSimulation = newCpuSimulation.get();
+        simulation = std::move(newCpuSimulation);
+    }
+    else
+    {
+        if (options._submitShadersFirst)
+        {
+            // same as main.cpp; the constructors then only wait for what they need
+            GpuParticleSimulation::SubmitShaders(variant);
+        }
+        simulation = std::make_unique<GpuParticleSimulation>(options._numParticles, variant);
+    }
+
+    AddEmitters(options, *simulation);
+
+    // all the shader programs are made in the controllers' constructors, and the buffers are 
+    // filled on the GPU (see ParticleSsbo::InitializeOnGpu()), so wait for that to count it too
+    simulation->Finish();
+    results._startupTime = startupTimer.TotalTime();
+    if (!options._tune)
+    {
+        // and so are all the buffers
+        simulation->PrintMemoryReport();
+    }
+
+    GpuStopwatch gpuTimer(NUM_STAGES);
+    CpuStageStopwatch cpuStageTimer(NUM_STAGES);
+    FramePacer framePacer;
+    Stopwatch cpuTimer;
+
+    // just hard-code it like main.cpp does
+    float deltaTimeSec = 0.01f;
+
+    unsigned int totalFrames = options._numWarmupFrames + options._numFrames;
+    for (unsigned int frameCount = 0; frameCount < totalFrames; frameCount++)
+    {
+        if (frameCount == options._numWarmupFrames && options._growToParticles > simulation->NumParticles())
+        {
+            // same as main.cpp's GrowParticleCapacity(...)
+            Stopwatch resizeTimer;
+            resizeTimer.Start();
+            unsigned int oldCapacity = simulation->NumParticles();
+            unsigned int newCapacity = ParticleSsbo::GrownCapacity(oldCapacity, options._growToParticles);
+            if (!simulation->Resize(newCapacity))
+            {
+                fprintf(stderr, "couldn't grow the particle buffer from %u to %u\n", oldCapacity, newCapacity);
+                return false;
+            }
+            simulation->Finish();
+            printf("particle capacity: %u -> %u in %.1lf ms\n", oldCapacity, simulation->NumParticles(), 
+                resizeTimer.TotalTime() * 1000.0);
+        }
+
+        if (frameCount == options._numWarmupFrames)
+        {
+            // let the warmup frames finish so that they don't count
+            simulation->Finish();
+            gpuTimer.Finish();
+            gpuTimer.Reset();
+            cpuStageTimer.Reset();
+            if (cpuSimulation != nullptr)
+            {
+                cpuSimulation->ResetWorkerStats();
+            }
+            framePacer.ResetWaitStats();
+            ShaderControllers::MemoryBarrierTracker::GetInstance().ResetStats();
+            cpuTimer.Start();
+        }
+
+        framePacer.BeginFrame();
+        gpuTimer.StartFrame();
+        cpuStageTimer.StartFrame();
+        simulation->ResetParticles(options._particlesPerEmitterPerFrame);
+        gpuTimer.EndStage(STAGE_RESET);
+        cpuStageTimer.EndStage(STAGE_RESET);
+        simulation->Update(deltaTimeSec);
+        gpuTimer.EndStage(STAGE_UPDATE);
+        cpuStageTimer.EndStage(STAGE_UPDATE);
+        simulation->Sort();
+        gpuTimer.EndStage(STAGE_SORT);
+        cpuStageTimer.EndStage(STAGE_SORT);
+        simulation->DetectAndResolveCollisions();
+        gpuTimer.EndStage(STAGE_COLLIDE);
+        cpuStageTimer.EndStage(STAGE_COLLIDE);
+        simulation->CountNearbyParticles();
+        gpuTimer.EndStage(STAGE_COUNT_NEARBY);
+        cpuStageTimer.EndStage(STAGE_COUNT_NEARBY);
+        framePacer.EndFrame();
+    }
+    simulation->Finish();
+    results._wallTime = cpuTimer.TotalTime();
+    gpuTimer.Finish();
+    if (cpuSimulation != nullptr && !options._tune)
+    {
+        cpuSimulation->PrintWorkerReport();
+    }
+
+    // the GPU backend's CPU time is only the time to issue commands, and the CPU backend's 
+    // GPU time is nothing at all
+    results._timedOnCpu = (options._backend == "cpu");
+    for (unsigned int stageIndex = 0; stageIndex < NUM_STAGES; stageIndex++)
+    {
+        if (results._timedOnCpu)
+        {
+            results._averageStageTimes[stageIndex] = cpuStageTimer.AverageStageTime(stageIndex);
+            results._minStageTimes[stageIndex] = cpuStageTimer.MinStageTime(stageIndex);
+            results._maxStageTimes[stageIndex] = cpuStageTimer.MaxStageTime(stageIndex);
+        }
+        else
+        {
+            results._averageStageTimes[stageIndex] = gpuTimer.AverageStageTime(stageIndex);
+            results._minStageTimes[stageIndex] = gpuTimer.MinStageTime(stageIndex);
+            results._maxStageTimes[stageIndex] = gpuTimer.MaxStageTime(stageIndex);
+        }
+    }
+    results._averageFrameTime = results._timedOnCpu ? cpuStageTimer.AverageFrameTime() : gpuTimer.AverageFrameTime();
+    results._averageFrameWaitTime = framePacer.AverageFrameWaitTime();
+    results._barriersPerFrame = (options._numFrames > 0) ? 
+        static_cast<double>(ShaderControllers::MemoryBarrierTracker::GetInstance().NumBarriersIssued()) / options._numFrames : 0.0;
+    results._numActiveParticles = simulation->NumActiveParticles();
+    results._particleCapacity = simulation->NumParticles();
+    if (options._repeatCheck)
+    {
+        simulation->ReadParticles(results._finalParticles);
+    }
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints the summary of one RunSimulation(...).
+Parameters:
+    options     What the run was asked to do.
+    results     What it measured.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void PrintResults(const HeadlessOptions &options, const HeadlessResults &results)
+{
+    printf("\n%u particles, %u scene(s), %u frames (+%u warmup), %s backend\n", results._particleCapacity, 
+        options._numScenes, options._numFrames, options._numWarmupFrames, results._timedOnCpu ? "CPU" : "GPU");
+    printf("%-14s %10s %10s %10s\n", "stage", "avg ms", "min ms", "max ms");
+    for (unsigned int stageIndex = 0; stageIndex < NUM_STAGES; stageIndex++)
+    {
+        printf("%-14s %10.3lf %10.3lf %10.3lf\n", STAGE_NAMES[stageIndex],
+            results._averageStageTimes[stageIndex] * 1000.0,
+            results._minStageTimes[stageIndex] * 1000.0,
+            results._maxStageTimes[stageIndex] * 1000.0);
+    }
+    printf("%-14s %10.3lf\n", results._timedOnCpu ? "CPU total" : "GPU total", results._averageFrameTime * 1000.0);
+    if (options._numFrames > 0)
+    {
+        printf("wall time: %.3lf s (%.2lf frames/s), CPU wait per frame: %.3lf ms\n", results._wallTime,
+            (results._wallTime > 0.0) ? (options._numFrames / results._wallTime) : 0.0,
+            results._averageFrameWaitTime * 1000.0);
+        printf("memory barriers per frame: %.1lf\n", results._barriersPerFrame);
+    }
+    printf("active particles: %u\n", results._numActiveParticles);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Finds the fastest work group size and items per thread for each compute stage, one stage 
+    at a time (the other stages keep their best-so-far settings), by running the whole 
+    simulation with each candidate and reading that stage's GPU timer.  Candidates that the 
+    context can't run are skipped.
+
+    The sort's programs share one GPU timer (see TIMER_STAGE_FOR_COMPUTE_STAGE), so each of 
+    them is judged by the whole sort's time.  The prefix scan always does 2 items per thread, 
+    so only its work group size is swept.
+Parameters:
+    options     The particle count, frame counts, etc. for every run.
+    variant     The starting point.  Receives the fastest settings.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void TuneVariant(const HeadlessOptions &options, ShaderControllers::ComputeShaderVariant &variant)
+{
+    using namespace ShaderControllers;
+
+    unsigned int numSizes = sizeof(TUNE_WORK_GROUP_SIZES) / sizeof(TUNE_WORK_GROUP_SIZES[0]);
+    unsigned int numItemCounts = sizeof(TUNE_ITEMS_PER_THREAD) / sizeof(TUNE_ITEMS_PER_THREAD[0]);
+    for (unsigned int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+    {
+        ComputeStage stage = static_cast<ComputeStage>(stageIndex);
+        HeadlessStage timerStage = TIMER_STAGE_FOR_COMPUTE_STAGE[stageIndex];
+        printf("\ntuning '%s' (timed by '%s')\n", ComputeStageName(stage), STAGE_NAMES[timerStage]);
+
+        unsigned int bestSize = variant.WorkGroupSizeX(stage);
+        unsigned int bestItemsPerThread = variant.ItemsPerThread(stage);
+        double bestTime = -1.0;
+        for (unsigned int sizeIndex = 0; sizeIndex < numSizes; sizeIndex++)
+        {
+            for (unsigned int itemsIndex = 0; itemsIndex < numItemCounts; itemsIndex++)
+            {
+                unsigned int itemsPerThread = TUNE_ITEMS_PER_THREAD[itemsIndex];
+                if (stage == COMPUTE_STAGE_SORT_PREFIX_SCAN)
+                {
+                    if (itemsIndex > 0)
+                    {
+                        break;
+                    }
+                    itemsPerThread = 2;
+                }
+
+                ComputeShaderVariant candidate = variant;
+                candidate.SetStage(stage, TUNE_WORK_GROUP_SIZES[sizeIndex], itemsPerThread);
+                if (!candidate.IsSupported(options._numParticles))
+                {
+                    printf("    %4u x %u: skipped\n", TUNE_WORK_GROUP_SIZES[sizeIndex], itemsPerThread);
+                    continue;
+                }
+
+                HeadlessResults results;
+                if (!RunSimulation(options, candidate, results))
+                {
+                    printf("    %4u x %u: failed\n", TUNE_WORK_GROUP_SIZES[sizeIndex], itemsPerThread);
+                    continue;
+                }
+                double stageTime = results._averageStageTimes[timerStage];
+                printf("    %4u x %u: %10.3lf ms\n", TUNE_WORK_GROUP_SIZES[sizeIndex], itemsPerThread, 
+                    stageTime * 1000.0);
+                if (bestTime < 0.0 || stageTime < bestTime)
+                {
+                    bestTime = stageTime;
+                    bestSize = TUNE_WORK_GROUP_SIZES[sizeIndex];
+                    bestItemsPerThread = itemsPerThread;
+                }
+            }
+        }
+
+        variant.SetStage(stage, bestSize, bestItemsPerThread);
+        printf("    best: %u x %u\n", bestSize, bestItemsPerThread);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Times CpuRadixSort against std::sort and std::stable_sort on the same random key/index 
+    pairs (see CpuRadixSort) for every power of 2 from 2^MIN_SORT_BENCHMARK_LOG2 keys up to 
+    the option's, and checks that all three got the same answer.  Each time is the best of 
+    BENCHMARK_REPETITIONS and leaves out the copy of the unsorted pairs.
+
+    std::sort on the packed pairs compares the indices too, so it ends up in the same order 
+    as a stable sort on the keys.  std::stable_sort only compares the keys, like the radix 
+    sort.
+
+    No OpenGL, so this runs before there is a context.
+Parameters:
+    options     The biggest size, the thread count, and the random seed.
+Returns:
+    False if a sort got a different answer than std::sort, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool RunSortBenchmark(const HeadlessOptions &options)
+{
+    ThreadPool threadPool(options._numCpuThreads);
+    CpuRadixSort radixSort(threadPool);
+    printf("sorting 32-bit key + 32-bit index pairs, radix sort on %u thread(s)\n", threadPool.NumThreads());
+    printf("%4s %10s %14s %14s %14s %12s %10s\n", "log2", "keys", "std::sort ms", "stable ms", "radix ms", 
+        "radix Mkey/s", "vs sort");
+
+    std::mt19937 randomGenerator(options._randomSeed);
+    std::vector<unsigned long long> unsortedItems;
+    std::vector<unsigned long long> expectedItems;
+    std::vector<unsigned long long> items;
+    auto keyLessThan = [](unsigned long long a, unsigned long long b) { return (a >> 32) < (b >> 32); };
+    for (unsigned int log2 = MIN_SORT_BENCHMARK_LOG2; log2 <= options._sortBenchmarkMaxLog2; log2++)
+    {
+        unsigned int numItems = 1u << log2;
+        unsortedItems.resize(numItems);
+        for (unsigned int index = 0; index < numItems; index++)
+        {
+            unsigned long long key = randomGenerator();
+            unsortedItems[index] = (key << 32) | index;
+        }
+
+        double bestTimes[3] = { -1.0, -1.0, -1.0 };
+        for (unsigned int repetition = 0; repetition < BENCHMARK_REPETITIONS; repetition++)
+        {
+            for (unsigned int sortIndex = 0; sortIndex < 3; sortIndex++)
+            {
+                items = unsortedItems;
+                Stopwatch sortTimer;
+                sortTimer.Start();
+                if (sortIndex == 0)
+                {
+                    std::sort(items.begin(), items.end());
+                }
+                else if (sortIndex == 1)
+                {
+                    std::stable_sort(items.begin(), items.end(), keyLessThan);
+                }
+                else
+                {
+                    radixSort.Sort(items);
+                }
+                double sortTime = sortTimer.TotalTime();
+                if (bestTimes[sortIndex] < 0.0 || sortTime < bestTimes[sortIndex])
+                {
+                    bestTimes[sortIndex] = sortTime;
+                }
+
+                if (sortIndex == 0)
+                {
+                    expectedItems.swap(items);
+                }
+                else if (items != expectedItems)
+                {
+                    fprintf(stderr, "%s got a different order than std::sort for %u keys\n", 
+                        (sortIndex == 1) ? "std::stable_sort" : "CpuRadixSort", numItems);
+                    return false;
+                }
+            }
+        }
+
+        printf("%4u %10u %14.3lf %14.3lf %14.3lf %12.1lf %9.2lfx\n", log2, numItems, bestTimes[0] * 1000.0, 
+            bestTimes[1] * 1000.0, bestTimes[2] * 1000.0, (numItems / bestTimes[2]) / 1000000.0, 
+            bestTimes[0] / bestTimes[2]);
+    }
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The particle arrays for RunKernelBenchmark(...), in the same layout as 
+    CpuParticleSimulation's.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct KernelBenchmarkParticles
+{
+    CpuParticleKernels::ParticleFields Fields()
+    {
+        CpuParticleKernels::ParticleFields fields;
+        fields._positionX = _positionX.data();
+        fields._positionY = _positionY.data();
+        fields._positionZ = _positionZ.data();
+        fields._velocityX = _velocityX.data();
+        fields._velocityY = _velocityY.data();
+        fields._velocityZ = _velocityZ.data();
+        fields._numberOfNearbyParticles = _numberOfNearbyParticles.data();
+        fields._mortonCode = _mortonCode.data();
+        fields._hasCollidedAlreadyThisFrame = _hasCollidedAlreadyThisFrame.data();
+        fields._isActive = _isActive.data();
+        fields._sceneId = _sceneId.data();
+        return fields;
+    }
+
+    bool operator==(const KernelBenchmarkParticles &other) const
+    {
+        return _positionX == other._positionX && _positionY == other._positionY && 
+            _positionZ == other._positionZ && _numberOfNearbyParticles == other._numberOfNearbyParticles && 
+            _mortonCode == other._mortonCode && _hasCollidedAlreadyThisFrame == other._hasCollidedAlreadyThisFrame && 
+            _isActive == other._isActive;
+    }
+
+    std::vector<float> _positionX;
+    std::vector<float> _positionY;
+    std::vector<float> _positionZ;
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _velocityZ;
+    std::vector<unsigned int> _numberOfNearbyParticles;
+    std::vector<unsigned int> _mortonCode;
+    std::vector<unsigned char> _hasCollidedAlreadyThisFrame;
+    std::vector<unsigned char> _isActive;
+    std::vector<unsigned char> _sceneId;
+};
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Times every SIMD level that this CPU has of CpuParticleKernels::UpdateParticles(...) and 
+    MakeSortItems(...) on one thread, so the rates are per core, and checks that every level 
+    gives the scalar version's results bit for bit.  Each time is the best of 
+    BENCHMARK_REPETITIONS and leaves out the copy of the starting particles.
+
+    The particles are random: spread over a box a bit bigger than the particle region (so 
+    some of them leave it), most of them active, in any scene.
+
+    No OpenGL, so this runs before there is a context.
+Parameters:
+    options     The particle count and the random seed.
+Returns:
+    False if a level gave different results than the scalar version, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool RunKernelBenchmark(const HeadlessOptions &options)
+{
+    unsigned int numParticles = options._numParticles;
+    std::mt19937 randomGenerator(options._randomSeed);
+    std::uniform_real_distribution<float> positionDistribution(-1.1f * PARTICLE_REGION_RADIUS, +1.1f * PARTICLE_REGION_RADIUS);
+    std::uniform_real_distribution<float> velocityDistribution(-0.5f, +0.5f);
+    std::uniform_int_distribution<unsigned int> percentDistribution(0, 99);
+    std::uniform_int_distribution<unsigned int> sceneDistribution(0, MAX_PARTICLE_SCENES - 1);
+
+    KernelBenchmarkParticles startingParticles;
+    for (unsigned int index = 0; index < numParticles; index++)
+    {
+        startingParticles._positionX.push_back(positionDistribution(randomGenerator));
+        startingParticles._positionY.push_back(positionDistribution(randomGenerator));
+        startingParticles._positionZ.push_back(0.0f);
+        startingParticles._velocityX.push_back(velocityDistribution(randomGenerator));
+        startingParticles._velocityY.push_back(velocityDistribution(randomGenerator));
+        startingParticles._velocityZ.push_back(0.0f);
+        startingParticles._numberOfNearbyParticles.push_back(percentDistribution(randomGenerator));
+        startingParticles._mortonCode.push_back(0);
+        startingParticles._hasCollidedAlreadyThisFrame.push_back(percentDistribution(randomGenerator) < 50 ? 1 : 0);
+        startingParticles._isActive.push_back(percentDistribution(randomGenerator) < 90 ? 1 : 0);
+        startingParticles._sceneId.push_back(static_cast<unsigned char>(sceneDistribution(randomGenerator)));
+    }
+
+    printf("CPU kernels, %u particles, 1 thread\n", numParticles);
+    printf("%-8s %-8s %10s %14s %10s\n", "kernel", "simd", "ms", "Mparticle/s", "matches");
+
+    // what the scalar versions give; the others must match
+    KernelBenchmarkParticles expectedUpdateParticles;
+    std::vector<unsigned int> expectedFreedIndices;
+    unsigned int expectedUpdateNumActive = 0;
+    KernelBenchmarkParticles expectedSortParticles;
+    std::vector<unsigned long long> expectedSortItems;
+    unsigned int expectedSortNumActive = 0;
+
+    bool allMatch = true;
+    KernelBenchmarkParticles particles;
+    std::vector<unsigned int> freedIndices;
+    std::vector<unsigned long long> sortItems(numParticles);
+    float deltaTimeSec = 0.01f;
+    for (int levelIndex = 0; levelIndex < CpuParticleKernels::NUM_SIMD_LEVELS; levelIndex++)
+    {
+        CpuParticleKernels::SimdLevel level = static_cast<CpuParticleKernels::SimdLevel>(levelIndex);
+        if (!CpuParticleKernels::IsSimdLevelSupported(level))
+        {
+            printf("%-8s %-8s %10s\n", "both", CpuParticleKernels::SimdLevelName(level), "unsupported");
+            continue;
+        }
+
+        // update
+        double bestTime = -1.0;
+        unsigned int numActive = 0;
+        for (unsigned int repetition = 0; repetition < BENCHMARK_REPETITIONS; repetition++)
+        {
+            particles = startingParticles;
+            freedIndices.clear();
+            Stopwatch kernelTimer;
+            kernelTimer.Start();
+            numActive = CpuParticleKernels::UpdateParticles(level, particles.Fields(), 0, numParticles, 
+                deltaTimeSec, freedIndices);
+            double kernelTime = kernelTimer.TotalTime();
+            if (bestTime < 0.0 || kernelTime < bestTime)
+            {
+                bestTime = kernelTime;
+            }
+        }
+        if (level == CpuParticleKernels::SIMD_LEVEL_SCALAR)
+        {
+            expectedUpdateParticles = particles;
+            expectedFreedIndices = freedIndices;
+            expectedUpdateNumActive = numActive;
+        }
+        bool matches = (particles == expectedUpdateParticles) && (freedIndices == expectedFreedIndices) && 
+            (numActive == expectedUpdateNumActive);
+        allMatch = allMatch && matches;
+        printf("%-8s %-8s %10.3lf %14.1lf %10s\n", "update", CpuParticleKernels::SimdLevelName(level), 
+            bestTime * 1000.0, (numParticles / bestTime) / 1000000.0, matches ? "yes" : "NO");
+
+        // sort keys
+        bestTime = -1.0;
+        for (unsigned int repetition = 0; repetition < BENCHMARK_REPETITIONS; repetition++)
+        {
+            particles = startingParticles;
+            Stopwatch kernelTimer;
+            kernelTimer.Start();
+            numActive = CpuParticleKernels::MakeSortItems(level, particles.Fields(), 0, numParticles, sortItems.data());
+            double kernelTime = kernelTimer.TotalTime();
+            if (bestTime < 0.0 || kernelTime < bestTime)
+            {
+                bestTime = kernelTime;
+            }
+        }
+        if (level == CpuParticleKernels::SIMD_LEVEL_SCALAR)
+        {
+            expectedSortParticles = particles;
+            expectedSortItems = sortItems;
+            expectedSortNumActive = numActive;
+        }
+        matches = (particles == expectedSortParticles) && (sortItems == expectedSortItems) && 
+            (numActive == expectedSortNumActive);
+        allMatch = allMatch && matches;
+        printf("%-8s %-8s %10.3lf %14.1lf %10s\n", "sortkeys", CpuParticleKernels::SimdLevelName(level), 
+            bestTime * 1000.0, (numParticles / bestTime) / 1000000.0, matches ? "yes" : "NO");
+    }
+
+    return allMatch;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Runs the GPU and CPU backends side by side for the option's number of compare frames and
+    checks every GPU stage against the CPU (see BackendComparison).
+
+    Before each stage, the CPU is given the GPU's particles (see
+    CpuParticleSimulation::LoadParticles(...)), so each stage starts from the same place on
+    both and a difference in one stage doesn't show up again in every stage after it.  The
+    sort is checked against CpuRadixSort instead of the CPU's own sort, so the CPU doesn't
+    sort at all.
+
+    Slow (everything is read back after every stage), and not timed.
+Parameters:
+    options     The particle count, frame count, etc.
+    variant     For the GPU backend's compute shaders.
+Returns:
+    True if every check passed, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool RunComparison(const HeadlessOptions &options, const ShaderControllers::ComputeShaderVariant &variant)
+{
+    if (options._submitShadersFirst)
+    {
+        GpuParticleSimulation::SubmitShaders(variant);
+    }
+    GpuParticleSimulation gpuSimulation(options._numParticles, variant);
+    CpuParticleSimulation cpuSimulation(options._numParticles, options._numCpuThreads);
+    ApplySimdLevel(options, cpuSimulation);
+    AddEmitters(options, gpuSimulation);
+    AddEmitters(options, cpuSimulation);
+    gpuSimulation.Finish();
+
+    printf("\ncomparing GPU and CPU backends: %u particles, %u scene(s), %u frames\n", options._numParticles, 
+        options._numScenes, options._numCompareFrames);
+    BackendComparison comparison;
+    std::vector<Particle> before;
+    std::vector<Particle> gpuAfter;
+    std::vector<Particle> cpuAfter;
+
+    // same as RunSimulation(...)
+    float deltaTimeSec = 0.01f;
+    for (unsigned int frameCount = 0; frameCount < options._numCompareFrames; frameCount++)
+    {
+        gpuSimulation.ReadParticles(before);
+        cpuSimulation.LoadParticles(before);
+        gpuSimulation.ResetParticles(options._particlesPerEmitterPerFrame);
+        cpuSimulation.ResetParticles(options._particlesPerEmitterPerFrame);
+        gpuSimulation.ReadParticles(gpuAfter);
+        cpuSimulation.ReadParticles(cpuAfter);
+        comparison.CompareReset(before, gpuAfter, cpuAfter);
+
+        cpuSimulation.LoadParticles(gpuAfter);
+        gpuSimulation.Update(deltaTimeSec);
+        cpuSimulation.Update(deltaTimeSec);
+        gpuSimulation.ReadParticles(gpuAfter);
+        cpuSimulation.ReadParticles(cpuAfter);
+        comparison.CompareUpdate(gpuAfter, cpuAfter);
+
+        before.swap(gpuAfter);
+        gpuSimulation.Sort();
+        gpuSimulation.ReadParticles(gpuAfter);
+        comparison.CompareSort(before, gpuAfter);
+
+        cpuSimulation.LoadParticles(gpuAfter);
+        gpuSimulation.DetectAndResolveCollisions();
+        cpuSimulation.DetectAndResolveCollisions();
+        gpuSimulation.ReadParticles(gpuAfter);
+        cpuSimulation.ReadParticles(cpuAfter);
+        comparison.CompareCollisions(gpuAfter, cpuAfter);
+
+        cpuSimulation.LoadParticles(gpuAfter);
+        gpuSimulation.CountNearbyParticles();
+        cpuSimulation.CountNearbyParticles();
+        gpuSimulation.ReadParticles(gpuAfter);
+        cpuSimulation.ReadParticles(cpuAfter);
+        comparison.CompareNearbyCounts(gpuAfter, cpuAfter);
+    }
+
+    comparison.PrintReport();
+    return comparison.Passed();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Runs the simulation twice with the same options (and so the same seed) and checks that the 
+    particle buffers come out byte for byte the same.  Nothing about the simulation is 
+    supposed to depend on timing or on the order in which threads happen to run (see 
+    ParticleFreeListBuffer.comp), so any difference at all is a bug.
+Parameters:
+    options     The particle count, frame counts, backend, seed, etc.
+    variant     For the GPU backend's compute shaders.
+Returns:
+    True if both runs finished and ended with the same particles, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool RunRepeatCheck(const HeadlessOptions &options, const ShaderControllers::ComputeShaderVariant &variant)
+{
+    HeadlessResults firstResults;
+    if (!RunSimulation(options, variant, firstResults))
+    {
+        return false;
+    }
+    PrintResults(options, firstResults);
+    HeadlessResults secondResults;
+    if (!RunSimulation(options, variant, secondResults))
+    {
+        return false;
+    }
+    PrintResults(options, secondResults);
+
+    const std::vector<Particle> &first = firstResults._finalParticles;
+    const std::vector<Particle> &second = secondResults._finalParticles;
+    size_t numDifferent = 0;
+    size_t firstDifferent = 0;
+    if (first.size() == second.size())
+    {
+        for (size_t index = 0; index < first.size(); index++)
+        {
+            if (memcmp(&first[index], &second[index], sizeof(Particle)) != 0)
+            {
+                if (numDifferent == 0)
+                {
+                    firstDifferent = index;
+                }
+                numDifferent++;
+            }
+        }
+    }
+
+    printf("\nrun-to-run check, seed 0x%x: ", options._randomSeed);
+    if (first.size() != second.size())
+    {
+        printf("FAILED (%u vs %u particles)\n", static_cast<unsigned int>(first.size()), 
+            static_cast<unsigned int>(second.size()));
+        return false;
+    }
+    if (numDifferent > 0)
+    {
+        printf("FAILED (%u of %u particles differ, first at %u)\n", static_cast<unsigned int>(numDifferent), 
+            static_cast<unsigned int>(first.size()), static_cast<unsigned int>(firstDifferent));
+        return false;
+    }
+    printf("passed (%u particles identical)\n", static_cast<unsigned int>(first.size()));
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints two RunSimulation(...)s' stage times next to each other, with how many times 
+    longer the CPU took than the GPU.
+Parameters:
+    gpuResults  From the GPU backend.
+    cpuResults  From the CPU backend, with the same options otherwise.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static void PrintSideBySide(const HeadlessResults &gpuResults, const HeadlessResults &cpuResults)
+{
+    printf("\n%-14s %10s %10s %10s\n", "stage", "GPU ms", "CPU ms", "CPU/GPU");
+    for (unsigned int stageIndex = 0; stageIndex < NUM_STAGES; stageIndex++)
+    {
+        double gpuTime = gpuResults._averageStageTimes[stageIndex];
+        double cpuTime = cpuResults._averageStageTimes[stageIndex];
+        printf("%-14s %10.3lf %10.3lf %9.2lfx\n", STAGE_NAMES[stageIndex], gpuTime * 1000.0, cpuTime * 1000.0, 
+            (gpuTime > 0.0) ? (cpuTime / gpuTime) : 0.0);
+    }
+    printf("%-14s %10.3lf %10.3lf %9.2lfx\n", "total", gpuResults._averageFrameTime * 1000.0, 
+        cpuResults._averageFrameTime * 1000.0, 
+        (gpuResults._averageFrameTime > 0.0) ? (cpuResults._averageFrameTime / gpuResults._averageFrameTime) : 0.0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Program start and end.
+
+    Runs the simulation once and prints a summary, or with --tune, runs it once per candidate 
+    work group size and saves the fastest settings to the profile, or with --sort-benchmark or 
+    --kernel-benchmark, only times that part of the CPU backend, or with --compare, checks the 
+    GPU backend against the CPU backend and then runs and times both, or with --repeat-check, 
+    runs it twice and checks that both runs came out the same.
+Parameters:
+    argc    The number of strings in argv.
+    argv    A pointer to an array of null-terminated, C-style strings.
+Returns:
+    0 if all went well, 1 if the command line was bad, 2 if there was no usable OpenGL, 3 if 
+    the profile couldn't be saved, 4 if the sort or kernel benchmark got a wrong answer, 5 if 
+    the GPU and CPU backends didn't match, 6 if two runs with the same seed didn't match (or 
+    didn't finish), 7 if the particle buffer couldn't grow to --grow-to.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    HeadlessOptions options;
+    if (!ParseCommandLine(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (options._sortBenchmarkMaxLog2 != 0)
+    {
+        return RunSortBenchmark(options) ? 0 : 4;
+    }
+    if (options._kernelBenchmark)
+    {
+        return RunKernelBenchmark(options) ? 0 : 4;
+    }
+
+    // Note: Compute shaders require at least OpenGL 4.3, but main.cpp asks for 4.5, so do the 
+    // same here so that the two run the same code.
+    int requiredMajorVersion = 4;
+    int requiredMinorVersion = 5;
+    HeadlessGlContext context;
+    if (!context.Init(requiredMajorVersion, requiredMinorVersion, options._debugContext))
+    {
+        return 2;
+    }
+
+    glload::LoadTest glLoadGood = glload::LoadFunctions();
+    if (!glLoadGood || !glload::IsVersionGEQ(requiredMajorVersion, requiredMinorVersion))
+    {
+        fprintf(stderr, "Your OpenGL version is %i, %i. You must have at least OpenGL %d.%d to run this.\n",
+            glload::GetMajorVersion(), glload::GetMinorVersion(), requiredMajorVersion, requiredMinorVersion);
+        return 2;
+    }
+    printf("renderer: %s\n", (const char *)glGetString(GL_RENDERER));
+    printf("version: %s\n", (const char *)glGetString(GL_VERSION));
+
+    if (options._debugContext && glext_ARB_debug_output)
+    {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_ARB);
+        glDebugMessageCallback(DebugFunc, (void*)15);
+    }
+
+    // the profile and the work group sizes can only be checked against the context (renderer 
+    // name, limits) now that there is one
+    ShaderControllers::ComputeShaderVariant variant;
+    if (!options._profilePath.empty() && variant.LoadProfile(options._profilePath))
+    {
+        printf("compute profile: %s\n", options._profilePath.c_str());
+    }
+    for (unsigned int stageIndex = 0; stageIndex < ShaderControllers::NUM_COMPUTE_STAGES; stageIndex++)
+    {
+        ShaderControllers::ComputeStage stage = static_cast<ShaderControllers::ComputeStage>(stageIndex);
+        unsigned int overrideSize = ShaderControllers::IsParallelSortStage(stage) ? 
+            options._sortWorkGroupSize : options._particleWorkGroupSize;
+        if (overrideSize > 0)
+        {
+            variant.SetStage(stage, overrideSize, variant.ItemsPerThread(stage));
+        }
+    }
+    for (size_t defineIndex = 0; defineIndex < options._featureDefines.size(); defineIndex++)
+    {
+        const std::string &define = options._featureDefines[defineIndex];
+        size_t equalsPos = define.find('=');
+        if (equalsPos == std::string::npos)
+        {
+            variant.AddFeatureDefine(define);
+        }
+        else
+        {
+            variant.AddFeatureDefine(define.substr(0, equalsPos), define.substr(equalsPos + 1));
+        }
+    }
+    unsigned int maxParticles = ParticleSsbo::GrownCapacity(options._numParticles, options._growToParticles);
+    if ((options._backend == "gpu" || options._numCompareFrames > 0) && !variant.IsSupported(maxParticles))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    printf("compute shader variant: %s\n", variant.Name().c_str());
+
+    // same cache as main.cpp
+    if (options._useShaderCache)
+    {
+        ShaderStorage::GetInstance().UseProgramBinaryCache("ShaderCache");
+    }
+    printf("parallel shader compile extension: %s\n", 
+        ShaderStorage::GetInstance().HasParallelShaderCompile() ? "yes" : "no");
+
+    int exitCode = 0;
+    if (options._tune)
+    {
+        TuneVariant(options, variant);
+        printf("\nfastest compute shader variant: %s\n", variant.Name().c_str());
+        if (variant.SaveProfile(options._profilePath))
+        {
+            printf("saved to '%s'\n", options._profilePath.c_str());
+        }
+        else
+        {
+            exitCode = 3;
+        }
+    }
+    else if (options._numCompareFrames > 0)
+    {
+        if (!RunComparison(options, variant))
+        {
+            exitCode = 5;
+        }
+
+        HeadlessOptions gpuOptions = options;
+        gpuOptions._backend = "gpu";
+        HeadlessResults gpuResults;
+        if (!RunSimulation(gpuOptions, variant, gpuResults))
+        {
+            context.Cleanup();
+            return 7;
+        }
+        PrintResults(gpuOptions, gpuResults);
+
+        HeadlessOptions cpuOptions = options;
+        cpuOptions._backend = "cpu";
+        HeadlessResults cpuResults;
+        if (!RunSimulation(cpuOptions, variant, cpuResults))
+        {
+            context.Cleanup();
+            return 7;
+        }
+        PrintResults(cpuOptions, cpuResults);
+
+        PrintSideBySide(gpuResults, cpuResults);
+    }
+    else if (options._repeatCheck)
+    {
+        if (!RunRepeatCheck(options, variant))
+        {
+            exitCode = 6;
+        }
+    }
+    else
+    {
+        HeadlessResults results;
+        if (!RunSimulation(options, variant, results))
+        {
+            context.Cleanup();
+            return 7;
+        }
+        printf("startup: %.1lf ms (shader programs: %u from cache, %u compiled%s%s; %u shader files read)\n", 
+            results._startupTime * 1000.0, ShaderStorage::GetInstance().NumProgramCacheHits(), 
+            ShaderStorage::GetInstance().NumProgramCacheMisses(), 
+            options._useShaderCache ? "" : ", cache off", 
+            options._submitShadersFirst ? "" : ", serial", 
+            ShaderStorage::GetInstance().NumShaderFileReads());
+        PrintResults(options, results);
+    }
+
+    context.Cleanup();
+    return exitCode;
+}
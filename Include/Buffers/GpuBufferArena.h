@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    One piece of a GpuBufferArena block.  Bind it with glBindBufferRange(...) using all three
+    values, and add _offsetBytes to any offset that would have been 0 for a buffer of its own
+    (glBufferSubData(...), glCopyBufferSubData(...), vertex attribute pointers, etc.).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct GpuBufferRange
+{
+    GpuBufferRange() :
+        _bufferId(0),
+        _offsetBytes(0),
+        _sizeBytes(0)
+    {
+    }
+
+    unsigned int _bufferId;
+    unsigned int _offsetBytes;
+    unsigned int _sizeBytes;
+};
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Hands out aligned ranges of a few large buffers instead of every SSBO making its own.  Each
+    block is made once with glBufferStorage(...), so its size can't change and the driver
+    knows up front that it will never be re-specified or mapped, and every SSBO in the program
+    (usually) lives in the first one.  That is fewer driver objects, the GPU memory is claimed
+    once at startup instead of a little at a time, and PrintMemoryReport() shows the whole
+    footprint in one place.
+
+    The blocks are DEFAULT_BLOCK_SIZE_BYTES unless an allocation needs more, in which case it
+    gets a block of its own.  Each allocation is placed in the first gap that is big enough
+    (with every offset a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT).  A block is
+    deleted when its last range is freed, so an arena that is empty has no GL objects, and it
+    doesn't matter that the singleton outlives the context.
+
+    The storage has GL_DYNAMIC_STORAGE_BIT so that glBufferSubData(...) still works, but
+    nothing else: no mapping.  Read back with glGetBufferSubData(...).
+
+    Note: The atomic counters are not in here.  PersistentAtomicCounterBuffer needs a
+    persistently mapped buffer of its own.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class GpuBufferArena
+{
+public:
+    static GpuBufferArena &GetInstance();
+    ~GpuBufferArena() = default;
+
+    // comfortably more than all the SSBOs for 100,000 particles
+    static const unsigned int DEFAULT_BLOCK_SIZE_BYTES = 32 * 1024 * 1024;
+
+    GpuBufferRange Allocate(const std::string &name, unsigned int numBytes, const void *initialData);
+    void Free(const GpuBufferRange &range);
+    unsigned int AlignmentBytes();
+
+    unsigned int NumBlocks() const;
+    unsigned int NumBytesReserved() const;
+    unsigned int NumBytesAllocated() const;
+    void PrintMemoryReport() const;
+
+private:
+    GpuBufferArena();
+    GpuBufferArena(const GpuBufferArena &) = delete;
+    GpuBufferArena &operator=(const GpuBufferArena &) = delete;
+
+    struct Allocation
+    {
+        std::string _name;
+        unsigned int _offsetBytes;
+        unsigned int _sizeBytes;
+    };
+
+    struct Block
+    {
+        unsigned int _bufferId;
+        unsigned int _sizeBytes;
+
+        // sorted by offset
+        std::vector<Allocation> _allocations;
+    };
+
+    unsigned int AlignUp(unsigned int numBytes) const;
+    bool TryPlaceInBlock(const Block &block, unsigned int numBytes, unsigned int &offsetBytes) const;
+
+    // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, queried when first needed
+    unsigned int _alignmentBytes;
+    std::vector<Block> _blocks;
+};
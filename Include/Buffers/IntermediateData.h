@@ -20,7 +20,7 @@ struct IntermediateData
     Returns:    None
     Creator:    John Cox, 3/2017
     --------------------------------------------------------------------------------------------*/
-    IntermediateData::IntermediateData() :
+    IntermediateData() :
         _data(0),
         _globalIndexOfOriginalData(0)
     {
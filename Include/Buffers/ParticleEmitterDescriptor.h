@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ThirdParty/glm/vec4.hpp"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Used by ParticleReset to tell the reset shader about every emitter at once.  Point and bar 
+    emitters are both squashed into this one structure and told apart with _emitterType 
+    (see ParticleEmitterTypes.comp) because the compute shader has no concept of inheritance.
+
+    Make sure that it matches the structure ParticleEmitter in ParticleEmitterBuffer.comp.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct ParticleEmitterDescriptor
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Initializes members to 0, padding included, since the whole structure is uploaded.  
+        The glm structures have their own zero initialization.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    ParticleEmitterDescriptor() :
+        _minVelocity(0.0f),
+        _maxVelocity(0.0f),
+        _emitterType(0),
+        _maxParticleEmitCount(0),
+        _sceneId(0),
+        _firstEmissionIndex(0),
+        _padding()
+    {
+    }
+
+    // point emitter: center
+    // bar emitter: start, end, and emit direction
+    glm::vec4 _p1;
+    glm::vec4 _p2;
+    glm::vec4 _emitDir;
+    float _minVelocity;
+    float _maxVelocity;
+    unsigned int _emitterType;
+    unsigned int _maxParticleEmitCount;
+
+    // particles that this emitter spawns belong to this scene (see ParticleScenes.comp)
+    unsigned int _sceneId;
+
+    // the sum of the _maxParticleEmitCount of the emitters before this one, which is how far 
+    // down the free list this emitter's particles start (see ParticleReset.comp)
+    unsigned int _firstEmissionIndex;
+
+    // 3 vec4s + 6 4-byte items, so pad out to the next 16 bytes to match the GPU's version
+    // Note: There used to be a per-emitter count of the particles spawned this frame, which 
+    // the reset shader incremented atomically for every emission, but nothing ever read it.
+    int _padding[2];
+};
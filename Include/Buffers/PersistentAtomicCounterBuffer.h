@@ -1,59 +1,85 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    At this time (4-28-2017) there are a couple compute shaders ("reset particles" and 
-    "update particles") that use an atomic counter.  Up until now I have been using an atomic 
-    counter for each shader, binding the buffer prior to use and using glBufferSubData(...) to 
-    reset the counter to 0, and maybe using glMapBufferSubRange(...) later to get the value of 
+    At this time (4-28-2017) there are a couple compute shaders ("reset particles" and
+    "update particles") that use an atomic counter.  Up until now I have been using an atomic
+    counter for each shader, binding the buffer prior to use and using glBufferSubData(...) to
+    reset the counter to 0, and maybe using glMapBufferSubRange(...) later to get the value of
     the counter.
 
-    Now I want to using a persistently mapped buffer.  The GL_ATOMIC_COUNTER_BUFFER is not a 
-    common buffer target, and it is only used in compute shaders, and I want to write to it and 
-    read from frequently (albeit only 1 uint on each write or read), so I will try to make a 
-    single atomic counter buffer that any compute shader can use.
+    Now I want to using a persistently mapped buffer.  The GL_ATOMIC_COUNTER_BUFFER is not a
+    common buffer target, and it is only used in compute shaders, and I want to write to it and
+    read from frequently (albeit only 1 uint on each write or read).
 
-    I am taking my glBufferStorage(...) information from the Steam Dev Days 2014 talk, 
-    "Beyond Porting: How Modern OpenGL Can Radically Reduce Driver Overhead".  
+    I am taking my glBufferStorage(...) information from the Steam Dev Days 2014 talk,
+    "Beyond Porting: How Modern OpenGL Can Radically Reduce Driver Overhead".
     https://www.youtube.com/watch?v=-bCeNzgiJ8I&index=21&list=PLckFgM6dUP2hc4iy-IdKFtqR9TeZWMPjm
     Start @8:30
-    
+
     It can also be found under GDC 2014 "Approach Zero Driver Overhead".
     https://www.youtube.com/watch?v=K70QbvzB6II
     Start @11:08
 
-    Note: I had to tinker with everything else that wasn't glBufferStorage(...) until I got it 
+    Note: I had to tinker with everything else that wasn't glBufferStorage(...) until I got it
     to work.
 
-    Also Note: This is a singleton structure because I want to use the same atomic counter 
-    buffer binding pint in each of my compute shaders, so by design it is meant to be used by 
-    multiple compute shader controller objects.  I could make multiple persistently bound atomic 
-    counter buffers (I think; I haven't tried that yet), but then I'd have to use multiple 
-    atomic counter buffer binding points.  I want to use one because I want to see if I can :).
+    Also Note: This used to be a singleton with a single counter, and both ResetCounter() and
+    GetCounterValue() would fence and then spin on glClientWaitSync(...) until the GPU caught
+    up.  That stalled the CPU every frame just to print the "active: %d" text.  Now the buffer
+    is a ring of counters (one uint each), and each use of the counter gets its own slot.  The
+    slot is bound to ATOMIC_COUNTER_BUFFER_BINDING with glBindBufferRange(...) so that the
+    shaders don't need to know about it, and it is zeroed on the GPU's timeline with
+    glClearBufferSubData(...), so resetting it never needs to wait.  Each slot gets a fence
+    after the commands that use it, and GetCounterValue() only polls those fences (timeout 0),
+    so it returns the most recent value that the GPU has finished with, which is typically a
+    frame or two old.  That's fine for a frame rate display.
 
-    Also Also Note: I don't need to bother with multithread design because the OpenGL context 
-    only runs one thread anyway.
-Creator:    John Cox, 4/2017
+    Also Also Note: Since every controller that uses an atomic counter now binds its own ring
+    slot prior to dispatching, the "one binding point for everybody" reason for the singleton
+    went away, and so did the static destruction problem (see the destructor).  Each controller
+    that needs a counter now makes its own.
+
+    Also Also Also Note: I don't need to bother with multithread design because the OpenGL
+    context only runs one thread anyway.
+Creator:    John Cox, 4/2017 (ring of counters added by agent, 10/2026)
 ------------------------------------------------------------------------------------------------*/
 class PersistentAtomicCounterBuffer
 {
-private:
-    // no constructing except through GetInstance()
-    PersistentAtomicCounterBuffer();
-    PersistentAtomicCounterBuffer(const PersistentAtomicCounterBuffer &) = delete;
-    PersistentAtomicCounterBuffer &operator=(const PersistentAtomicCounterBuffer &) = delete;
-
 public:
+    PersistentAtomicCounterBuffer(unsigned int numRingSlots = DEFAULT_NUM_RING_SLOTS);
     ~PersistentAtomicCounterBuffer();
+    using SHARED_PTR = std::shared_ptr<PersistentAtomicCounterBuffer>;
     using CONST_SHARED_PTR = std::shared_ptr<const PersistentAtomicCounterBuffer>;
-    static const CONST_SHARED_PTR &GetInstance();
 
-    void ResetCounter() const;
-    unsigned int GetCounterValue() const;
+    // 1 for the frame that is being issued, 1 for the frame that the GPU is (probably) working
+    // on, and a couple spare so that the CPU can run ahead a bit without dropping readings
+    static const unsigned int DEFAULT_NUM_RING_SLOTS = 4;
+
+    void ResetCounter();
+    unsigned int GetCounterValue();
+    void CopyCounterToBuffer(unsigned int destinationBufferId, unsigned int destinationOffsetBytes) const;
 
 private:
+    PersistentAtomicCounterBuffer(const PersistentAtomicCounterBuffer &) = delete;
+    PersistentAtomicCounterBuffer &operator=(const PersistentAtomicCounterBuffer &) = delete;
+
+    void FenceCurrentSlot();
+    void HarvestCompletedSlots();
+    bool TryHarvestSlot(unsigned int slotIndex);
+
     unsigned int _bufferId;
     unsigned int *_bufferPtr;
+    unsigned int _numRingSlots;
+    unsigned int _currentSlot;
+
+    // the slot that was fenced longest ago
+    unsigned int _oldestFencedSlot;
+    unsigned int _mostRecentCompletedValue;
+    std::vector<GLsync> _slotFences;
 };
@@ -15,10 +15,13 @@ Creator:    John Cox, 3/2017
 class IntermediateDataSsbo : public SsboBase
 {
 public:
-    IntermediateDataSsbo(unsigned int numItems);
+    IntermediateDataSsbo(unsigned int numItems, 
+        const GpuBufferRange &transientRange = GpuBufferRange());
     virtual ~IntermediateDataSsbo() = default;
     using SHARED_PTR = std::shared_ptr<IntermediateDataSsbo>;
 
+    static unsigned int NumBytesFor(unsigned int numItems);
+
     void ConfigureConstantUniforms(unsigned int computeProgramId) const override;
     unsigned int NumItems() const;
 
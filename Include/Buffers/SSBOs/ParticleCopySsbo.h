@@ -15,9 +15,12 @@ Creator:    John Cox, 4/2017
 class ParticleCopySsbo : public SsboBase
 {
 public:
-    ParticleCopySsbo(unsigned int numItems);
+    ParticleCopySsbo(unsigned int numItems, 
+        const GpuBufferRange &transientRange = GpuBufferRange());
     virtual ~ParticleCopySsbo() = default;
     using SHARED_PTR = std::shared_ptr<ParticleCopySsbo>;
 
+    static unsigned int NumBytesFor(unsigned int numItems);
+
 private:
 };
\ No newline at end of file
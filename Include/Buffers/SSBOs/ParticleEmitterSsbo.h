@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+#include "Include/Buffers/SSBOs/SsboBase.h"
+#include "Include/Buffers/ParticleEmitterDescriptor.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Encapsulates the SSBO that stores the descriptions of all particle emitters so that the 
+    reset shader can handle all of them in one dispatch.  The space is allocated once for the 
+    maximum number of emitters and the descriptors are re-uploaded every frame (it's only a few 
+    dozen bytes per emitter).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class ParticleEmitterSsbo : public SsboBase
+{
+public:
+    ParticleEmitterSsbo(unsigned int maxEmitters);
+    virtual ~ParticleEmitterSsbo() = default;
+    using SHARED_PTR = std::shared_ptr<ParticleEmitterSsbo>;
+
+    void UploadEmitters(const std::vector<ParticleEmitterDescriptor> &emitters) const;
+    unsigned int MaxEmitters() const;
+
+private:
+    unsigned int _maxEmitters;
+};
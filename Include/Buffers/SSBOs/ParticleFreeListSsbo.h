@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Include/Buffers/SSBOs/SsboBase.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Encapsulates the SSBO that stores the stack of inactive particle indices (see 
+    ParticleFreeListBuffer.comp).  It is owned by the ParticleSsbo because it indexes into that 
+    buffer and must always be the same size.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class ParticleFreeListSsbo : public SsboBase
+{
+public:
+    ParticleFreeListSsbo(unsigned int numItems);
+    virtual ~ParticleFreeListSsbo() = default;
+    using SHARED_PTR = std::shared_ptr<ParticleFreeListSsbo>;
+
+    void Resize(unsigned int numItems);
+    unsigned int ReadFreeIndexCount() const;
+
+private:
+};
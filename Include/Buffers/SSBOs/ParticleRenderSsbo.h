@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "Include/Buffers/SSBOs/SsboBase.h"
+#include "Include/Particles/ParticleRenderVertex.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Encapsulates the SSBO that stores the particles' render vertices (see 
+    ParticleRenderBuffer.comp).  It is owned by the ParticleSsbo because it has one vertex per 
+    particle and must always be the same size, and the ParticleSsbo's VAO reads from it.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class ParticleRenderSsbo : public SsboBase
+{
+public:
+    ParticleRenderSsbo(unsigned int numItems);
+    virtual ~ParticleRenderSsbo() = default;
+    using SHARED_PTR = std::shared_ptr<ParticleRenderSsbo>;
+
+    void Resize(unsigned int numItems);
+    void UploadVertices(const std::vector<ParticleRenderVertex> &vertices, unsigned int numVertices);
+
+private:
+};
@@ -1,28 +1,67 @@
 #pragma once
 
+#include <vector>
+
 #include "Include/Buffers/SSBOs/SsboBase.h"
+#include "Include/Buffers/SSBOs/ParticleFreeListSsbo.h"
+#include "Include/Buffers/SSBOs/ParticleRenderSsbo.h"
+#include "Include/Particles/Particle.h"
 
 /*------------------------------------------------------------------------------------------------
 Description:
     Encapsulates the SSBO that stores Particles.  It generates a chunk of space on the GPU that 
-    is big enough to store the requested number of particles, and since this buffer will be used 
-    in a drawing shader as well as a compute shader, this class will also set up the VAO and the 
-    vertex attributes.
+    is big enough to store the requested number of particles, and since the particles will be 
+    drawn as well as simulated, this class will also set up the VAO and the vertex attributes.
+
+    It also owns the stack of inactive particle indices (ParticleFreeListSsbo) because that 
+    buffer indexes into this one and must always be the same size.
+
+    And it owns the particles' render vertices (ParticleRenderSsbo), which are what the VAO 
+    actually reads.  Drawing only needs each particle's X, Y, and color, so the count stage 
+    writes those out in 12 bytes per particle (see ParticleRenderBuffer.comp), and the vertex 
+    fetch doesn't pull the whole 64-byte Particle for each of them.
+
+    And it owns the glDrawArraysIndirect(...) command that RenderParticles draws the particles 
+    with.  The sort puts the active particles first, so only the first "count" of them are 
+    drawn, and the count is filled in on the GPU (see ParticleUpdate) or by whoever uploaded 
+    the particles (see SetDrawCount(...)), so the number of vertices that are run goes with the 
+    number of active particles instead of the size of the buffer.
 Creator:    John Cox, 3/2017
 ------------------------------------------------------------------------------------------------*/
 class ParticleSsbo : public SsboBase
 {
 public:
     ParticleSsbo(unsigned int numItems);
-    virtual ~ParticleSsbo() = default;
+    virtual ~ParticleSsbo();
     using SHARED_PTR = std::shared_ptr<ParticleSsbo>;
     using CONST_SHARED_PTR = std::shared_ptr<const ParticleSsbo>;
 
+    static void SubmitShaders();
+    static unsigned int GrownCapacity(unsigned int currentNumItems, unsigned int minNumItems);
+
     void ConfigureConstantUniforms(unsigned int computeProgramId) const override;
     void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
     
     unsigned int NumItems() const;
+    void Resize(unsigned int numItems);
+
+    void ReadParticles(std::vector<Particle> &particles) const;
+    void UploadRenderVertices(const std::vector<ParticleRenderVertex> &vertices, unsigned int numVertices);
+
+    unsigned int DrawCommandBufferId() const;
+    void SetDrawCount(unsigned int numParticles);
+
+    // the draw command's "count", the first of its 4 uints
+    static const unsigned int DRAW_COMMAND_COUNT_OFFSET_BYTES = 0;
 
 private:
+    void InitializeOnGpu(unsigned int firstNewParticle, unsigned int freeIndexCountBefore);
+
     unsigned int _numItems;
+    ParticleFreeListSsbo::SHARED_PTR _freeListSsbo;
+    ParticleRenderSsbo::SHARED_PTR _renderVertexSsbo;
+
+    // its own little buffer, not part of the arena, because it is bound to 
+    // GL_DRAW_INDIRECT_BUFFER and nothing else
+    unsigned int _drawCommandBufferId;
 };
\ No newline at end of file
@@ -13,10 +13,14 @@ Creator:    John Cox, 3/2017
 class PrefixSumSsbo : public SsboBase
 {
 public:
-    PrefixSumSsbo(unsigned int numDataEntries);
+    PrefixSumSsbo(unsigned int numDataEntries, unsigned int itemsPerWorkGroup, 
+        const GpuBufferRange &transientRange = GpuBufferRange());
     virtual ~PrefixSumSsbo() = default;
     using SHARED_PTR = std::shared_ptr<PrefixSumSsbo>;
 
+    static unsigned int NumDataEntriesFor(unsigned int numDataEntries, unsigned int itemsPerWorkGroup);
+    static unsigned int NumBytesFor(unsigned int numDataEntries, unsigned int itemsPerWorkGroup);
+
     void ConfigureConstantUniforms(unsigned int computeProgramId) const override;
     unsigned int NumPerGroupPrefixSums() const;
     unsigned int NumDataEntries() const;
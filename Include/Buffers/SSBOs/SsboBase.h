@@ -3,10 +3,16 @@
 #include <string>
 #include <memory>
 
+#include "Include/Buffers/GpuBufferArena.h"
+
 /*------------------------------------------------------------------------------------------------
 Description:
     Defines the constructor, which gives the members zero values, and the destructor, which 
     deletes any allocated buffers.  
+
+    The buffer is a range of one of GpuBufferArena's blocks, so it might not start at offset 0 
+    of BufferId().  Bind it with glBindBufferRange(...) and add BufferOffsetBytes() to any 
+    other offsets into it.
 Creator:    John Cox, 9-20-2016
 ------------------------------------------------------------------------------------------------*/
 class SsboBase
@@ -23,12 +29,19 @@ public:
 
     unsigned int VaoId() const;
     unsigned int BufferId() const;
+    unsigned int BufferOffsetBytes() const;
+    unsigned int BufferSizeBytes() const;
     unsigned int DrawStyle() const;
     unsigned int NumVertices() const;
 
     //static unsigned int GetStorageBlockBindingPointIndexForBuffer(const std::string &bufferNameInShader);
 
 protected:
+    void AllocateBuffer(const std::string &name, unsigned int numBytes, const void *initialData);
+    void UseBufferRange(const GpuBufferRange &range, unsigned int numBytesNeeded);
+    void GrowBuffer(const std::string &name, unsigned int numBytes);
+    void BindBufferRange(unsigned int ssboBindingIndex) const;
+
     // can't be private because the derived classes need to set them or read them
 
     // save on the large header inclusion of OpenGL and write out these primitive types instead 
@@ -36,8 +49,9 @@ protected:
     // Note: IDs are GLuint (unsigned int), draw style is GLenum (unsigned int), GLushort is 
     // unsigned short.
     
-    unsigned int _vaoId;
-    unsigned int _bufferId;
+    unsigned int _vaoId;        // 0 unless the derived class renders from the buffer
+    GpuBufferRange _bufferRange;
+    bool _ownsBufferRange;      // false if it came from someone else (see UseBufferRange(...))
     unsigned int _drawStyle;    // GL_TRIANGLES, GL_LINES, etc.
     unsigned int _numVertices;
 
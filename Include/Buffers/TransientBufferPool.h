@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Include/Buffers/GpuBufferArena.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Scratch buffers that are only needed for part of a sequence of steps (the sort's radix
+    passes, etc.) can share memory with other scratch buffers whose steps don't overlap.
+
+    Usage: AddBuffer(...) for each buffer with the first and last step that reads or writes
+    it, then Allocate() once, then BufferRange(...) for each buffer.  The steps are whatever
+    the owner says they are (an enum of its dispatch stages, usually); only their order
+    matters.
+
+    Allocate() places the largest buffers first, each at the lowest offset that doesn't overlap
+    a buffer that is alive at the same time, and takes the whole thing from the GpuBufferArena
+    as one range.
+
+    Note: A buffer's contents do not survive from one use to the next, because some other
+    buffer may have been written over it in between.  Every buffer in a pool must be entirely
+    written within its lifetime before it is read.  Only the first use starts out as 0s.
+
+    Also Note: MemoryBarrierTracker identifies buffers by binding point, so it doesn't know
+    that two bindings share memory.  The owner should ask BuffersShareMemory(...) and declare
+    the extra access (see ParallelSort::BuildSortGraph()).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class TransientBufferPool
+{
+public:
+    TransientBufferPool(const std::string &name);
+    ~TransientBufferPool();
+
+    unsigned int AddBuffer(const std::string &name, unsigned int numBytes, unsigned int firstStep,
+        unsigned int lastStep);
+    void Allocate();
+    void Clear();
+
+    GpuBufferRange BufferRange(unsigned int bufferIndex) const;
+    bool BuffersShareMemory(unsigned int bufferIndexA, unsigned int bufferIndexB) const;
+    unsigned int PeakBytes() const;
+    unsigned int UnaliasedBytes() const;
+    void PrintReport() const;
+
+private:
+    TransientBufferPool(const TransientBufferPool &) = delete;
+    TransientBufferPool &operator=(const TransientBufferPool &) = delete;
+
+    struct TransientBuffer
+    {
+        std::string _name;
+        unsigned int _sizeBytes;
+        unsigned int _firstStep;
+        unsigned int _lastStep;
+
+        // relative to the start of the pool's range, set by Allocate()
+        unsigned int _offsetBytes;
+    };
+
+    static bool LifetimesOverlap(const TransientBuffer &a, const TransientBuffer &b);
+
+    std::string _name;
+    std::vector<TransientBuffer> _buffers;
+
+    // the whole pool, 0 until Allocate()
+    GpuBufferRange _poolRange;
+};
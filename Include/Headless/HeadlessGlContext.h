@@ -0,0 +1,45 @@
+#pragma once
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes an OpenGL context current on the calling thread without showing a window, so that 
+    the compute shaders can be run on machines with no display (build servers, soak test 
+    boxes, etc.).  Nothing is ever rendered to a surface; all the work is compute shaders and 
+    buffers.
+
+    On Windows there is no way to get a WGL context without a window, so this makes a window 
+    and never shows it.  On Linux it uses EGL, first with a surfaceless display 
+    (EGL_MESA_platform_surfaceless, which also works when there is no X server at all) and 
+    then the default display.  If the EGL implementation doesn't support 
+    EGL_KHR_surfaceless_context, a 1x1 pbuffer is made current instead.
+
+    Note: For a software implementation, Mesa's llvmpipe does OpenGL 4.5 core.  Set 
+    LIBGL_ALWAYS_SOFTWARE=1 (or GALLIUM_DRIVER=llvmpipe) to force it.
+
+    Also Note: The platform headers are only included in the .cpp.  Including windows.h 
+    before the glload headers causes trouble, so the members are void pointers here.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class HeadlessGlContext
+{
+public:
+    HeadlessGlContext();
+    ~HeadlessGlContext();
+
+    bool Init(int majorVersion, int minorVersion, bool debugContext);
+    void Cleanup();
+
+private:
+    HeadlessGlContext(const HeadlessGlContext &) = delete;
+    HeadlessGlContext &operator=(const HeadlessGlContext &) = delete;
+
+#ifdef WIN32
+    void *_windowHandle;
+    void *_deviceContextHandle;
+    void *_glContextHandle;
+#else
+    void *_eglDisplay;
+    void *_eglSurface;
+    void *_eglContext;
+#endif
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ThirdParty/glm/vec4.hpp"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU version of Random.comp.  It is here so that a CPU reference implementation of 
+    particle resetting can produce the same random numbers, bit for bit, as the reset shader.
+
+    Make sure that it matches Random.comp.
+
+    Note: glm::uvec4 arithmetic wraps on overflow just like GLSL uints, so this is a straight 
+    copy of the shader code.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+namespace CounterBasedRandom
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The pcg4d hash.  See Random.comp.
+    Parameters: 
+        v   The 4-part key.
+    Returns:
+        4 well-mixed uints.
+    Creator:    Mark Jarzynski and Marc Olano, 2020 (pcg4d); ported by agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    inline glm::uvec4 Pcg4d(glm::uvec4 v)
+    {
+        v = v * 1664525u + 1013904223u;
+
+        v.x += v.y * v.w;
+        v.y += v.z * v.x;
+        v.z += v.x * v.y;
+        v.w += v.y * v.z;
+
+        v ^= (v >> 16u);
+
+        v.x += v.y * v.w;
+        v.y += v.z * v.x;
+        v.z += v.x * v.y;
+        v.w += v.y * v.z;
+
+        return v;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Generates 4 random floats on the range [0,1) for a single emission.  The shader gets 
+        the seed and the frame number from uniforms, so they are arguments here.
+    Parameters: 
+        randomSeed      Same value as was given to ParticleReset::SetRandomSeed(...).
+        frameNumber     0 on the first reset after the seed was set, 1 on the next, etc.
+        emitterIndex    Point emitters first, then bar emitters, in the order they were added.
+        emissionIndex   Which of that emitter's emissions this frame.
+        drawNumber      0 for the first 4 numbers, 1 for the next 4, etc.
+    Returns:
+        A vec4 of random values on [0,1).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    inline glm::vec4 RandomVec4On0To1(unsigned int randomSeed, unsigned int frameNumber, 
+        unsigned int emitterIndex, unsigned int emissionIndex, unsigned int drawNumber)
+    {
+        glm::uvec4 key(frameNumber, emitterIndex, emissionIndex, randomSeed ^ (drawNumber * 0x9E3779B9u));
+        glm::uvec4 bits = Pcg4d(key);
+        return glm::vec4(bits >> 8u) * (1.0f / 16777216.0f);
+    }
+}
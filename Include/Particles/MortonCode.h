@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Shaders/ParticleRegionBoundaries.comp"
+#include "Shaders/ParticleScenes.comp"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU version of PositionToMortonCode.comp plus the sort key from
+    ParticleDataToIntermediateData.comp.  It is here so that the CPU simulation (see
+    CpuParticleSimulation) sorts the particles into the same order as the GPU does.
+
+    Make sure that it matches PositionToMortonCode.comp.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+namespace MortonCode
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Spreads the bottom 10 bits of the input out to every third bit.  See
+        PositionToMortonCode.comp.
+    Parameters:
+        i   An unsigned integer within the range 0-1023 (2^10 - 1).
+    Returns:
+        A 30bit bit version of the input.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    inline unsigned int ExpandBits(unsigned int i)
+    {
+        unsigned int expandedI = i;
+        expandedI = (expandedI * 0x00010001u) & 0xFF0000FFu;
+        expandedI = (expandedI * 0x00000101u) & 0x0F00F00Fu;
+        expandedI = (expandedI * 0x00000011u) & 0xC30C30C3u;
+        expandedI = (expandedI * 0x00000005u) & 0x49249249u;
+        return expandedI;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Turns a position in the particle region into a 30bit Morton Code.  See
+        PositionToMortonCode.comp for the details.
+
+        Note: The shader takes a vec4 and ignores the W, so this just takes X, Y, and Z.
+    Parameters:
+        x   Self-explanatory.
+        y   Self-explanatory.
+        z   Self-explanatory.
+    Returns:
+        A 30bit unsigned int Morton Code.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    inline unsigned int PositionToMortonCode(float x, float y, float z)
+    {
+        // reduce it to the range [-1,+1] on all axes, then to [0,+1]
+        float inverseParticleRange = 1.0f / (2.0f * static_cast<float>(PARTICLE_REGION_RADIUS));
+        x = ((x * inverseParticleRange) + 1.0f) * 0.5f;
+        y = ((y * inverseParticleRange) + 1.0f) * 0.5f;
+        z = ((z * inverseParticleRange) + 1.0f) * 0.5f;
+
+        float clampX = std::min(std::max(x * 1024.0f, 0.0f), 1023.0f);
+        float clampY = std::min(std::max(y * 1024.0f, 0.0f), 1023.0f);
+        float clampZ = std::min(std::max(z * 1024.0f, 0.0f), 1023.0f);
+
+        unsigned int xx = ExpandBits(static_cast<unsigned int>(clampX));
+        unsigned int yy = ExpandBits(static_cast<unsigned int>(clampY));
+        unsigned int zz = ExpandBits(static_cast<unsigned int>(clampZ));
+        return (xx * 4) + (yy * 2) + zz;
+    }
+
+    // what ParticleDataToIntermediateData.comp gives inactive particles so that they sort to
+    // the back (see ParticleScenes.comp)
+    static const unsigned int INACTIVE_PARTICLE_SORT_KEY = 0xfffffff0;
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The key that the parallel sort sorts an active particle by.  See ParticleScenes.comp.
+    Parameters:
+        sceneId     Self-explanatory.
+        mortonCode  From PositionToMortonCode(...).
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    inline unsigned int ParticleSortKey(unsigned int sceneId, unsigned int mortonCode)
+    {
+        return (sceneId << PARTICLE_SORT_KEY_SCENE_ID_SHIFT) | (mortonCode >> PARTICLE_SORT_KEY_MORTON_CODE_SHIFT);
+    }
+}
@@ -29,7 +29,8 @@ struct Particle
         _collisionRadius(0.01f),
         _mortonCode(0),
         _hasCollidedAlreadyThisFrame(0),
-        _isActive(0)
+        _isActive(0),
+        _sceneId(0)
     {
     }
 
@@ -77,7 +78,12 @@ struct Particle
     // (https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml), so send the 
     // "is active" flag as an integer.  
     int _isActive; 
+
+    // particles from different scenes never collide or count each other as nearby, and the 
+    // sort groups them by scene (see ParticleScenes.comp)
+    // Note: This used to be the first of 2 ints of padding.
+    unsigned int _sceneId;
     
     // any necessary padding out to 16 bytes to match the GPU's version
-    int _padding[2];
+    int _padding;
 };
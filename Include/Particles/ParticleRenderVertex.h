@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Shaders/ParticleRenderVertex.comp"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    What RenderParticles draws for one particle (see ParticleRenderVertex.comp).  The GPU 
+    simulation writes these in CountNearbyParticles.comp, and the CPU simulation fills them in 
+    itself and uploads them (see ParticleSsbo::UploadRenderVertices(...)).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct ParticleRenderVertex
+{
+    float _positionX;
+    float _positionY;
+
+    // PARTICLE_RENDER_INACTIVE_COLOR_INDEX if the particle is inactive
+    unsigned int _colorIndex;
+};
+
+static_assert(sizeof(ParticleRenderVertex) == PARTICLE_RENDER_VERTEX_UINTS * sizeof(unsigned int),
+    "ParticleRenderVertex must match ParticleRenderVertex.comp");
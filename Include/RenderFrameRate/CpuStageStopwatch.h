@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "Include/RenderFrameRate/Stopwatch.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU's version of GpuStopwatch, with the same usage: StartFrame(), then EndStage(n) 
+    after stage n, for each stage in order.  It measures the time that the CPU spends in each 
+    stage, which is the whole story for CpuParticleSimulation and only the time to issue the 
+    commands for GpuParticleSimulation.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class CpuStageStopwatch
+{
+public:
+    CpuStageStopwatch(unsigned int numStages);
+
+    void StartFrame();
+    void EndStage(unsigned int stageIndex);
+    void Reset();
+
+    unsigned int NumStages() const;
+    unsigned int NumFramesMeasured() const;
+    double AverageStageTime(unsigned int stageIndex) const;
+    double MinStageTime(unsigned int stageIndex) const;
+    double MaxStageTime(unsigned int stageIndex) const;
+    double AverageFrameTime() const;
+
+private:
+    Stopwatch _stopwatch;
+    unsigned int _numStages;
+
+    // all in seconds
+    unsigned int _numFramesMeasured;
+    std::vector<double> _totalStageTimes;
+    std::vector<double> _minStageTimes;
+    std::vector<double> _maxStageTimes;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Include/RenderFrameRate/Stopwatch.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Turns wall time into a whole number of fixed-size simulation steps.
+
+    Each call to StepsThisFrame() adds the time since the last call to an accumulator and 
+    takes as many whole steps out of it as will fit.  The leftover time carries over to the 
+    next frame.  At 60 rendered frames per second and a 0.01 second step, that comes out to 
+    1 or 2 steps per frame, and the simulation runs at the same speed no matter how fast or 
+    slow the rendering is.
+
+    To keep a slow frame from causing more steps, which make the next frame slower, which 
+    causes even more steps (the "spiral of death"), the steps per frame are capped.  Time 
+    beyond the cap is thrown away and the simulation just runs slower than real time until 
+    the GPU catches up.
+
+    Note: Based on Glenn Fiedler's "Fix Your Timestep!" 
+    (https://gafferongames.com/post/fix_your_timestep/).  I don't interpolate between steps 
+    for rendering; the particles are small and fast enough that it doesn't show.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class FixedTimestep
+{
+public:
+    FixedTimestep(float stepSizeSec, unsigned int maxStepsPerFrame);
+
+    void Start();
+    unsigned int StepsThisFrame();
+
+    float StepSize() const;
+    unsigned int NumDroppedSteps() const;
+
+private:
+    Stopwatch _timer;
+    float _stepSizeSec;
+    unsigned int _maxStepsPerFrame;
+    double _accumulatedTime;
+    unsigned int _numDroppedSteps;
+};
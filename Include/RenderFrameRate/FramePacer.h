@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Include/RenderFrameRate/Stopwatch.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Keeps the CPU from getting more than a few frames ahead of the GPU.  
+
+    Each frame gets a fence after its commands are issued (see EndFrame()).  When there are 
+    already as many unfinished frames as allowed, BeginFrame() waits for the oldest one before 
+    letting the caller issue more commands.  Without this, the driver will happily queue up 
+    frame after frame until something (like glutSwapBuffers() or a buffer map) blocks for a 
+    long time, and the simulation on screen lags further and further behind the input.
+
+    Note: This used to be three static GLsync objects in main.cpp's UpdateAllTheThings(), and 
+    the wait was a loop on glClientWaitSync(..., 1 nanosecond) until the fence from two frames 
+    ago was signaled.  That was a busy wait and kept a CPU core pegged at 100% whenever the GPU 
+    was the bottleneck.  Now the fence is polled (timeout 0), and if it isn't ready, the thread 
+    yields, and after a few yields it sleeps for a short while between polls.  
+
+    Also Note: The time spent waiting is recorded so that it is easy to tell if the CPU or the 
+    GPU is the bottleneck.  If the wait time is about 0, the CPU is the bottleneck.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class FramePacer
+{
+public:
+    FramePacer(unsigned int maxFramesInFlight = DEFAULT_MAX_FRAMES_IN_FLIGHT);
+    ~FramePacer();
+
+    // same as the old "wait on the fence from 2 frames ago" in main.cpp
+    static const unsigned int DEFAULT_MAX_FRAMES_IN_FLIGHT = 2;
+
+    void BeginFrame();
+    void EndFrame();
+
+    double LastFrameWaitTime() const;
+    double AverageFrameWaitTime() const;
+    unsigned int NumFramesSinceStatReset() const;
+    void ResetWaitStats();
+
+private:
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    bool TryRetireOldestFrame();
+
+    // polls that come up empty before the pacer stops yielding and starts sleeping
+    static const unsigned int YIELDS_BEFORE_SLEEPING = 16;
+    static const unsigned int SLEEP_MICROSECONDS = 200;
+
+    unsigned int _maxFramesInFlight;
+    unsigned int _oldestFrameFence;
+    unsigned int _numFramesInFlight;
+    std::vector<GLsync> _frameFences;
+
+    Stopwatch _waitTimer;
+    double _lastFrameWaitTime;
+    double _totalWaitTime;
+    unsigned int _numFramesSinceStatReset;
+};
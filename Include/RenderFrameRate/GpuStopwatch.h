@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Times how long the GPU spends on each stage of a frame with timestamp queries.  
+    
+    Stopwatch measures how long the CPU takes to issue commands, which says next to nothing 
+    about how long the GPU takes to run them.  ParallelSort::SortWithProfiling() gets around 
+    that with glFinish() between steps, but that stalls the pipeline and changes what is being 
+    measured.  Timestamp queries are written by the GPU when it gets to them, so they measure 
+    the real thing without stalling anything.
+
+    Usage: StartFrame(), then EndStage(n) after issuing stage n's commands, for each stage in 
+    order.  Results are read a few frames later when they are (almost certainly) ready.  Call 
+    Finish() once at the end to collect the stragglers.
+
+    Note: The time for stage n is the time between the end of stage n-1 (or the start of the 
+    frame) and the end of stage n, so any barrier that a stage issues counts toward that stage.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class GpuStopwatch
+{
+public:
+    GpuStopwatch(unsigned int numStages, unsigned int numFramesInFlight = DEFAULT_NUM_FRAMES_IN_FLIGHT);
+    ~GpuStopwatch();
+
+    static const unsigned int DEFAULT_NUM_FRAMES_IN_FLIGHT = 4;
+
+    void StartFrame();
+    void EndStage(unsigned int stageIndex);
+    void Finish();
+    void Reset();
+
+    unsigned int NumStages() const;
+    unsigned int NumFramesMeasured() const;
+    double AverageStageTime(unsigned int stageIndex) const;
+    double MinStageTime(unsigned int stageIndex) const;
+    double MaxStageTime(unsigned int stageIndex) const;
+    double AverageFrameTime() const;
+
+private:
+    GpuStopwatch(const GpuStopwatch &) = delete;
+    GpuStopwatch &operator=(const GpuStopwatch &) = delete;
+
+    void HarvestFrame(unsigned int frameSlot);
+
+    unsigned int _numStages;
+    unsigned int _numFramesInFlight;
+    unsigned int _currentFrameSlot;
+
+    // (_numStages + 1) timestamps per frame slot: frame start, then the end of each stage
+    std::vector<GLuint> _queryIds;
+    std::vector<bool> _frameSlotPending;
+
+    // all in nanoseconds
+    unsigned int _numFramesMeasured;
+    std::vector<GLuint64> _totalStageTimes;
+    std::vector<GLuint64> _minStageTimes;
+    std::vector<GLuint64> _maxStageTimes;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ShaderControllers
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Every compute shader program in the simulation, in the order that they run each frame.
+        Each one can have its own work group size and items per thread.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    enum ComputeStage
+    {
+        COMPUTE_STAGE_RESET = 0,
+        COMPUTE_STAGE_UPDATE,
+
+        // the parallel sort's programs
+        // Note: These all share the prefix scan buffer, whose layout depends on the prefix
+        // scan's work group size (see ComputeShaderVariant::ParallelSortItemsPerWorkGroup()).
+        COMPUTE_STAGE_SORT_KEYS,
+        COMPUTE_STAGE_SORT_GET_BIT,
+        COMPUTE_STAGE_SORT_PREFIX_SCAN,
+        COMPUTE_STAGE_SORT_SCATTER,
+        COMPUTE_STAGE_SORT_GATHER,
+
+        COMPUTE_STAGE_COLLIDE,
+        COMPUTE_STAGE_COUNT_NEARBY,
+        NUM_COMPUTE_STAGES
+    };
+
+    const char *ComputeStageName(ComputeStage stage);
+    bool IsParallelSortStage(ComputeStage stage);
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Describes one build of the compute shaders: each stage's work group size and items per
+        thread, and any extra "#define NAME VALUE" feature switches.  The shader controllers
+        take one of these, inject its defines into their shaders (see
+        ShaderStorage::AddShaderDefine(...)), and do their dispatch math with its sizes instead
+        of the #define'd defaults in ComputeShaderWorkGroupSizes.comp.
+
+        The best work group size depends on the hardware.  A GPU wants enough threads per
+        group to hide memory latency, while a software rasterizer (llvmpipe, etc.) runs each
+        work group on one CPU thread and would rather have more, smaller groups.  This lets the
+        sizes be picked when the program starts instead of when it is compiled, and the
+        headless runner's --tune mode measures them and saves the winners with SaveProfile(...).
+
+        Each stage's program is stored under a key that only depends on that stage's settings
+        (see ProgramKey(...)), so several variants can exist at once, and variants that only
+        differ in one stage share the other stages' programs.
+
+        Note: The parallel sort's prefix scan works on 2 items per thread (it's a binary tree
+        within the work group), and its work group size sets the size of the prefix scan
+        buffers and the largest number of items that the two-level prefix scan can handle
+        (items per work group squared), so a small scan work group limits the particle count.
+        See IsSupported(...).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    class ComputeShaderVariant
+    {
+    public:
+        ComputeShaderVariant();
+        ComputeShaderVariant(unsigned int particleOperationsWorkGroupSizeX,
+            unsigned int parallelSortWorkGroupSizeX);
+
+        void SetStage(ComputeStage stage, unsigned int workGroupSizeX, unsigned int itemsPerThread);
+        void AddFeatureDefine(const std::string &name, const std::string &value = "1");
+
+        unsigned int WorkGroupSizeX(ComputeStage stage) const;
+        unsigned int ItemsPerThread(ComputeStage stage) const;
+        unsigned int ItemsPerWorkGroup(ComputeStage stage) const;
+        unsigned int NumWorkGroups(ComputeStage stage, unsigned int numItems) const;
+        unsigned int ParallelSortItemsPerWorkGroup() const;
+        unsigned int ParallelSortMaxItems() const;
+
+        bool IsSupported(unsigned int numParticles) const;
+        std::string Name() const;
+        std::string ProgramKey(const std::string &baseProgramKey, ComputeStage stage) const;
+        void AddDefinesToProgram(const std::string &programKey, ComputeStage stage) const;
+
+        bool LoadProfile(const std::string &filePath);
+        bool SaveProfile(const std::string &filePath) const;
+
+    private:
+        unsigned int _workGroupSizesX[NUM_COMPUTE_STAGES];
+        unsigned int _itemsPerThread[NUM_COMPUTE_STAGES];
+
+        // name, value
+        std::vector<std::pair<std::string, std::string>> _featureDefines;
+    };
+}
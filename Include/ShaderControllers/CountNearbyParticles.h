@@ -4,6 +4,8 @@
 #include <string>
 
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
+#include "Include/ShaderControllers/DispatchGraph.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
 
 namespace ShaderControllers
 {
@@ -22,13 +24,23 @@ namespace ShaderControllers
     class CountNearbyParticles
     {
     public:
-        CountNearbyParticles(const ParticleSsbo::CONST_SHARED_PTR particlesToAnalyze);
+        CountNearbyParticles(const ParticleSsbo::CONST_SHARED_PTR particlesToAnalyze, 
+            const ComputeShaderVariant &variant = ComputeShaderVariant());
         ~CountNearbyParticles();
 
-        void Count() const;
+        static void SubmitShaders(const ComputeShaderVariant &variant = ComputeShaderVariant());
+        void ParticleBufferResized(const ParticleSsbo::CONST_SHARED_PTR resizedSsbo);
+
+        void Count();
 
     private:
+        void BuildCountGraph();
+
+        // picks the program key and the dispatch sizes
+        ComputeShaderVariant _variant;
+
         unsigned int _totalParticleCount;
         unsigned int _computeProgramId;
+        DispatchGraph _countGraph;
     };
 }
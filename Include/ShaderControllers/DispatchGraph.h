@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
+
+namespace ShaderControllers
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A list of GPU stages (usually one glDispatchCompute(...) each) that declare which
+        buffers they read and write.  The graph takes care of the barriers between them.
+
+        Usage: AddStage(...) for each stage at startup, in the order that they would be issued
+        by hand, then Execute() whenever the stages should run.  The stage functions are called
+        every time, so anything that changes between runs (uniforms, dispatch sizes) should be
+        read from the controller's members inside the function rather than captured by value.
+
+        The first Execute() puts the stages into "levels".  A stage's level is one more than
+        the highest level of any earlier stage that it conflicts with (they touch the same
+        buffer and at least one of them writes it), so the stages within a level don't depend
+        on each other.  Each level is preceded by a single barrier that is the union of the bits
+        that its stages need (see MemoryBarrierTracker), and independent stages that were
+        declared apart are issued together, so they share that barrier instead of each paying
+        for their own.
+
+        Note: A stage function must set all of its own state (glUseProgram(...), uniforms,
+        bindings) because the stage before it in the issue order might not be the stage before
+        it in the declared order.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    class DispatchGraph
+    {
+    public:
+        DispatchGraph(const std::string &name);
+
+        void AddStage(const std::string &stageName, const std::vector<BufferAccess> &accesses,
+            const std::function<void()> &issueCommands);
+        void Clear();
+        void Execute();
+
+        unsigned int NumStages() const;
+        unsigned int NumLevels();
+        void PrintSchedule();
+
+    private:
+        DispatchGraph(const DispatchGraph &) = delete;
+        DispatchGraph &operator=(const DispatchGraph &) = delete;
+
+        struct Stage
+        {
+            std::string _name;
+            std::vector<BufferAccess> _accesses;
+            std::function<void()> _issueCommands;
+            unsigned int _level;
+        };
+
+        static bool StagesConflict(const Stage &earlier, const Stage &later);
+        void Schedule();
+
+        std::string _name;
+        std::vector<Stage> _stages;
+
+        // stage indices sorted by level (stable, so declared order within a level), plus where
+        // each level starts in that list (with one extra entry for the end)
+        std::vector<unsigned int> _issueOrder;
+        std::vector<unsigned int> _levelStarts;
+        bool _isScheduled;
+    };
+}
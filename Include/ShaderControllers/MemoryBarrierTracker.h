@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+
+namespace ShaderControllers
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The ways that a buffer can be touched by a GL command.  Each one is made visible by a
+        different glMemoryBarrier(...) bit (see BarrierBitForAccessType(...)).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    enum class BufferAccessType
+    {
+        // buffer variables in a shader (including atomic*(...) on them)
+        SHADER_STORAGE = 0,
+
+        // atomic counters (the layout (binding = ...) uniform atomic_uint kind)
+        ATOMIC_COUNTER,
+
+        // vertex attributes sourced from the buffer
+        VERTEX_ATTRIB,
+
+        // the buffer as the source of indirect draw or dispatch arguments
+        COMMAND,
+
+        // glBufferSubData(...), glCopyBufferSubData(...), glClearBufferSubData(...), etc.
+        BUFFER_UPDATE,
+
+        // the CPU reading or writing through a persistent mapping
+        CLIENT_MAPPED,
+    };
+
+    GLbitfield BarrierBitForAccessType(BufferAccessType accessType);
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        One stage's use of one buffer.  The buffer is identified by its binding point from
+        SsboBufferBindings.comp (PARTICLE_BUFFER_BINDING, etc.) because that is how everything
+        else in this demo refers to buffers.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    struct BufferAccess
+    {
+        BufferAccess(unsigned int bufferBinding, BufferAccessType accessType, bool isWrite) :
+            _bufferBinding(bufferBinding),
+            _accessType(accessType),
+            _isWrite(isWrite)
+        {
+        }
+
+        unsigned int _bufferBinding;
+        BufferAccessType _accessType;
+        bool _isWrite;
+    };
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Keeps track of which buffers have been written by shaders and which glMemoryBarrier(...)
+        bits have been issued since then, so that a command that is about to touch a buffer can
+        ask for only the barrier bits that it actually needs.
+
+        Shader writes to SSBOs and atomic counters are "incoherent", so they need a barrier
+        before anything else (another shader, the vertex fetcher, glCopyBufferSubData(...), a
+        persistent mapping) can see them, and each of those consumers has its own barrier bit.
+        Writes by other GL commands (glBufferSubData(...), glCopyBufferSubData(...), etc.) are
+        ordered by the GL and don't need one.
+
+        Every controller used to end each dispatch with "SSBO | vertex | whatever else might
+        need it", whether or not the next command touched that buffer that way.  The tracker
+        instead owes each buffer every bit after a shader writes it, and a bit stops being owed
+        once it is issued, so a buffer that is read by three shaders in a row gets one
+        GL_SHADER_STORAGE_BARRIER_BIT, and the vertex bit is only issued when (and if) the
+        particles are drawn.
+
+        Note: This is a singleton because the state is global.  Stages in different controllers
+        write and read the same buffers, and a barrier issued by one controller serves all the
+        others.
+
+        Also Note: Buffers are tracked by binding, not by offset, so a write to any part of a
+        buffer counts as a write to all of it.  That's conservative, never wrong.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    class MemoryBarrierTracker
+    {
+    public:
+        static MemoryBarrierTracker &GetInstance();
+
+        GLbitfield BarrierBitsFor(const BufferAccess &access) const;
+        void RecordAccess(const BufferAccess &access);
+        void IssueBarrier(GLbitfield barrierBits);
+        void WaitForAccess(const BufferAccess &access);
+
+        unsigned int NumBarriersIssued() const;
+        void ResetStats();
+
+    private:
+        // defined privately to enforce singleton-ness
+        MemoryBarrierTracker();
+        MemoryBarrierTracker(const MemoryBarrierTracker &) = delete;
+        MemoryBarrierTracker &operator=(const MemoryBarrierTracker &) = delete;
+
+        // indexed by buffer binding; grows as new bindings show up
+        std::vector<GLbitfield> _owedBarrierBits;
+        unsigned int _numBarriersIssued;
+    };
+}
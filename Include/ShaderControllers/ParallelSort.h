@@ -8,6 +8,9 @@
 #include "Include/Buffers/SSBOs/IntermediateDataSsbo.h"
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
 #include "Include/Buffers/SSBOs/ParticleCopySsbo.h"
+#include "Include/Buffers/TransientBufferPool.h"
+#include "Include/ShaderControllers/DispatchGraph.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
 
 namespace ShaderControllers
 {
@@ -48,19 +51,38 @@ namespace ShaderControllers
     class ParallelSort
     {
     public:
-        ParallelSort(const ParticleSsbo::CONST_SHARED_PTR dataToSort);
+        ParallelSort(const ParticleSsbo::CONST_SHARED_PTR dataToSort, 
+            const ComputeShaderVariant &variant = ComputeShaderVariant());
         ~ParallelSort();
 
+        static void SubmitShaders(const ComputeShaderVariant &variant = ComputeShaderVariant());
+
         void SortWithProfiling() const;
-        void SortWithoutProfiling() const;
+        void SortWithoutProfiling();
+        void PrintTransientBufferReport() const;
+
+        bool CanSort(unsigned int numItems) const;
+        bool ParticleBufferResized();
 
     private:
+        void AllocateSortBuffers();
+        void BuildSortGraph();
+
+        // picks the program keys and the dispatch sizes
+        ComputeShaderVariant _variant;
+
         unsigned int _particleDataToIntermediateDataProgramId;
         unsigned int _getBitForPrefixScansProgramId;
         unsigned int _parallelPrefixScanProgramId;
         unsigned int _sortIntermediateDataProgramId;
         unsigned int _sortParticlesProgramId;
 
+        // the scratch buffers below share this memory where their lifetimes allow
+        // Note: Declared before the SSBOs so that it is destroyed after them.
+        TransientBufferPool _transientBuffers;
+        unsigned int _prefixSumBufferIndex;
+        unsigned int _particleCopyBufferIndex;
+
         // these are unique to this class and are needed for sorting
         ParticleCopySsbo::SHARED_PTR _particleCopySsbo;
         IntermediateDataSsbo::SHARED_PTR _intermediateDataSsbo;
@@ -70,5 +92,7 @@ namespace ShaderControllers
         // back to the original buffer
         ParticleSsbo::CONST_SHARED_PTR _particleSsbo;
 
+        // every step of SortWithoutProfiling(), built once because the sizes never change
+        DispatchGraph _sortGraph;
     };
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
+#include "Include/ShaderControllers/DispatchGraph.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
 
 namespace ShaderControllers
 {
@@ -13,15 +15,25 @@ namespace ShaderControllers
     class ParticleCollide
     {
     public:
-        ParticleCollide(const ParticleSsbo::SHARED_PTR &ssboToWorkWith);
+        ParticleCollide(const ParticleSsbo::SHARED_PTR &ssboToWorkWith, 
+            const ComputeShaderVariant &variant = ComputeShaderVariant());
         ~ParticleCollide();
 
+        static void SubmitShaders(const ComputeShaderVariant &variant = ComputeShaderVariant());
+        void ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo);
+
         void DetectAndResolveCollisions();
 
     private:
+        void BuildCollideGraph();
+
+        // picks the program key and the dispatch sizes
+        ComputeShaderVariant _variant;
+
         unsigned int _totalParticleCount;
         unsigned int _computeProgramId;
 
         int _unifLocIndexOffsetBy0Or1;
+        DispatchGraph _collideGraph;
     };
 }
@@ -7,7 +7,9 @@
 #include "Include/Particles/IParticleEmitter.h"
 #include "Include/Particles/ParticleEmitterPoint.h"
 #include "Include/Particles/ParticleEmitterBar.h"
-#include "Include/Buffers/PersistentAtomicCounterBuffer.h"
+#include "Include/Buffers/SSBOs/ParticleEmitterSsbo.h"
+#include "Include/ShaderControllers/DispatchGraph.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
 
 
 namespace ShaderControllers
@@ -23,7 +25,12 @@ namespace ShaderControllers
         (2) Bar emitters eject particles outwards from a 2D plane 
 
         These was deemed different enough to justify splitting the once-one shader into two, one
-        for each type of emitter.  This shader controller has the info for both.
+        for each type of emitter.  That meant a dispatch (and a barrier) per emitter though, so 
+        now all emitters are described in a ParticleEmitterSsbo and one dispatch 
+        resets particles for all of them.  Adding emitters costs a few dozen bytes of upload 
+        per frame and nothing else on the CPU side.  The reset shader takes inactive particles 
+        from a free list that is kept on the GPU, so it only does as much work as the number of 
+        particles that it spawns.
 
         Note: Unlike in previous Particle-related demos, shared pointers are used and the 
         ParticleReset emitter is now an "owner" of the emitters.  By using shared pointers, the 
@@ -35,42 +42,65 @@ namespace ShaderControllers
     class ParticleReset
     {
     public:
-        ParticleReset(const ParticleSsbo::SHARED_PTR &ssboToReset);
+        ParticleReset(const ParticleSsbo::SHARED_PTR &ssboToReset, 
+            const ComputeShaderVariant &variant = ComputeShaderVariant());
         ~ParticleReset();
 
+        static void SubmitShaders(const ComputeShaderVariant &variant = ComputeShaderVariant());
+        void ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo);
+
         // Note: Have to use a copy, not a reference, in order for a shared pointer argument to 
         // be turned into a shared pointer to const data.  A shared pointer is castable to a 
         // shared pointer to const data, but they are two different object types, hence the need
         // for a copy constructor (??I think??).
-        void AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter);
-        void AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter);
+        // Also Note: The scene ID must be less than MAX_PARTICLE_SCENES (see 
+        // ParticleScenes.comp).  Particles from different scenes don't interact.
+        // Also Also Note: At most MAX_EMITTERS, point and bar together.  Any more are refused.
+        void AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId = 0);
+        void AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId = 0);
 
+        void SetRandomSeed(unsigned int seed);
         void ResetParticles(unsigned int particlesPerEmitterPerFrame);
 
+        // used if SetRandomSeed(...) is never called
+        static const unsigned int DEFAULT_RANDOM_SEED = 0x5eed;
+
+        // the emitter SSBO has room for this many
+        static const unsigned int MAX_EMITTERS = 64;
+
     private:
+        void BuildResetGraph();
+
+        // picks the program key and the dispatch sizes
+        ComputeShaderVariant _variant;
+
         unsigned int _totalParticleCount;
-        unsigned int _computeProgramIdBarEmitters;
-        unsigned int _computeProgramIdPointEmitters;
+        unsigned int _computeProgramId;
+
+        // the number of emitters changes when emitters are added, so this is set on every reset
+        int _unifLocNumEmitters;
+        int _unifLocParticlesPerEmitterPerFrame;
 
-        // this atomic counter is used to enforce the number of emitted particles per emitter 
-        // per frame 
-        PersistentAtomicCounterBuffer::CONST_SHARED_PTR _particleResetAtomicCounter;
+        // 0 for the reset, or the number of free list indices for the dispatch after it to take
+        int _unifLocNumFreeIndicesToPop;
 
-        // some of these uniforms had to be split into two versions to accomodate both shaders
+        // the reset shader's random numbers are a hash of these plus the emitter and emission 
+        // index (see Random.comp), so the same seed gives the same run every time
+        int _unifLocRandomSeed;
+        int _unifLocFrameNumber;
+        unsigned int _randomSeed;
+        unsigned int _frameNumber;
 
-        // specific to point emitter
-        int _unifLocPointEmitterCenter;
-        int _unifLocPointMaxParticleEmitCount;
-        int _unifLocPointMinParticleVelocity;
-        int _unifLocPointMaxParticleVelocity;
+        // set by ResetParticles(...) for the stages in _resetGraph
+        unsigned int _numEmittersThisReset;
+        unsigned int _particlesPerEmitterThisReset;
+        unsigned int _frameNumberThisReset;
+        unsigned int _numWorkGroupsThisReset;
+        DispatchGraph _resetGraph;
 
-        // specific to bar emitter
-        int _unifLocBarEmitterP1;
-        int _unifLocBarEmitterP2;
-        int _unifLocBarEmitterEmitDir;
-        int _unifLocBarMaxParticleEmitCount;
-        int _unifLocBarMinParticleVelocity;
-        int _unifLocBarMaxParticleVelocity;
+        // every emitter's descriptor, uploaded every frame
+        ParticleEmitterSsbo::SHARED_PTR _emitterSsbo;
+        std::vector<ParticleEmitterDescriptor> _emitterDescriptors;
 
         // all the updating heavy lifting goes on in the compute shader, so CPU cache coherency 
         // is not a concern for emitter storage on the CPU side and a std::vector<...> is 
@@ -78,8 +108,11 @@ namespace ShaderControllers
         // Note: The compute shader has no concept of inheritance.  Rather than store a single 
         // collection of IParticleEmitter pointers and cast them to either point or bar emitters 
         // on every update, just store them separately.
-        static const int MAX_EMITTERS = 4;
         std::vector<ParticleEmitterPoint::CONST_SHARED_PTR> _pointEmitters;
         std::vector<ParticleEmitterBar::CONST_SHARED_PTR> _barEmitters;
+
+        // one per emitter, same order as the emitters
+        std::vector<unsigned int> _pointEmitterSceneIds;
+        std::vector<unsigned int> _barEmitterSceneIds;
     };
 }
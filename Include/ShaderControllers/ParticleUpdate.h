@@ -2,6 +2,8 @@
 
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
 #include "Include/Buffers/PersistentAtomicCounterBuffer.h"
+#include "Include/ShaderControllers/DispatchGraph.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
 
 #include "ThirdParty/glm/vec4.hpp"
 
@@ -13,6 +15,9 @@ namespace ShaderControllers
         (1) Updates particle positions based on their velocity in the previous frame.
         (2) If any particles have gone out of bounds, flag them as inactive.
         (3) Emit as many particles for this frame as each emitter allows.
+        (4) Copies the number of particles that it updated into the particle SSBO's draw 
+        command (see ParticleSsbo::DrawCommandBufferId()) on the GPU.  Inactive particles are 
+        sorted to the back, so after the sort, every active particle is in that range.
 
         There is one compute shader that does this, and this class is built to communicate with 
         and summon that particular shader.
@@ -24,22 +29,38 @@ namespace ShaderControllers
     class ParticleUpdate
     {
     public:
-        ParticleUpdate(const ParticleSsbo::SHARED_PTR &ssboToUpdate);
+        ParticleUpdate(const ParticleSsbo::SHARED_PTR &ssboToUpdate, 
+            const ComputeShaderVariant &variant = ComputeShaderVariant());
         ~ParticleUpdate();
 
+        static void SubmitShaders(const ComputeShaderVariant &variant = ComputeShaderVariant());
+        void ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo);
+
         void Update(float deltaTimeSec);
         unsigned int NumActiveParticles() const;
 
     private:
+        void BuildUpdateGraph();
+
+        // picks the program key and the dispatch sizes
+        ComputeShaderVariant _variant;
+
         unsigned int _totalParticleCount;
         unsigned int _activeParticleCount;
+        unsigned int _drawCommandBufferId;
         unsigned int _computeProgramId;
         
         // these uniforms are specific to this shader
         int _unifLocDeltaTimeSec;
 
+        // set by Update(...) for the stage in _updateGraph
+        float _deltaTimeSecThisUpdate;
+        DispatchGraph _updateGraph;
+
         // the atomic counter is used to count the total number of active particles after this 
         // update
-        PersistentAtomicCounterBuffer::CONST_SHARED_PTR _activeParticlesAtomicCounter;
+        // Note: The readback doesn't wait on the GPU, so the count is from the most recent 
+        // update that the GPU has finished, which is usually a frame or two behind.
+        PersistentAtomicCounterBuffer::SHARED_PTR _activeParticlesAtomicCounter;
     };
 }
@@ -16,6 +16,8 @@ namespace ShaderControllers
         RenderParticles();
         ~RenderParticles();
 
+        static void SubmitShaders();
+
         void ConfigureSsboForRendering(const ParticleSsbo::SHARED_PTR &configureThis);
         void Render(const ParticleSsbo::SHARED_PTR &particleSsboToRender) const;
 
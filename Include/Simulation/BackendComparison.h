@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "Include/Particles/Particle.h"
+#include "Include/Simulation/ThreadPool.h"
+#include "Include/Simulation/CpuRadixSort.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks each of the GPU's stages against the CPU's version of it (see
+    CpuParticleSimulation) and keeps score.  The caller runs one stage on both backends from
+    the same particles, reads both back, and hands them to the matching Compare...(...).  The
+    caller then loads the GPU's particles into the CPU simulation before the next stage (see
+    CpuParticleSimulation::LoadParticles(...)), so a stage is only blamed for its own
+    differences and not for ones that built up before it.
+
+    What is checked:
+    - reset: the number of active particles in each scene, and the new particles (matched up
+    by scene, position, and velocity, so the check doesn't depend on which free slot each one 
+    lands in)
+    - update: which particles are active, and the active ones' positions
+    - sort: the GPU's Morton Codes against the CPU's (MortonCode.h) for the same positions,
+    and the GPU's order against CpuRadixSort's stable order for the GPU's own keys
+    - collide: the active particles' velocities
+    - count nearby: the active particles' counts
+
+    The GPU and CPU don't round exactly the same (the GPU may fuse multiply-adds or use a
+    faster square root), so floats only need to be within FLOAT_TOLERANCE, and a few
+    particles on the edge of something (a Morton cell, the region boundary, another
+    particle's radius) may land on different sides of it.  The checks that can be off like
+    that pass if no more than MAX_MISMATCH_FRACTION of what they checked is off.  The others
+    (the counts per scene and the sort's order) must match exactly.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class BackendComparison
+{
+public:
+    BackendComparison();
+
+    void CompareReset(const std::vector<Particle> &before, const std::vector<Particle> &gpuAfter,
+        const std::vector<Particle> &cpuAfter);
+    void CompareUpdate(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter);
+    void CompareSort(const std::vector<Particle> &before, const std::vector<Particle> &gpuAfter);
+    void CompareCollisions(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter);
+    void CompareNearbyCounts(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter);
+
+    bool Passed() const;
+    void PrintReport() const;
+
+    // relative to the value, or absolute if the value is less than 1
+    static const float FLOAT_TOLERANCE;
+    static const double MAX_MISMATCH_FRACTION;
+
+private:
+    enum Check
+    {
+        CHECK_RESET_ACTIVE_PER_SCENE = 0,
+        CHECK_RESET_NEW_PARTICLES,
+        CHECK_UPDATE_ACTIVE_FLAGS,
+        CHECK_UPDATE_POSITIONS,
+        CHECK_SORT_MORTON_CODES,
+        CHECK_SORT_ORDER,
+        CHECK_COLLIDE_VELOCITIES,
+        CHECK_COUNT_NEARBY,
+        NUM_CHECKS
+    };
+
+    // added up over every call
+    struct CheckTotals
+    {
+        unsigned long long _numChecked;
+        unsigned long long _numMismatches;
+        double _maxError;
+    };
+
+    void Record(Check check, bool matches, double error);
+    bool CheckPassed(Check check) const;
+
+    CheckTotals _checkTotals[NUM_CHECKS];
+
+    // for the sort's reference order
+    ThreadPool _threadPool;
+    CpuRadixSort _radixSort;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU simulation's two simplest and most data-parallel loops, written once in plain
+    C++ and again with SSE4.1 (4 particles at a time) and AVX2 (8 at a time) intrinsics:
+    - UpdateParticles(...): ParticleUpdate.comp's move-and-region-check
+    - MakeSortItems(...): PositionToMortonCode.comp and the sort key from
+    ParticleDataToIntermediateData.comp
+
+    Every version does the same float operations in the same order (no fused multiply-add),
+    so they all give the same bits.  The vector versions hand whatever doesn't fill a whole
+    vector at the end of the range to the scalar version.
+
+    Which one runs is picked at runtime (see BestSimdLevel()), so one build runs on any x86
+    CPU and uses what it has.  Non-x86 builds only have the scalar versions.
+
+    Note: The Morton Code's bit spreading uses shifts and masks instead of BMI2's PDEP.  PDEP
+    does one particle per instruction (and is slow on some AMD CPUs), while the vector shifts
+    do 8.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+namespace CpuParticleKernels
+{
+    enum SimdLevel
+    {
+        SIMD_LEVEL_SCALAR = 0,
+        SIMD_LEVEL_SSE41,
+        SIMD_LEVEL_AVX2,
+        NUM_SIMD_LEVELS
+    };
+
+    // the simulation's particle arrays (see CpuParticleSimulation), one pointer per field
+    struct ParticleFields
+    {
+        float *_positionX;
+        float *_positionY;
+        float *_positionZ;
+        const float *_velocityX;
+        const float *_velocityY;
+        const float *_velocityZ;
+        unsigned int *_numberOfNearbyParticles;
+        unsigned int *_mortonCode;
+        unsigned char *_hasCollidedAlreadyThisFrame;
+        unsigned char *_isActive;
+        const unsigned char *_sceneId;
+    };
+
+    const char *SimdLevelName(SimdLevel level);
+    bool SimdLevelFromName(const std::string &name, SimdLevel &level);
+    bool IsSimdLevelSupported(SimdLevel level);
+    SimdLevel BestSimdLevel();
+
+    unsigned int UpdateParticles(SimdLevel level, const ParticleFields &particles, unsigned int begin,
+        unsigned int end, float deltaTimeSec, std::vector<unsigned int> &freedIndices);
+    unsigned int MakeSortItems(SimdLevel level, const ParticleFields &particles, unsigned int begin,
+        unsigned int end, unsigned long long *sortItems);
+}
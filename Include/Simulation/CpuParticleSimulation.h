@@ -0,0 +1,162 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Include/Simulation/IParticleSimulation.h"
+#include "Include/Simulation/ThreadPool.h"
+#include "Include/Simulation/CpuRadixSort.h"
+#include "Include/Simulation/CpuParticleKernels.h"
+#include "Include/Buffers/ParticleEmitterDescriptor.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The simulation on the CPU.  Each stage does what its compute shader does, in the same
+    order and with the same math, so that the two can be checked against each other and
+    compared for speed:
+    - ResetParticles(...): ParticleReset.comp (same counter-based random numbers, see
+    CounterBasedRandom.h)
+    - Update(...): ParticleUpdate.comp
+    - Sort(): ParticleDataToIntermediateData.comp through SortParticleData.comp (same sort
+    keys, see MortonCode.h, and also a stable radix sort, see CpuRadixSort)
+    - DetectAndResolveCollisions(): ParticleCollisions.comp
+    - CountNearbyParticles(): CountNearbyParticles.comp
+
+    The particles are a structure of arrays instead of an array of Particle structures.  Most
+    stages only use a few of the fields (the collision stage doesn't care about Morton Codes,
+    counting doesn't care about velocity), and with the fields in their own arrays, a stage
+    only pulls the fields that it uses through the cache.
+
+    Every stage is a ThreadPool::ParallelFor(...) over the particles (or particle pairs), the
+    CPU's version of a dispatch, with work stealing to even out stages whose cost depends on
+    where the particles are (see PrintWorkerReport()).  The update and the sort keys also use SSE or AVX2 if the CPU 
+    has them (see CpuParticleKernels).  Where the shader uses atomics (the active particle 
+    counter), each chunk keeps its own results and they are combined in chunk order 
+    afterwards, so the results don't depend on the number of threads or on timing.
+
+    Note: The free list is a plain stack here, with the lowest index on top after a sort, 
+    like the GPU's (see ParticleFreeListBuffer.comp), so new particles land in the same slots 
+    on both.  The update also pushes the particles that went out of bounds, which the GPU 
+    leaves for the next sort, but the sort runs before the next reset anyway.
+
+    Also Note: The W of positions and velocities isn't kept.  The emitters only make points
+    (W = 1) and directions (W = 0), and no stage changes them.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class CpuParticleSimulation : public IParticleSimulation
+{
+public:
+    CpuParticleSimulation(unsigned int numParticles, unsigned int numThreads = 0);
+    virtual ~CpuParticleSimulation() = default;
+
+    const char *BackendName() const override;
+    unsigned int NumThreads() const;
+    bool SetSimdLevel(CpuParticleKernels::SimdLevel level);
+    CpuParticleKernels::SimdLevel GetSimdLevel() const;
+
+    void AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId = 0) override;
+    void AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId = 0) override;
+    void SetRandomSeed(unsigned int seed) override;
+
+    void ResetParticles(unsigned int particlesPerEmitterPerFrame) override;
+    void Update(float deltaTimeSec) override;
+    void Sort() override;
+    void DetectAndResolveCollisions() override;
+    void CountNearbyParticles() override;
+    void Finish() override;
+
+    unsigned int NumActiveParticles() const override;
+    unsigned int NumParticles() const override;
+    bool Resize(unsigned int numParticles) override;
+    void ReadParticles(std::vector<Particle> &particles) override;
+    bool LoadParticles(const std::vector<Particle> &particles);
+    ParticleSsbo::SHARED_PTR ParticlesForRendering() override;
+    void PrintMemoryReport() const override;
+
+    void ResetWorkerStats();
+    void PrintWorkerReport() const;
+
+    // fewer particles than this per chunk isn't worth handing to another thread
+    static const unsigned int MIN_PARTICLES_PER_CHUNK = 4096;
+
+private:
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        One array per Particle field (see Particle.h for what they are).  The flags and the
+        scene ID are bytes because they are small.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    struct ParticleArrays
+    {
+        void Resize(unsigned int numParticles);
+        void CopyParticle(unsigned int fromIndex, ParticleArrays &to, unsigned int toIndex) const;
+        size_t NumBytes() const;
+        CpuParticleKernels::ParticleFields Fields();
+
+        std::vector<float> _positionX;
+        std::vector<float> _positionY;
+        std::vector<float> _positionZ;
+        std::vector<float> _velocityX;
+        std::vector<float> _velocityY;
+        std::vector<float> _velocityZ;
+        std::vector<unsigned int> _numberOfNearbyParticles;
+        std::vector<float> _mass;
+        std::vector<float> _collisionRadius;
+        std::vector<unsigned int> _mortonCode;
+        std::vector<unsigned char> _hasCollidedAlreadyThisFrame;
+        std::vector<unsigned char> _isActive;
+        std::vector<unsigned char> _sceneId;
+    };
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        One emission that ResetParticles(...) has found an inactive particle for.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    struct ParticleClaim
+    {
+        unsigned int _emitterIndex;
+        unsigned int _emissionIndex;
+        unsigned int _particleIndex;
+    };
+
+    void CollideParticlePairs(unsigned int indexOffsetBy0Or1);
+
+    ThreadPool _threadPool;
+
+    // which versions of the update and sort key loops run (see CpuParticleKernels)
+    CpuParticleKernels::SimdLevel _simdLevel;
+    unsigned int _numParticles;
+    ParticleArrays _particles;
+
+    // indices of inactive particles; the top of the stack is the back
+    std::vector<unsigned int> _freeParticleIndices;
+
+    // as of the last update
+    unsigned int _numActiveParticles;
+
+    // per-chunk results, combined in chunk order (see class description)
+    std::vector<unsigned int> _chunkCounts;
+    std::vector<std::vector<unsigned int>> _chunkIndices;
+
+    // the sort's keys (in the top 32 bits) and the particles' indices (in the bottom 32 bits)
+    std::vector<unsigned long long> _sortItems;
+    CpuRadixSort _radixSort;
+
+    // the sort gathers into this and then swaps it with _particles
+    ParticleArrays _sortedParticles;
+
+    // same as ParticleReset
+    unsigned int _randomSeed;
+    unsigned int _frameNumber;
+    std::vector<ParticleEmitterPoint::CONST_SHARED_PTR> _pointEmitters;
+    std::vector<ParticleEmitterBar::CONST_SHARED_PTR> _barEmitters;
+    std::vector<unsigned int> _pointEmitterSceneIds;
+    std::vector<unsigned int> _barEmitterSceneIds;
+    std::vector<ParticleEmitterDescriptor> _emitterDescriptors;
+    std::vector<ParticleClaim> _particleClaims;
+
+    // only made if ParticlesForRendering() is called
+    ParticleSsbo::SHARED_PTR _renderSsbo;
+    std::vector<ParticleRenderVertex> _renderVertices;
+};
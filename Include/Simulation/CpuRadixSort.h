@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "Include/Simulation/ThreadPool.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU's version of ParallelSort: a least-significant-digit radix sort of 32-bit keys
+    that carry a 32-bit index along with them.  Like the GPU's sort, it is stable, so items
+    with equal keys stay in index order.
+
+    An item is packed into a 64-bit integer with the key in the top 32 bits and the index in
+    the bottom 32 bits (the same thing that CpuParticleSimulation::Sort() makes), so moving
+    an item moves its index too and the sorted items are the permutation.  Use
+    SortToPermutation(...) to start from plain keys.
+
+    Each pass sorts on one 8-bit digit of the key, lowest digit first, in three steps:
+    (1) Every chunk of ThreadPool::ParallelFor(...) counts its own digits (one histogram per
+    chunk, so no atomics).
+    (2) The histograms are turned into where each chunk writes each digit: every chunk's 0s,
+    then every chunk's 1s, etc., in chunk order, which is what makes the sort stable.
+    (3) Every chunk scatters its items to those places.  The items for each digit are
+    gathered into a one-cache-line buffer first and written a whole line at a time
+    ("software write combining"), so the 256 scattered write streams don't each take a cache
+    miss per item.
+
+    A pass where every key has the same digit (ex: the top digit when all the keys are
+    small) wouldn't move anything, so it is skipped after step (1).
+
+    Note: 8-bit digits instead of 11 so that one chunk's 256 write-combining buffers (16KB)
+    fit in the L1 cache.  11-bit digits would take 3 passes instead of 4, but their 2048
+    buffers (128KB) would push every scatter out to L2.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class CpuRadixSort
+{
+public:
+    CpuRadixSort(ThreadPool &threadPool);
+
+    void Sort(std::vector<unsigned long long> &keysAndIndices);
+    void SortToPermutation(const std::vector<unsigned int> &keys, std::vector<unsigned int> &permutation);
+    size_t NumScratchBytes() const;
+
+    static const unsigned int BITS_PER_DIGIT = 8;
+    static const unsigned int NUM_DIGIT_VALUES = 1 << BITS_PER_DIGIT;
+    static const unsigned int NUM_PASSES = 32 / BITS_PER_DIGIT;
+
+    // 64 bytes, one cache line
+    static const unsigned int ITEMS_PER_WRITE_COMBINING_BUFFER = 8;
+
+    // a chunk's histogram and buffers aren't worth setting up for fewer items than this
+    static const unsigned int MIN_ITEMS_PER_CHUNK = 16384;
+
+private:
+    bool SortOnDigit(const std::vector<unsigned long long> &from, std::vector<unsigned long long> &to,
+        unsigned int digitShift);
+
+    ThreadPool &_threadPool;
+
+    // every pass goes from one of these to the other
+    std::vector<unsigned long long> _scratchItems;
+
+    // NUM_DIGIT_VALUES per chunk; the counts, and then where each digit goes
+    std::vector<unsigned int> _chunkDigitOffsets;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "Include/Simulation/IParticleSimulation.h"
+#include "Include/Buffers/SSBOs/ParticleSsbo.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
+#include "Include/ShaderControllers/ParticleReset.h"
+#include "Include/ShaderControllers/ParticleUpdate.h"
+#include "Include/ShaderControllers/ParallelSort.h"
+#include "Include/ShaderControllers/ParticleCollide.h"
+#include "Include/ShaderControllers/CountNearbyParticles.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The simulation as it has always been: the particles live in a ParticleSsbo and each stage
+    is one of the compute shader controllers.  This class only owns them and forwards to them,
+    so that the caller can treat it like CpuParticleSimulation.
+
+    Note: The stages only issue commands, so they return before the GPU is done.  Use Finish()
+    (or GpuStopwatch) to know when it is.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class GpuParticleSimulation : public IParticleSimulation
+{
+public:
+    GpuParticleSimulation(unsigned int numParticles,
+        const ShaderControllers::ComputeShaderVariant &variant = ShaderControllers::ComputeShaderVariant());
+    virtual ~GpuParticleSimulation() = default;
+
+    static void SubmitShaders(const ShaderControllers::ComputeShaderVariant &variant = ShaderControllers::ComputeShaderVariant());
+
+    const char *BackendName() const override;
+
+    void AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId = 0) override;
+    void AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId = 0) override;
+    void SetRandomSeed(unsigned int seed) override;
+
+    void ResetParticles(unsigned int particlesPerEmitterPerFrame) override;
+    void Update(float deltaTimeSec) override;
+    void Sort() override;
+    void DetectAndResolveCollisions() override;
+    void CountNearbyParticles() override;
+    void Finish() override;
+
+    unsigned int NumActiveParticles() const override;
+    unsigned int NumParticles() const override;
+    bool Resize(unsigned int numParticles) override;
+    void ReadParticles(std::vector<Particle> &particles) override;
+    ParticleSsbo::SHARED_PTR ParticlesForRendering() override;
+    void PrintMemoryReport() const override;
+
+private:
+    ParticleSsbo::SHARED_PTR _particleBuffer;
+    std::unique_ptr<ShaderControllers::ParticleReset> _particleResetter;
+    std::unique_ptr<ShaderControllers::ParticleUpdate> _particleUpdater;
+    std::unique_ptr<ShaderControllers::ParallelSort> _parallelSort;
+    std::unique_ptr<ShaderControllers::ParticleCollide> _particleCollisions;
+    std::unique_ptr<ShaderControllers::CountNearbyParticles> _nearbyParticleCounter;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Include/Particles/Particle.h"
+#include "Include/Particles/ParticleEmitterPoint.h"
+#include "Include/Particles/ParticleEmitterBar.h"
+#include "Include/Buffers/SSBOs/ParticleSsbo.h"
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The whole particle pipeline (reset, update, sort, collide, count nearby) behind one
+    interface so that main.cpp and the headless runner can pick where it runs at startup.
+    GpuParticleSimulation runs it with the compute shader controllers, and
+    CpuParticleSimulation runs the same steps on a pool of CPU threads.
+
+    Each stage is its own call so that the caller decides the order and how often each one
+    runs (main.cpp doesn't sort every step, see UpdateAllTheThings()), and so that the
+    headless runner can time them one at a time.
+
+    Given the same emitters, random seed, and sequence of calls, the two backends produce the
+    same particles, give or take floating point differences between the GPU and CPU and the
+    order of particles whose sort keys are equal.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class IParticleSimulation
+{
+public:
+    virtual ~IParticleSimulation() {}
+    using UNIQUE_PTR = std::unique_ptr<IParticleSimulation>;
+
+    // "GPU" or "CPU"
+    virtual const char *BackendName() const = 0;
+
+    // see ParticleReset
+    virtual void AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId = 0) = 0;
+    virtual void AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId = 0) = 0;
+    virtual void SetRandomSeed(unsigned int seed) = 0;
+
+    // the pipeline, in the order that it usually runs
+    virtual void ResetParticles(unsigned int particlesPerEmitterPerFrame) = 0;
+    virtual void Update(float deltaTimeSec) = 0;
+    virtual void Sort() = 0;
+    virtual void DetectAndResolveCollisions() = 0;
+    virtual void CountNearbyParticles() = 0;
+
+    // returns when everything that has been asked for is done
+    virtual void Finish() = 0;
+
+    // as of the last Update(...)
+    virtual unsigned int NumActiveParticles() const = 0;
+
+    virtual unsigned int NumParticles() const = 0;
+    virtual bool Resize(unsigned int numParticles) = 0;
+
+    // for checking the results
+    virtual void ReadParticles(std::vector<Particle> &particles) = 0;
+
+    // what RenderParticles draws; the CPU backend copies its particles into it first
+    virtual ParticleSsbo::SHARED_PTR ParticlesForRendering() = 0;
+
+    virtual void PrintMemoryReport() const = 0;
+};
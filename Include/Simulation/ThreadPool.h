@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A fixed set of worker threads for the CPU simulation's data-parallel loops.  This is the
+    CPU's version of a compute dispatch: ParallelFor(...) cuts [0, numItems) into chunks,
+    hands them out to the workers and to the calling thread, and returns when all of them are
+    done.
+
+    The chunk boundaries only depend on the number of items, the minimum chunk size, and the
+    number of threads, and the chunk index is passed to the loop body, so a loop can write
+    per-chunk results (counts, lists of indices, etc.) and combine them in chunk order
+    afterwards.  That keeps the results the same from run to run no matter which thread
+    happened to get which chunk.
+
+    The chunks are handed out by work stealing.  Every thread has its own deque of chunk
+    ranges and starts the loop with an equal share of the chunks in it.  A thread takes the
+    range at the back of its own deque and splits it in half, pushing the back half onto its
+    deque, until only one chunk is left, and runs that.  So a thread works through its own
+    share front to back, and the big halves that it hasn't gotten to yet pile up at the front
+    of its deque.  A thread whose deque is empty steals from the front of another thread's, so
+    it gets the biggest piece of work that the other thread has left.  Collisions and nearby
+    counts cost much more where the particles bunch up than where there are none, so an equal
+    split of the particles isn't an equal split of the work, and the threads that finish their
+    share early take work from the ones that got the dense parts.
+
+    Each thread counts how long it spent in the loop body, how many chunks it ran, and how many
+    ranges it stole (see GetWorkerStats(...)), so how well the work was balanced can be
+    checked.
+
+    Note: The deques are locked with a mutex apiece instead of being lock-free.  A thread
+    only touches its own deque once per chunk, and a chunk is thousands of particles, so the
+    lock is never the bottleneck.
+
+    Also Note: One loop at a time.  ParallelFor(...) must not be called from inside a loop
+    body.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+class ThreadPool
+{
+public:
+    // chunkIndex, begin, end
+    using LOOP_BODY = std::function<void(unsigned int, unsigned int, unsigned int)>;
+
+    ThreadPool(unsigned int numThreads = 0);
+    ~ThreadPool();
+
+    // more chunks than threads so that there is something left to steal
+    static const unsigned int CHUNKS_PER_THREAD = 16;
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        What one thread did over every loop since the last ResetStats().  Times are in
+        seconds.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    struct WorkerStats
+    {
+        double _busyTime;
+        unsigned long long _numChunksRun;
+        unsigned long long _numSteals;
+    };
+
+    unsigned int NumThreads() const;
+    unsigned int NumChunks(unsigned int numItems, unsigned int minItemsPerChunk) const;
+    void ParallelFor(unsigned int numItems, unsigned int minItemsPerChunk, const LOOP_BODY &loopBody);
+
+    // thread 0 is the one that calls ParallelFor(...)
+    WorkerStats GetWorkerStats(unsigned int threadIndex) const;
+    double TotalLoopTime() const;
+    void ResetStats();
+
+private:
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // [begin, end) of chunk indices
+    struct ChunkRange
+    {
+        unsigned int _begin;
+        unsigned int _end;
+    };
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        One thread's chunk ranges, plus its stats.  The owner pushes and pops at the back, and
+        thieves take from the front.  Only the owner writes the stats.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    struct WorkerQueue
+    {
+        std::mutex _mutex;
+        std::deque<ChunkRange> _ranges;
+        WorkerStats _stats;
+    };
+
+    void WorkerLoop(unsigned int threadIndex);
+    void RunChunks(unsigned int threadIndex);
+    bool PopOwnRange(unsigned int threadIndex, ChunkRange &range);
+    bool StealRange(unsigned int threadIndex, ChunkRange &range);
+    void PushOwnRange(unsigned int threadIndex, const ChunkRange &range);
+
+    // the caller of ParallelFor(...) is one of them
+    unsigned int _numThreads;
+    std::vector<std::thread> _workers;
+
+    // one per thread, including the caller's (index 0)
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+    // the current loop, set by ParallelFor(...) under _mutex
+    const LOOP_BODY *_loopBody;
+    unsigned int _loopNumItems;
+    unsigned int _loopNumChunks;
+    std::atomic<unsigned int> _numChunksLeft;
+
+    // the workers sleep until the generation changes
+    std::mutex _mutex;
+    std::condition_variable _loopStarted;
+    std::condition_variable _loopFinished;
+    unsigned int _loopGeneration;
+    unsigned int _numWorkersBusy;
+    bool _shuttingDown;
+
+    // wall time inside ParallelFor(...) since the last ResetStats()
+    double _totalLoopTime;
+};
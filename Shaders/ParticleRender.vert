@@ -1,25 +1,24 @@
-// REQUIRES Versoin.comp
-// REQUIRES CountNearbyParticlesLimits.comp
+#include "Shaders/ComputeHeaders/Version.comp"
+#include "Shaders/CountNearbyParticlesLimits.comp"
+#include "Shaders/ParticleRenderVertex.comp"
 
 // Note: The vec2's are in window space (both X and Y on the range [-1,+1])
-// Also Note: The vec2s are provided as vec4s on the CPU side and specified as such in the 
-// vertex array attributes, but it is ok to only take them as a vec2, as I am doing for this 
-// 2D demo.
-layout (location = 0) in vec4 pos;  
-layout (location = 1) in vec4 vel;  
-layout (location = 2) in uint numberOfNearbyParticles;
-layout (location = 3) in float mass;
-layout (location = 4) in float collisionRadius;
-layout (location = 5) in uint mortonCode;
-layout (location = 6) in uint hasCollidedAlreadyThisFrame;
-layout (location = 7) in int isActive;
+// Also Note: These come from the render vertices (see ParticleRenderBuffer.comp), not from the 
+// particles themselves.  This used to take every field of Particle as an attribute, but only 
+// the position, the nearby count, and the "is active" flag were ever used, and the flag and 
+// the count are both in the color index now.
+layout (location = 0) in vec2 pos;  
+layout (location = 1) in uint colorIndex;
 
 // must have the same name as its corresponding "in" item in the frag shader
 smooth out vec4 particleColor;
 
 void main()
 {
-    if (isActive == 0)
+    // Note: Only the sorted, active front of the buffer is drawn (see 
+    // RenderParticles::Render(...)), but the count comes from before the update's bounds 
+    // check, so a few particles at the end of the range may have just gone inactive.
+    if (colorIndex == uint(PARTICLE_RENDER_INACTIVE_COLOR_INDEX))
     {
         // invisible (alpha = 0), but "fully transparent" does not mean "no color", it merely 
         // means that the color of this thing will be added to the thing behind it (see Z 
@@ -57,7 +56,7 @@ void main()
         //float mid = NUM_PARTICLES_TO_CHECK_ON_EACH_SIDE;
         //float max = NUM_PARTICLES_TO_CHECK_ON_EACH_SIDE * 2;
         //
-        //float blendValue = float(numberOfNearbyParticles);
+        //float blendValue = float(colorIndex);
         //float fractionLowToMid = (blendValue - min) / (mid - min);
         //fractionLowToMid = clamp(fractionLowToMid, 0.0f, 1.0f);
         //
@@ -4,9 +4,63 @@
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 // for making program from shader collection
+#include <stdio.h>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <string.h>
+#include <set>
+
+// for making the program binary cache directory
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+// first thing in every program binary cache file ("PBIN"), followed by the version of the file 
+// layout
+static const unsigned int PROGRAM_CACHE_FILE_MAGIC = 0x4e494250;
+static const unsigned int PROGRAM_CACHE_FILE_VERSION = 1;
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The header at the start of every program binary cache file.  The binary itself follows.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+struct ProgramCacheFileHeader
+{
+    unsigned int _magic;
+    unsigned int _fileVersion;
+    unsigned long long _sourceHash;
+    unsigned int _binaryFormat;
+    unsigned int _binaryLengthBytes;
+};
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    64bit FNV-1a.  Not cryptographic, but the cache only needs to tell programs apart, and it 
+    also checks the hash that was stored in the file.
+Parameters:
+    hash    The hash so far.  Start with FNV_OFFSET_BASIS.
+    bytes   Self-explanatory.
+    numBytes    Self-explanatory.
+Returns:
+    The hash with the bytes folded in.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static unsigned long long Fnv1aHash(unsigned long long hash, const void *bytes, size_t numBytes)
+{
+    const unsigned char *byteArr = static_cast<const unsigned char *>(bytes);
+    for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+    {
+        hash ^= byteArr[byteIndex];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
 
 /*------------------------------------------------------------------------------------------------
@@ -29,9 +83,11 @@ Parameters: None
 Returns:    None
 Creator:    John Cox (7-14-2016)
 ------------------------------------------------------------------------------------------------*/
-ShaderStorage::ShaderStorage()
+ShaderStorage::ShaderStorage() :
+    _numShaderFileReads(0),
+    _numProgramCacheHits(0),
+    _numProgramCacheMisses(0)
 {
-    //??anything??
 }
 
 /*------------------------------------------------------------------------------------------------
@@ -54,6 +110,14 @@ ShaderStorage::~ShaderStorage()
         }
     }
 
+    for (_PENDING_MAP::iterator itr = _pendingPrograms.begin(); itr != _pendingPrograms.end(); itr++)
+    {
+        for (size_t shaderIndex = 0; shaderIndex < itr->second._shaderIds.size(); shaderIndex++)
+        {
+            glDeleteShader(itr->second._shaderIds[shaderIndex]);
+        }
+    }
+
     for (_PROGRAM_MAP::iterator itr = _compiledPrograms.begin(); itr != _compiledPrograms.end(); itr++)
     {
         glDeleteProgram(itr->second);
@@ -122,8 +186,8 @@ Description:
     This is a manual cleanup method.  If not called, everything will be cleaned up properly in 
     the destructor.
     
-    Failure to find something for the program key does not print an error or abort, but finding 
-    and deleting an entry will print a note.
+    Failure to find something for the program key does not print an error or abort.  Nothing is 
+    printed either way because the shader controllers call this from their destructors.
 Parameters:
     programKey  Delete the compiled shader program associated with this string.
 Returns:    None
@@ -136,7 +200,15 @@ void ShaderStorage::DeleteShader(const std::string &programKey)
     {
         // just a std::string, so no OpenGL function calls necessary
         _partialShaderContents.erase(shaderItr);
-        fprintf(stdout, "Deleting shader contents for program key '%s'\n", programKey.c_str());
+    }
+
+    _includedShaderFiles.erase(programKey);
+    _shaderDefines.erase(programKey);
+
+    _SOURCE_MAP::iterator sourceItr = _shaderSources.find(programKey);
+    if (sourceItr != _shaderSources.end())
+    {
+        _shaderSources.erase(sourceItr);
     }
 
     _BINARY_MAP::iterator binariesItr = _shaderBinaries.find(programKey);
@@ -149,7 +221,17 @@ void ShaderStorage::DeleteShader(const std::string &programKey)
         }
 
         _shaderBinaries.erase(binariesItr);
-        fprintf(stdout, "Deleting compiled binaries for program key '%s'\n", programKey.c_str());
+    }
+
+    _PENDING_MAP::iterator pendingItr = _pendingPrograms.find(programKey);
+    if (pendingItr != _pendingPrograms.end())
+    {
+        // never resolved, so the shader objects are still around
+        for (size_t shaderIndex = 0; shaderIndex < pendingItr->second._shaderIds.size(); shaderIndex++)
+        {
+            glDeleteShader(pendingItr->second._shaderIds[shaderIndex]);
+        }
+        _pendingPrograms.erase(pendingItr);
     }
 
     _PROGRAM_MAP::iterator programItr = _compiledPrograms.find(programKey);
@@ -157,13 +239,14 @@ void ShaderStorage::DeleteShader(const std::string &programKey)
     {
         glDeleteProgram(programItr->second);
         _compiledPrograms.erase(programItr);
-        fprintf(stdout, "Deleting linked program from program key '%s'\n", programKey.c_str());
     }
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Reads the file contents and attempts to compile a shader binary.
+    Reads the file contents (resolving #include's, see AppendShaderFile(...)) and holds on to 
+    them until LinkShader(...), which compiles them (unless the whole program is in the program 
+    binary cache).
 
     Prints its own errors to stderr.  The APIENTRY debug function doesn't report shader compile
     errors.
@@ -183,45 +266,29 @@ void ShaderStorage::AddAndCompileShaderFile(const std::string &programKey, const
         return;
     }
 
-    std::ifstream shaderFile(filePath);
-    if (!shaderFile.is_open())
+    // a whole shader on its own, so it gets its own set of #include'd files
+    std::set<std::string> includedFiles;
+    std::string fileContents;
+    if (!AppendShaderFile(filePath, includedFiles, fileContents))
     {
-        fprintf(stderr, "Cannot open shader file '%s'\n", filePath.c_str());
         return;
     }
 
-    std::stringstream shaderData;
-    shaderData << shaderFile.rdbuf();
-    shaderFile.close();
-    std::string fileContents = shaderData.str();
-
-    if (fileContents.empty())
-    {
-        fprintf(stderr, "Shader file '%s' is empty\n", filePath.c_str());
-        return;
-    }
-
-    GLuint shaderId = CompileShader(fileContents, shaderType);
-    if (shaderId == 0)
-    {
-        fprintf(stderr, "Problem compiling shader for program key '%s'\n", programKey.c_str());
-        return;
-    }
-    
-    // compilation went fine
-    // Note: The [] notation on a map will automatically add the key-value pair if it 
-    // doesn't exist, but the iterator search at function start will protect against errant 
-    // inserations, so this notation is ok.
-    _shaderBinaries[programKey].push_back(shaderId);
+    // compiled in LinkShader(...) (see the Note on _shaderSources)
+    _shaderSources[programKey].push_back({ shaderType, InjectShaderDefines(programKey, fileContents) });
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
     Attempts to add the contents of the specified file to an intermediate string under the 
-    provided program key.  No compilation is performed.  It is up to the user to make sure that 
-    file contents are added in the correct order.  This option allows for piecing together files, 
-    which can cause confusion because shader compiler errors will be spit out with line numbers 
-    for the composite file contents, not for any one particular file.  So be careful.
+    provided program key.  No compilation is performed.  This option allows for piecing together 
+    files, which can cause confusion because shader compiler errors will be spit out with line 
+    numbers for the composite file contents, not for any one particular file.  So be careful.
+
+    The file's '#include "path"' lines are replaced by those files (see AppendShaderFile(...)), 
+    so a shader file that #include's what it needs can be added on its own.  Files that are 
+    already in the composite shader are skipped, and files are only read from disk once (see 
+    ReadShaderFile(...)).
 
     Prints its own errors to stderr.  The APIENTRY debug function doesn't report shader compile
     errors.
@@ -234,47 +301,26 @@ Creator:    John Cox, 3/11/2107
 ------------------------------------------------------------------------------------------------*/
 void ShaderStorage::AddPartialShaderFile(const std::string &programKey, const std::string &filePath)
 {
-    if (_partialShaderContents.find(programKey) == _partialShaderContents.end())
+    _COMPOSITE_SHADER_MAP::iterator itr = _partialShaderContents.find(programKey);
+    if (itr == _partialShaderContents.end())
     {
         fprintf(stderr, "Could not add shader file '%s'.  No program key '%s'\n",
             filePath.c_str(), programKey.c_str());
         return;
     }
 
-    std::ifstream shaderFile(filePath);
-    if (!shaderFile.is_open())
-    {
-        fprintf(stderr, "Cannot open shader file '%s'\n", filePath.c_str());
-        return;
-    }
-
-    std::stringstream shaderData;
-    shaderData << shaderFile.rdbuf();
-    shaderFile.close();
-    std::string fileContents = shaderData.str();
-
-    if (fileContents.empty())
-    {
-        fprintf(stderr, "Shader file '%s' is empty\n", filePath.c_str());
-        return;
-    }
-
-    // add a new line just to make sure that there is a clear distinction between any possible 
-    // prior file contents and the current file
-    _partialShaderContents[programKey] += ("\n" + fileContents);
+    AppendShaderFile(filePath, _includedShaderFiles[programKey], itr->second);
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Attempts to read the shader file text under the provided program key and compile it into the 
-    specified shader type.  Stores the resulting binary in a collection of binaries under the 
-    same program key.  The shader file's contents remain and are not deleted until program end 
-    unless manually deleted by calling DeleteShader(...).
+    Takes the shader file text under the provided program key as the source for the specified 
+    shader type.  The source is compiled in LinkShader(...), along with any other shaders under 
+    the same program key, unless the whole program is found in the program binary cache.
 
-    If successful, the composite shader contents that have been gathered under this programKey 
-    are deleted.  If there is an error in the compilation, the contents are untouched.  This 
-    is so that multiple composite shaders (ex: vertex and fragment) can be assembled and 
-    compiled under the same program key.
+    The composite shader contents that have been gathered under this programKey are then 
+    cleared so that multiple composite shaders (ex: vertex and fragment) can be assembled under 
+    the same program key.
 
     Prints its own errors to stderr.The APIENTRY debug function doesn't report shader compile
     errors.
@@ -300,83 +346,288 @@ void ShaderStorage::CompileCompositeShader(const std::string &programKey, const
         return;
     }
 
-    GLuint shaderId = CompileShader(fileContents, shaderType);
-    if (shaderId == 0)
+    // compiled in LinkShader(...) (see the Note on _shaderSources)
+    _shaderSources[programKey].push_back({ shaderType, InjectShaderDefines(programKey, fileContents) });
+
+    // now clean up after it
+    // Note: The next composite shader under this key is a separate shader, so it needs its own 
+    // copy of any file that this one #include'd.
+    itr->second.clear();
+    _includedShaderFiles.erase(programKey);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds "#define name value" to every shader under the program key that is compiled after this 
+    call (CompileCompositeShader(...) or AddAndCompileShaderFile(...)).  The defines go right 
+    after the #version line, so they come before anything in the shader files.
+
+    This is how variants of a shader (different work group sizes, a feature turned on or off) 
+    are made without copying the shader files.  Different defines make different source, so 
+    each variant gets its own entry in the program binary cache.
+
+    The defines are forgotten once the program is linked.
+Parameters:
+    programKey  Must have already been created by NewShader(...) or NewCompositeShader(...).
+    name        The macro name.
+    value       Anything that is valid after the name in a #define.  Can be empty.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ShaderStorage::AddShaderDefine(const std::string &programKey, const std::string &name, 
+    const std::string &value)
+{
+    if (_partialShaderContents.find(programKey) == _partialShaderContents.end() &&
+        _shaderBinaries.find(programKey) == _shaderBinaries.end())
     {
-        fprintf(stderr, "Problem compiling shader for program key '%s'\n", programKey.c_str());
+        fprintf(stderr, "Could not add define '%s'.  No program key '%s'\n", name.c_str(), 
+            programKey.c_str());
         return;
     }
 
-    // compilation went fine
-    _shaderBinaries[programKey].push_back(shaderId);
-
-    // now clean up after it
-    itr->second.clear();
+    _shaderDefines[programKey] += ("#define " + name + " " + value + "\n");
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Links the collection of binaries under the specified key into a compiled program, deletes 
-    the shader binaries (no longer needed), adds the compiled program to the internal collection 
-    of compiled shader programs, and returns the shader ID.
+    Turns the shader sources under the specified key into a linked program, adds it to the 
+    internal collection of compiled shader programs, and returns the shader ID.
+
+    If the program binary cache is in use (see UseProgramBinaryCache(...)) and it has a binary 
+    for this exact source on this exact driver, the binary is loaded and nothing is compiled.  
+    Otherwise the sources are submitted for compiling and linking and this returns without 
+    waiting for them.  The results are checked (and the program cached for next time) the first 
+    time that GetShaderProgram(...), GetUniformLocation(...), or GetAttributeLocation(...) asks 
+    for the program, or by FinishPendingPrograms().
 
     Prints its own errors to stderr.  The APIENTRY debug function doesn't report shader link
     errors.
 Parameters:
     programKey  Must have already been created by NewShader(...).
 Returns:
-    The ID of the resultant program, or 0 if no program was compiled (hopefully 0 is still an
-    invalid value in the future.
+    The ID of the resultant program, or 0 if there was nothing to compile (hopefully 0 is still 
+    an invalid value in the future).  A program that later fails to compile or link is deleted, 
+    so use GetShaderProgram(...) rather than holding on to this.
 Creator:    John Cox (7-14-2016)
 ------------------------------------------------------------------------------------------------*/
 GLuint ShaderStorage::LinkShader(const std::string &programKey)
 {
-    _BINARY_MAP::iterator itr = _shaderBinaries.find(programKey);
-    if (itr == _shaderBinaries.end() ||
-        itr->second.empty())
+    _SOURCE_MAP::iterator sourceItr = _shaderSources.find(programKey);
+    if (sourceItr == _shaderSources.end() ||
+        sourceItr->second.empty())
     {
-        fprintf(stderr, "No shader binaries under the key '%s'\n", programKey.c_str());
+        fprintf(stderr, "No shader sources under the key '%s'\n", programKey.c_str());
         return 0;
     }
 
-    GLuint programId = glCreateProgram();
+    GLuint programId = 0;
+    unsigned long long sourceHash = 0;
+    if (!_programCacheDirectory.empty())
+    {
+        sourceHash = HashProgramSources(sourceItr->second);
+        programId = LoadCachedProgram(programKey, sourceHash);
+    }
+
+    if (programId != 0)
+    {
+        _numProgramCacheHits++;
+    }
+    else
+    {
+        PendingProgram pending = SubmitProgram(sourceItr->second);
+        pending._sourceHash = sourceHash;
+        programId = pending._programId;
+        _pendingPrograms[programKey] = pending;
+    }
+
+    // the sources (and the defines that went into them) are no longer needed either way
+    _shaderSources.erase(sourceItr);
+    _shaderDefines.erase(programKey);
+
+    _compiledPrograms[programKey] = programId;
+    return programId;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Hands every shader source to the driver for compiling, attaches them to a new program, and 
+    asks for the link.  Nothing is checked, so nothing waits; drivers that compile on other 
+    threads (GL_KHR_parallel_shader_compile or just driver-side async behaviour) keep working 
+    on it while the caller submits more programs.  ResolvePendingProgram(...) checks the 
+    results later.
+Parameters:
+    sources     Every shader in the program, in the order that they were added.
+Returns:
+    The program and its shaders.  The shaders are kept until the program is resolved in case 
+    their info logs are needed.
+Creator:    John Cox (7-14-2016) (split out of LinkShader(...) by agent, 10/2026)
+------------------------------------------------------------------------------------------------*/
+ShaderStorage::PendingProgram ShaderStorage::SubmitProgram(const _SHADER_SOURCES &sources)
+{
+    PendingProgram pending;
+    pending._programId = glCreateProgram();
+    pending._sourceHash = 0;
+    if (!_programCacheDirectory.empty())
+    {
+        // otherwise the driver may not keep the binary around for glGetProgramBinary(...)
+        glProgramParameteri(pending._programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
-    // the collection of shader binaries is the second item in the map's string-binary pairs
-    // Note: In many cases, there will only be two items: a vertex and fragment shader.
-    for (size_t shaderIndex = 0; shaderIndex < itr->second.size(); shaderIndex++)
+    for (size_t sourceIndex = 0; sourceIndex < sources.size(); sourceIndex++)
     {
-        glAttachShader(programId, itr->second[shaderIndex]);
+        GLuint shaderId = CompileShader(sources[sourceIndex].second, sources[sourceIndex].first);
+        if (shaderId == 0)
+        {
+            // empty source; the link will fail and say so
+            continue;
+        }
+        glAttachShader(pending._programId, shaderId);
+        pending._shaderIds.push_back(shaderId);
+    }
+    glLinkProgram(pending._programId);
+
+    return pending;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    If the program under the key was submitted but never checked, this waits for it to finish 
+    (if it hasn't already), reports any compile or link errors, and deletes the shader objects 
+    (no longer needed).  A program that failed is deleted and forgotten, so GetShaderProgram(...) 
+    will return 0 for it.  A program that worked goes into the program binary cache (if that's 
+    being used).
+
+    Does nothing if the program isn't pending.
+
+    Prints its own errors to stderr.  The APIENTRY debug function doesn't report shader compile 
+    or link errors.
+Parameters:
+    programKey  Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ShaderStorage::ResolvePendingProgram(const std::string &programKey)
+{
+    _PENDING_MAP::iterator pendingItr = _pendingPrograms.find(programKey);
+    if (pendingItr == _pendingPrograms.end())
+    {
+        return;
+    }
+
+    PendingProgram pending = pendingItr->second;
+    _pendingPrograms.erase(pendingItr);
+
+    // only look at the shaders if the link failed; asking is cheap at that point
+    GLint isLinked = 0;
+    glGetProgramiv(pending._programId, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE)
+    {
+        for (size_t shaderIndex = 0; shaderIndex < pending._shaderIds.size(); shaderIndex++)
+        {
+            GLint isCompiled = 0;
+            glGetShaderiv(pending._shaderIds[shaderIndex], GL_COMPILE_STATUS, &isCompiled);
+            if (isCompiled == GL_FALSE)
+            {
+                GLchar errLog[128];
+                GLsizei *logLen = 0;
+                glGetShaderInfoLog(pending._shaderIds[shaderIndex], 128, logLen, errLog);
+                fprintf(stderr, "shader failed: '%s'\n", errLog);
+                fprintf(stderr, "Problem compiling shader for program key '%s'\n", programKey.c_str());
+            }
+        }
+
+        GLchar errLog[128];
+        GLsizei *logLen = 0;
+        glGetProgramInfoLog(pending._programId, 128, logLen, errLog);
+        fprintf(stderr, "Program '%s' didn't link: '%s'\n", programKey.c_str(), errLog);
     }
-    glLinkProgram(programId);
 
     // the program contains linked versions of the shaders, so the compiled binary objects 
     // are no longer necessary
     // Note: Shader objects need to be un-linked before they can be deleted.  This is ok 
     // because the program safely contains the shaders in binary form.
-    for (size_t shaderIndex = 0; shaderIndex < itr->second.size(); shaderIndex++)
+    for (size_t shaderIndex = 0; shaderIndex < pending._shaderIds.size(); shaderIndex++)
     {
-        GLuint shaderId = itr->second[shaderIndex];
-        glDetachShader(programId, shaderId);
+        GLuint shaderId = pending._shaderIds[shaderIndex];
+        glDetachShader(pending._programId, shaderId);
         glDeleteShader(shaderId);
     }
 
-    // check if the program was built ok
-    // Note: Perform this check after the shader objects were already cleaned up.  It makes
-    // the program cleanup easier.
-    GLint isLinked = 0;
-    glGetProgramiv(programId, GL_LINK_STATUS, &isLinked);
     if (isLinked == GL_FALSE)
     {
-        GLchar errLog[128];
-        GLsizei *logLen = 0;
-        glGetProgramInfoLog(programId, 128, logLen, errLog);
-        fprintf(stderr, "Program '%s' didn't link: '%s'\n", programKey.c_str(), errLog);
-        glDeleteProgram(programId);
-        return 0;
+        glDeleteProgram(pending._programId);
+        _compiledPrograms.erase(programKey);
+        return;
     }
 
-    _compiledPrograms[programKey] = programId;
-    return programId;
+    if (!_programCacheDirectory.empty())
+    {
+        _numProgramCacheMisses++;
+        SaveCachedProgram(programKey, pending._programId, pending._sourceHash);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Resolves every program that is still pending (see ResolvePendingProgram(...)).  Handy 
+    after a batch of submissions to get all the errors out at once, or to time how long the 
+    driver actually took.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ShaderStorage::FinishPendingPrograms()
+{
+    while (!_pendingPrograms.empty())
+    {
+        // copy the key; resolving erases the entry
+        std::string programKey = _pendingPrograms.begin()->first;
+        ResolvePendingProgram(programKey);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Lets the shader controllers submit their programs once, up front, and then look them up in 
+    their constructors.  A program counts as existing once it has been linked (even if the link 
+    hasn't been checked yet) until DeleteShader(...) is called for it.
+Parameters:
+    programKey  Self-explanatory.
+Returns:
+    True if LinkShader(...) was called for the key and it hasn't been deleted or failed.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool ShaderStorage::ProgramExists(const std::string &programKey) const
+{
+    return _compiledPrograms.find(programKey) != _compiledPrograms.end();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Tells whether the driver said that it compiles shaders on its own threads.  Nothing needs 
+    to be done to turn it on; the default thread count lets the driver decide, and 
+    LinkShader(...) never waits, so all that matters is not asking for the results too early.
+Parameters: None
+Returns:
+    True if GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile is supported.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool ShaderStorage::HasParallelShaderCompile() const
+{
+    GLint numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (GLint extensionIndex = 0; extensionIndex < numExtensions; extensionIndex++)
+    {
+        const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, extensionIndex);
+        if (extension != 0 && 
+            (strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 || 
+            strcmp(extension, "GL_ARB_parallel_shader_compile") == 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 /*------------------------------------------------------------------------------------------------
@@ -390,19 +641,21 @@ Returns:
     The program ID for the requested shader, or 0 if requested shader not found.
 Creator:    John Cox (7-14-2016)
 ------------------------------------------------------------------------------------------------*/
-GLuint ShaderStorage::GetShaderProgram(const std::string &programKey) const
+GLuint ShaderStorage::GetShaderProgram(const std::string &programKey)
 {
+    ResolvePendingProgram(programKey);
+
     _PROGRAM_MAP::const_iterator compiledItr = _compiledPrograms.find(programKey);
     if (compiledItr == _compiledPrograms.end())
     {
-        _BINARY_MAP::const_iterator binaryItr = _shaderBinaries.find(programKey);
-        if (binaryItr == _shaderBinaries.end())
+        _SOURCE_MAP::const_iterator sourceItr = _shaderSources.find(programKey);
+        if (sourceItr == _shaderSources.end())
         {
             fprintf(stderr, "No shader program under the key '%s'\n", programKey.c_str());
         }
         else
         {
-            fprintf(stderr, "No shader program for key '%s', but there are unlinked binaries\n", programKey.c_str());
+            fprintf(stderr, "No shader program for key '%s', but there are unlinked shaders\n", programKey.c_str());
         }
         
         return 0;
@@ -425,8 +678,10 @@ Returns:
 Creator:    John Cox (7-14-2016)
 ------------------------------------------------------------------------------------------------*/
 GLint ShaderStorage::GetUniformLocation(const std::string &programKey,
-    const std::string &uniformName) const
+    const std::string &uniformName)
 {
+    ResolvePendingProgram(programKey);
+
     _PROGRAM_MAP::const_iterator itr = _compiledPrograms.find(programKey);
     if (itr == _compiledPrograms.end())
     {
@@ -461,8 +716,10 @@ Returns:
 Creator:    John Cox (7-14-2016)
 ------------------------------------------------------------------------------------------------*/
 GLint ShaderStorage::GetAttributeLocation(const std::string &programKey,
-    const std::string &attributeName) const
+    const std::string &attributeName)
 {
+    ResolvePendingProgram(programKey);
+
     _PROGRAM_MAP::const_iterator itr = _compiledPrograms.find(programKey);
     if (itr == _compiledPrograms.end())
     {
@@ -484,15 +741,15 @@ GLint ShaderStorage::GetAttributeLocation(const std::string &programKey,
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Creates an empty string under the provided key that is ready to accept file contents from 
-    AddPartialShaderFile(...).  Must be called prior to calling that function for the same program 
-    key.
+    Creates a shader object and starts compiling the source.  Does not wait for the result (see 
+    ResolvePendingProgram(...)).
 
     Prints errors to stderr.
 Parameters: 
-    programKey  The name that will be used to refer to this shader for the rest of the program.
-                If it already exists, it prints a message to stderr and immediately returns.
-Returns:    None
+    shaderAsString  The whole shader source, #version and all.
+    shaderType      GL_VERTEX_SHADER, GL_COMPUTE_SHADER, etc.
+Returns:
+    The shader's ID, or 0 if the source was empty.
 Creator:    John Cox, 3/2017
 ------------------------------------------------------------------------------------------------*/
 GLuint ShaderStorage::CompileShader(const std::string &shaderAsString, const GLenum shaderType)
@@ -514,23 +771,398 @@ GLuint ShaderStorage::CompileShader(const std::string &shaderAsString, const GLe
     glShaderSource(shaderId, 1, bytes, strLengths);
     glCompileShader(shaderId);
 
-    // ??necessary or will the APIENTRY debug function handle this??
-    GLint isCompiled = 0;
-    glGetShaderiv(shaderId, GL_COMPILE_STATUS, &isCompiled);
-    if (isCompiled == GL_FALSE)
+    // Note: Don't ask for GL_COMPILE_STATUS here.  That would wait for the compile to finish, 
+    // and the driver may still be busy with it on another thread.  ResolvePendingProgram(...) 
+    // asks after the program is linked.
+    return shaderId;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gets a shader file's contents, reading the file only the first time that it is asked for.  
+    Every program includes Version.comp, SsboBufferBindings.comp, etc., so without this they 
+    would be read from disk once per program.
+
+    Prints errors to stderr.
+Parameters:
+    filePath    Can be relative to program or an absolute path.  Used as-is for the cache key, 
+                so use the same spelling everywhere (all of the demo's paths start at 
+                "Shaders/").
+Returns:
+    A pointer to the cached contents, or 0 if the file couldn't be read or is empty.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+const std::string *ShaderStorage::ReadShaderFile(const std::string &filePath)
+{
+    _FILE_CONTENTS_MAP::iterator cacheItr = _shaderFileContents.find(filePath);
+    if (cacheItr != _shaderFileContents.end())
     {
-        GLchar errLog[128];
-        GLsizei *logLen = 0;
-        glGetShaderInfoLog(shaderId, 128, logLen, errLog);
-        fprintf(stderr, "shader failed: '%s'\n", errLog);
-        glDeleteShader(shaderId);
+        return &cacheItr->second;
+    }
 
+    std::ifstream shaderFile(filePath);
+    if (!shaderFile.is_open())
+    {
+        fprintf(stderr, "Cannot open shader file '%s'\n", filePath.c_str());
         return 0;
     }
-    else
+
+    std::stringstream shaderData;
+    shaderData << shaderFile.rdbuf();
+    shaderFile.close();
+    _numShaderFileReads++;
+
+    std::string fileContents = shaderData.str();
+    if (fileContents.empty())
+    {
+        fprintf(stderr, "Shader file '%s' is empty\n", filePath.c_str());
+        return 0;
+    }
+
+    return &(_shaderFileContents[filePath] = fileContents);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Appends a shader file to the destination and replaces each of its 
+    '#include "path"' lines with the contents of that file (recursively).
+
+    A file is only added once per shader, no matter how many files #include it, so a file can 
+    #include everything that it needs without worrying about what else the shader has already 
+    pulled in (like #pragma once).  That also makes an #include loop harmless.
+
+    GLSL doesn't have #include (without ARB_shading_language_include), so this has to happen 
+    before the source gets to the driver.  The #include lines use the same paths as the C++ 
+    #include lines, so headers like SsboBufferBindings.comp can keep being shared.
+
+    Prints errors to stderr.
+Parameters:
+    filePath        The file to add.
+    includedFiles   Every file that is already in the destination.  Updated.
+    destination     Receives the file contents.
+Returns:
+    False if the file or anything that it #include's couldn't be read, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool ShaderStorage::AppendShaderFile(const std::string &filePath, 
+    std::set<std::string> &includedFiles, std::string &destination)
+{
+    if (!includedFiles.insert(filePath).second)
+    {
+        // already there
+        return true;
+    }
+
+    const std::string *fileContents = ReadShaderFile(filePath);
+    if (fileContents == 0)
+    {
+        return false;
+    }
+
+    // add a new line just to make sure that there is a clear distinction between any possible 
+    // prior file contents and the current file
+    destination += "\n";
+
+    bool allIncludesFound = true;
+    size_t lineStart = 0;
+    while (lineStart < fileContents->size())
+    {
+        size_t lineEnd = fileContents->find('\n', lineStart);
+        lineEnd = (lineEnd == std::string::npos) ? fileContents->size() : lineEnd + 1;
+
+        size_t directiveStart = fileContents->find_first_not_of(" \t", lineStart);
+        bool isInclude = (directiveStart < lineEnd) && 
+            (fileContents->compare(directiveStart, 8, "#include") == 0);
+        if (!isInclude)
+        {
+            destination.append(*fileContents, lineStart, lineEnd - lineStart);
+        }
+        else
+        {
+            size_t pathStart = fileContents->find('"', directiveStart);
+            size_t pathEnd = (pathStart < lineEnd) ? fileContents->find('"', pathStart + 1) : std::string::npos;
+            if (pathEnd >= lineEnd)
+            {
+                fprintf(stderr, "Malformed #include in shader file '%s'\n", filePath.c_str());
+                allIncludesFound = false;
+            }
+            else
+            {
+                std::string includePath = fileContents->substr(pathStart + 1, pathEnd - pathStart - 1);
+                if (!AppendShaderFile(includePath, includedFiles, destination))
+                {
+                    fprintf(stderr, "    (included from '%s')\n", filePath.c_str());
+                    allIncludesFound = false;
+                }
+            }
+        }
+
+        lineStart = lineEnd;
+    }
+
+    return allIncludesFound;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Puts the program key's #define block (see AddShaderDefine(...)) right after the shader's 
+    #version line.  #version has to be the first thing in a shader, and the defines have to come 
+    before anything that uses them.
+Parameters:
+    programKey  Self-explanatory.
+    source      The whole shader, #version and all.
+Returns:
+    The source with the defines in it, or the source as-is if there aren't any.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+std::string ShaderStorage::InjectShaderDefines(const std::string &programKey, 
+    const std::string &source) const
+{
+    _COMPOSITE_SHADER_MAP::const_iterator definesItr = _shaderDefines.find(programKey);
+    if (definesItr == _shaderDefines.end() || definesItr->second.empty())
+    {
+        return source;
+    }
+
+    size_t insertPos = 0;
+    size_t versionPos = source.find("#version");
+    if (versionPos != std::string::npos)
+    {
+        insertPos = source.find('\n', versionPos);
+        insertPos = (insertPos == std::string::npos) ? source.size() : insertPos + 1;
+    }
+
+    std::string injectedSource = source;
+    if (insertPos > 0 && injectedSource[insertPos - 1] != '\n')
+    {
+        // #version was on the last line with no end line
+        injectedSource.insert(insertPos++, "\n");
+    }
+    injectedSource.insert(insertPos, definesItr->second);
+    return injectedSource;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many shader files have actually been read from disk (as opposed to 
+    found in the file cache; see ReadShaderFile(...)).
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ShaderStorage::NumShaderFileReads() const
+{
+    return _numShaderFileReads;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Turns on the program binary cache.  From then on, LinkShader(...) looks for a binary of the 
+    program in the given directory before compiling anything, and saves a binary after 
+    compiling.  Startup goes from "compile ~10 compute shaders" to "read ~10 files".
+
+    The cache key is a hash of every shader source in the program plus the driver's vendor, 
+    renderer, and version strings, so editing a shader or updating the driver just means a miss 
+    (and a new file).  Old files are never cleaned up; delete the directory to start over.
+
+    Does nothing (other than say so) if the driver doesn't support any program binary formats.
+
+    Note: Must be called after the OpenGL context is made.
+Parameters:
+    cacheDirectory  Relative to the working directory or absolute.  Created if it doesn't exist.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ShaderStorage::UseProgramBinaryCache(const std::string &cacheDirectory)
+{
+    GLint numBinaryFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+    if (numBinaryFormats <= 0)
+    {
+        fprintf(stderr, "Driver supports no program binary formats; not using the shader cache\n");
+        _programCacheDirectory.clear();
+        return;
+    }
+
+#ifdef _WIN32
+    _mkdir(cacheDirectory.c_str());
+#else
+    mkdir(cacheDirectory.c_str(), 0755);
+#endif
+
+    // if it already exists, that's fine, and if it couldn't be made, then saving will fail and 
+    // say so
+    _programCacheDirectory = cacheDirectory;
+
+    const char *vendor = (const char *)glGetString(GL_VENDOR);
+    const char *renderer = (const char *)glGetString(GL_RENDERER);
+    const char *version = (const char *)glGetString(GL_VERSION);
+    _driverIdentity = std::string(vendor ? vendor : "") + "|" + 
+        std::string(renderer ? renderer : "") + "|" + 
+        std::string(version ? version : "");
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of programs that were loaded from the program binary cache.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ShaderStorage::NumProgramCacheHits() const
+{
+    return _numProgramCacheHits;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of programs that had to be compiled while the program binary 
+    cache was in use.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ShaderStorage::NumProgramCacheMisses() const
+{
+    return _numProgramCacheMisses;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Hashes the driver identity and every shader's type and source, in order.
+Parameters:
+    sources     Every shader in the program.
+Returns:
+    The cache key.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned long long ShaderStorage::HashProgramSources(const _SHADER_SOURCES &sources) const
+{
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    hash = Fnv1aHash(hash, _driverIdentity.data(), _driverIdentity.size());
+    for (size_t sourceIndex = 0; sourceIndex < sources.size(); sourceIndex++)
+    {
+        unsigned int shaderType = sources[sourceIndex].first;
+        const std::string &source = sources[sourceIndex].second;
+        hash = Fnv1aHash(hash, &shaderType, sizeof(shaderType));
+        hash = Fnv1aHash(hash, source.data(), source.size());
+    }
+    return hash;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters:
+    sourceHash  From HashProgramSources(...).
+Returns:
+    "<cache directory>/<16 hex digits>.bin"
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+std::string ShaderStorage::ProgramCacheFilePath(unsigned long long sourceHash) const
+{
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016llx.bin", sourceHash);
+    return _programCacheDirectory + "/" + fileName;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Looks for a cached binary of the program and hands it to the driver.  Any problem (no file, 
+    wrong header, driver rejects the binary) is a miss, not an error, and the caller compiles 
+    from source.  A rejected binary is worth mentioning though because it will keep happening 
+    until the file is replaced, which the caller will do.
+Parameters:
+    programKey  Only used for messages.
+    sourceHash  From HashProgramSources(...).
+Returns:
+    The ID of the loaded program, or 0 on a miss.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GLuint ShaderStorage::LoadCachedProgram(const std::string &programKey, unsigned long long sourceHash) const
+{
+    std::ifstream cacheFile(ProgramCacheFilePath(sourceHash), std::ios::binary);
+    if (!cacheFile.is_open())
+    {
+        return 0;
+    }
+
+    ProgramCacheFileHeader header;
+    cacheFile.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!cacheFile ||
+        header._magic != PROGRAM_CACHE_FILE_MAGIC ||
+        header._fileVersion != PROGRAM_CACHE_FILE_VERSION ||
+        header._sourceHash != sourceHash ||
+        header._binaryLengthBytes == 0)
+    {
+        return 0;
+    }
+
+    std::vector<char> binary(header._binaryLengthBytes);
+    cacheFile.read(binary.data(), binary.size());
+    if (!cacheFile)
     {
-        // compilation went fine
-        return shaderId;
+        return 0;
     }
+
+    GLuint programId = glCreateProgram();
+    glProgramBinary(programId, header._binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint isLinked = 0;
+    glGetProgramiv(programId, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE)
+    {
+        fprintf(stdout, "Cached binary for program '%s' was rejected by the driver; recompiling\n", 
+            programKey.c_str());
+        glDeleteProgram(programId);
+        return 0;
+    }
+
+    return programId;
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    Writes the linked program's binary to the cache.  Failure to write is reported but is 
+    otherwise harmless; the program will just be compiled again next time.
+Parameters:
+    programKey  Only used for messages.
+    programId   A successfully linked program.
+    sourceHash  From HashProgramSources(...).
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ShaderStorage::SaveCachedProgram(const std::string &programKey, GLuint programId, unsigned long long sourceHash) const
+{
+    GLint binaryLengthBytes = 0;
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLengthBytes);
+    if (binaryLengthBytes <= 0)
+    {
+        fprintf(stderr, "No binary available for program '%s'; not cached\n", programKey.c_str());
+        return;
+    }
+
+    std::vector<char> binary(binaryLengthBytes);
+    GLenum binaryFormat = 0;
+    GLsizei actualLengthBytes = 0;
+    glGetProgramBinary(programId, binaryLengthBytes, &actualLengthBytes, &binaryFormat, binary.data());
+
+    ProgramCacheFileHeader header;
+    header._magic = PROGRAM_CACHE_FILE_MAGIC;
+    header._fileVersion = PROGRAM_CACHE_FILE_VERSION;
+    header._sourceHash = sourceHash;
+    header._binaryFormat = binaryFormat;
+    header._binaryLengthBytes = actualLengthBytes;
+
+    std::string filePath = ProgramCacheFilePath(sourceHash);
+    std::ofstream cacheFile(filePath, std::ios::binary | std::ios::trunc);
+    if (!cacheFile.is_open())
+    {
+        fprintf(stderr, "Cannot write shader cache file '%s'\n", filePath.c_str());
+        return;
+    }
+    cacheFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    cacheFile.write(binary.data(), actualLengthBytes);
+}
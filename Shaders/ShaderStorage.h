@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -29,13 +30,23 @@ public:
     void AddAndCompileShaderFile(const std::string &programKey, const std::string &filePath, const GLenum shaderType);
     void AddPartialShaderFile(const std::string &programKey, const std::string &filePath);
     void CompileCompositeShader(const std::string &programKey, const GLenum shaderType);
+    void AddShaderDefine(const std::string &programKey, const std::string &name, 
+        const std::string &value);
+    unsigned int NumShaderFileReads() const;
     
     GLuint LinkShader(const std::string &programKey);
-    GLuint GetShaderProgram(const std::string &programKey) const;
+    GLuint GetShaderProgram(const std::string &programKey);
     GLint GetUniformLocation(const std::string &programKey,
-        const std::string &uniformName) const;
+        const std::string &uniformName);
     GLint GetAttributeLocation(const std::string &programKey,
-        const std::string &attributeName) const;
+        const std::string &attributeName);
+    bool ProgramExists(const std::string &programKey) const;
+    void FinishPendingPrograms();
+    bool HasParallelShaderCompile() const;
+
+    void UseProgramBinaryCache(const std::string &cacheDirectory);
+    unsigned int NumProgramCacheHits() const;
+    unsigned int NumProgramCacheMisses() const;
 
 private:
     // defined privately to enforce singleton-ness
@@ -44,6 +55,26 @@ private:
     ShaderStorage &operator=(const ShaderStorage&) {}
 
     GLuint CompileShader(const std::string &shaderAsString, const GLenum shaderType);
+    const std::string *ReadShaderFile(const std::string &filePath);
+    bool AppendShaderFile(const std::string &filePath, std::set<std::string> &includedFiles, 
+        std::string &destination);
+    std::string InjectShaderDefines(const std::string &programKey, const std::string &source) const;
+
+    typedef std::vector<std::pair<GLenum, std::string>> _SHADER_SOURCES;
+
+    // a program that was linked but whose compile and link results haven't been asked for yet
+    struct PendingProgram
+    {
+        GLuint _programId;
+        std::vector<GLuint> _shaderIds;
+        unsigned long long _sourceHash;
+    };
+    PendingProgram SubmitProgram(const _SHADER_SOURCES &sources);
+    void ResolvePendingProgram(const std::string &programKey);
+    unsigned long long HashProgramSources(const _SHADER_SOURCES &sources) const;
+    std::string ProgramCacheFilePath(unsigned long long sourceHash) const;
+    GLuint LoadCachedProgram(const std::string &programKey, unsigned long long sourceHash) const;
+    void SaveCachedProgram(const std::string &programKey, GLuint programId, unsigned long long sourceHash) const;
 
     typedef std::map<std::string, GLuint> _PROGRAM_MAP;
     _PROGRAM_MAP _compiledPrograms;
@@ -63,4 +94,41 @@ private:
     //typedef std::map<std::string, std::map<GLuint, std::string>> _COMPOSITE_SHADER_MAP;
     typedef std::map<std::string, std::string> _COMPOSITE_SHADER_MAP;
     _COMPOSITE_SHADER_MAP _partialShaderContents;
+
+    // the files that are already in each composite shader, so that each is only added once no 
+    // matter how many files #include it (see AppendShaderFile(...))
+    typedef std::map<std::string, std::set<std::string>> _INCLUDED_FILES_MAP;
+    _INCLUDED_FILES_MAP _includedShaderFiles;
+
+    // "#define NAME VALUE" lines to put after the #version line of each shader under the key 
+    // (see AddShaderDefine(...))
+    _COMPOSITE_SHADER_MAP _shaderDefines;
+
+    // every shader file that has been read, by path
+    // Note: The files don't change while the program runs, and most of them are #include'd by 
+    // nearly every program.
+    typedef std::map<std::string, std::string> _FILE_CONTENTS_MAP;
+    _FILE_CONTENTS_MAP _shaderFileContents;
+    unsigned int _numShaderFileReads;
+
+    // the source of every shader under a program key, waiting for LinkShader(...)
+    // Note: Compilation is put off until the link so that the whole program's source can be 
+    // hashed and looked up in the program binary cache first.  On a hit, nothing is compiled.
+    typedef std::map<std::string, _SHADER_SOURCES> _SOURCE_MAP;
+    _SOURCE_MAP _shaderSources;
+
+    // programs that LinkShader(...) submitted without waiting for
+    // Note: Asking for GL_COMPILE_STATUS or GL_LINK_STATUS blocks until the driver is done, so 
+    // the controllers can submit all of their programs before any of them wait.  The first 
+    // getter that needs a program resolves it.
+    typedef std::map<std::string, PendingProgram> _PENDING_MAP;
+    _PENDING_MAP _pendingPrograms;
+
+    // empty if the cache isn't being used
+    std::string _programCacheDirectory;
+
+    // vendor + renderer + version; a binary from one driver is useless to another
+    std::string _driverIdentity;
+    unsigned int _numProgramCacheHits;
+    unsigned int _numProgramCacheMisses;
 };
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "Include/Buffers/GpuBufferArena.h"
+
+#include <stdio.h>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Returns the one and only instance.
+Parameters: None
+Returns:
+    A reference to the singleton.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuBufferArena &GpuBufferArena::GetInstance()
+{
+    static GpuBufferArena instance;
+    return instance;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  Doesn't touch OpenGL, so the instance can be made before
+    there is a context.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuBufferArena::GpuBufferArena() :
+    _alignmentBytes(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Finds space for the range, making a new block if none of the existing ones have it, and
+    fills it with the initial data (or 0s).
+Parameters:
+    name            Only used by PrintMemoryReport().
+    numBytes        Self-explanatory.  Must be a multiple of 4 (every SSBO is made of 4-byte
+                    values anyway).
+    initialData     numBytes worth of data to upload.  If null, the range is cleared to 0 on
+                    the GPU instead.
+Returns:
+    The buffer, offset, and size to bind.  _bufferId is 0 if numBytes was 0.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuBufferRange GpuBufferArena::Allocate(const std::string &name, unsigned int numBytes,
+    const void *initialData)
+{
+    GpuBufferRange range;
+    if (numBytes == 0)
+    {
+        fprintf(stderr, "GpuBufferArena: allocation '%s' is empty\n", name.c_str());
+        return range;
+    }
+
+    // make sure that the alignment has been queried before AlignUp(...) needs it
+    AlignmentBytes();
+
+    Block *blockPtr = 0;
+    unsigned int offsetBytes = 0;
+    for (size_t blockIndex = 0; blockIndex < _blocks.size(); blockIndex++)
+    {
+        if (TryPlaceInBlock(_blocks[blockIndex], numBytes, offsetBytes))
+        {
+            blockPtr = &_blocks[blockIndex];
+            break;
+        }
+    }
+
+    if (blockPtr == 0)
+    {
+        Block newBlock;
+        newBlock._sizeBytes = (numBytes > DEFAULT_BLOCK_SIZE_BYTES) ? AlignUp(numBytes) : DEFAULT_BLOCK_SIZE_BYTES;
+        glGenBuffers(1, &newBlock._bufferId);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, newBlock._bufferId);
+        glBufferStorage(GL_SHADER_STORAGE_BUFFER, newBlock._sizeBytes, 0, GL_DYNAMIC_STORAGE_BIT);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        _blocks.push_back(newBlock);
+
+        blockPtr = &_blocks.back();
+        offsetBytes = 0;
+    }
+
+    // keep the list sorted by offset
+    Allocation newAllocation;
+    newAllocation._name = name;
+    newAllocation._offsetBytes = offsetBytes;
+    newAllocation._sizeBytes = numBytes;
+    std::vector<Allocation>::iterator insertHere = blockPtr->_allocations.begin();
+    while (insertHere != blockPtr->_allocations.end() && insertHere->_offsetBytes < offsetBytes)
+    {
+        insertHere++;
+    }
+    blockPtr->_allocations.insert(insertHere, newAllocation);
+
+    range._bufferId = blockPtr->_bufferId;
+    range._offsetBytes = offsetBytes;
+    range._sizeBytes = numBytes;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, range._bufferId);
+    if (initialData != 0)
+    {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, range._offsetBytes, range._sizeBytes, initialData);
+    }
+    else
+    {
+        // a null pointer clears to 0
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, range._offsetBytes,
+            range._sizeBytes, GL_RED_INTEGER, GL_UNSIGNED_INT, 0);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return range;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives the range's space back.  If that was the last range in its block, then the block's
+    buffer is deleted.  Freeing a range that is 0 or unknown does nothing.
+Parameters:
+    range   Something that Allocate(...) returned.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuBufferArena::Free(const GpuBufferRange &range)
+{
+    if (range._bufferId == 0)
+    {
+        return;
+    }
+
+    for (size_t blockIndex = 0; blockIndex < _blocks.size(); blockIndex++)
+    {
+        Block &block = _blocks[blockIndex];
+        if (block._bufferId != range._bufferId)
+        {
+            continue;
+        }
+
+        for (size_t allocationIndex = 0; allocationIndex < block._allocations.size(); allocationIndex++)
+        {
+            if (block._allocations[allocationIndex]._offsetBytes == range._offsetBytes)
+            {
+                block._allocations.erase(block._allocations.begin() + allocationIndex);
+                break;
+            }
+        }
+
+        if (block._allocations.empty())
+        {
+            glDeleteBuffers(1, &block._bufferId);
+            _blocks.erase(_blocks.begin() + blockIndex);
+        }
+        return;
+    }
+
+    fprintf(stderr, "GpuBufferArena: buffer %u is not one of the arena's blocks\n", range._bufferId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Every offset that the arena hands out is a multiple of this.  Sub-allocators (see 
+    TransientBufferPool) should keep their offsets multiples of it too.  Requires a current 
+    OpenGL context the first time.
+Parameters: None
+Returns:
+    GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, but at least 4.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuBufferArena::AlignmentBytes()
+{
+    if (_alignmentBytes == 0)
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+        // the spec's maximum is 256, and clearing to 0 works on 4-byte values
+        _alignmentBytes = (alignment > 4) ? static_cast<unsigned int>(alignment) : 4;
+    }
+
+    return _alignmentBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of glBufferStorage(...) blocks that currently exist.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuBufferArena::NumBlocks() const
+{
+    return static_cast<unsigned int>(_blocks.size());
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds up the sizes of every block, used or not.  This is what the arena has claimed from
+    the GPU.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuBufferArena::NumBytesReserved() const
+{
+    unsigned int numBytes = 0;
+    for (size_t blockIndex = 0; blockIndex < _blocks.size(); blockIndex++)
+    {
+        numBytes += _blocks[blockIndex]._sizeBytes;
+    }
+    return numBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds up the sizes of every allocation (not counting alignment padding).
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuBufferArena::NumBytesAllocated() const
+{
+    unsigned int numBytes = 0;
+    for (size_t blockIndex = 0; blockIndex < _blocks.size(); blockIndex++)
+    {
+        const Block &block = _blocks[blockIndex];
+        for (size_t allocationIndex = 0; allocationIndex < block._allocations.size(); allocationIndex++)
+        {
+            numBytes += block._allocations[allocationIndex]._sizeBytes;
+        }
+    }
+    return numBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints every block and every allocation in it, in the order that they are laid out.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuBufferArena::PrintMemoryReport() const
+{
+    printf("GPU buffer arena: %u block(s), %.1lf KB reserved, %.1lf KB allocated\n", NumBlocks(),
+        NumBytesReserved() / 1024.0, NumBytesAllocated() / 1024.0);
+    for (size_t blockIndex = 0; blockIndex < _blocks.size(); blockIndex++)
+    {
+        const Block &block = _blocks[blockIndex];
+        printf("    block %u (buffer %u, %.1lf KB)\n", static_cast<unsigned int>(blockIndex),
+            block._bufferId, block._sizeBytes / 1024.0);
+        for (size_t allocationIndex = 0; allocationIndex < block._allocations.size(); allocationIndex++)
+        {
+            const Allocation &allocation = block._allocations[allocationIndex];
+            printf("        %10u  %10.1lf KB  %s\n", allocation._offsetBytes,
+                allocation._sizeBytes / 1024.0, allocation._name.c_str());
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Rounds up to the next multiple of the SSBO offset alignment.
+Parameters:
+    numBytes    Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuBufferArena::AlignUp(unsigned int numBytes) const
+{
+    return ((numBytes + _alignmentBytes - 1) / _alignmentBytes) * _alignmentBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Looks for the first gap in the block (before, between, or after its allocations) that
+    can hold the range at an aligned offset.
+Parameters:
+    block           Self-explanatory.
+    numBytes        Self-explanatory.
+    offsetBytes     Receives where the range would go.
+Returns:
+    True if there was room, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool GpuBufferArena::TryPlaceInBlock(const Block &block, unsigned int numBytes, unsigned int &offsetBytes) const
+{
+    unsigned int gapBegin = 0;
+    for (size_t allocationIndex = 0; allocationIndex <= block._allocations.size(); allocationIndex++)
+    {
+        unsigned int gapEnd = (allocationIndex < block._allocations.size()) ?
+            block._allocations[allocationIndex]._offsetBytes : block._sizeBytes;
+        if (gapEnd >= gapBegin && gapEnd - gapBegin >= numBytes)
+        {
+            offsetBytes = gapBegin;
+            return true;
+        }
+
+        if (allocationIndex < block._allocations.size())
+        {
+            const Allocation &allocation = block._allocations[allocationIndex];
+            gapBegin = AlignUp(allocation._offsetBytes + allocation._sizeBytes);
+        }
+    }
+
+    return false;
+}
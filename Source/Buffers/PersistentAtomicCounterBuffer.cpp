@@ -1,5 +1,8 @@
 #include "Include/Buffers/PersistentAtomicCounterBuffer.h"
 
+#include <stdio.h>
+
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
 #include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
@@ -8,196 +11,307 @@
 /*------------------------------------------------------------------------------------------------
 Description:
     Gives members initial values.
-    Generates a persistently bound atomic counter buffer.  This can be used by compute shaders 
-    that specify the atomic counter with the binding location ATOMIC_COUNTER_BUFFER_BINDING 
-    (from SsboBufferBindings.comp).
-Parameters: None
+    Generates a persistently mapped atomic counter buffer with a counter for each ring slot.
+    This can be used by compute shaders that specify the atomic counter with the binding
+    location ATOMIC_COUNTER_BUFFER_BINDING (from SsboBufferBindings.comp) and offset 0.  The
+    ring slot is bound to that binding point in ResetCounter().
+Parameters:
+    numRingSlots    How many counters to cycle through.  Must be at least 2 or there will never
+                    be a completed value to read while another one is in flight.
 Returns:    None
 Creator:    John Cox, 4/2017
 ------------------------------------------------------------------------------------------------*/
-PersistentAtomicCounterBuffer::PersistentAtomicCounterBuffer() :
+PersistentAtomicCounterBuffer::PersistentAtomicCounterBuffer(unsigned int numRingSlots) :
     _bufferId(0),
-    _bufferPtr(0)
+    _bufferPtr(0),
+    _numRingSlots(numRingSlots),
+    _currentSlot(0),
+    _oldestFencedSlot(0),
+    _mostRecentCompletedValue(0)
 {
-    // call glBufferStorage(...) to set up an immutably-sized buffer with certain contracts 
-    // Note: 
+    if (_numRingSlots < 2)
+    {
+        fprintf(stderr, "PersistentAtomicCounterBuffer: requested %u ring slots, but need at least 2; using 2\n", numRingSlots);
+        _numRingSlots = 2;
+    }
+    _slotFences.resize(_numRingSlots, 0);
+
+    // call glBufferStorage(...) to set up an immutably-sized buffer with certain contracts
+    // Note:
     // - Write (why?)
+    // - Read (the CPU reads the counters back after their fence signals)
     // - Coherent (writes are immediately visible to GPU)
     // - Persistent (allow for performance optimizations magically somehow)
     // - See my source material in the class header
-    // Also Note: 
-    // using 
-    // Note: Thanks to user qartar on the OpenGL subreddit for telling me that glBufferData(...) 
-    // is unnecessary prior to glBufferStorage(...).  
-    // Also Also Note: Credit to user Yan An on the stackoverflow question 
+    // Note: Thanks to user qartar on the OpenGL subreddit for telling me that glBufferData(...)
+    // is unnecessary prior to glBufferStorage(...).
+    // Also Also Note: Credit to user Yan An on the stackoverflow question
     // "What is the difference between glBufferStorage and glBufferData?"
     // http://stackoverflow.com/questions/27810542/what-is-the-difference-between-glbufferstorage-and-glbufferdata/27812200#27812200
-    // Calling glBufferStorage(...), which will set up the buffer with immutable storage, while 
-    // glBufferData(...) sets up the buffer with mutable storage.  I experimented with using 
-    // both of these functions and checked out the messages spit out by OpenGL's debug message 
-    // callback (debugging must have been difficult prior to OpenGL 4.3).  I glBufferData(...) 
-    // is called first, then glBufferStorage(...), then the OpenGL debug message callback 
+    // Calling glBufferStorage(...), which will set up the buffer with immutable storage, while
+    // glBufferData(...) sets up the buffer with mutable storage.  I experimented with using
+    // both of these functions and checked out the messages spit out by OpenGL's debug message
+    // callback (debugging must have been difficult prior to OpenGL 4.3).  I glBufferData(...)
+    // is called first, then glBufferStorage(...), then the OpenGL debug message callback
     // reports the following (the buffer object numbers are unique to my application):
     // Following glBufferData(...):
-    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFER, *blah blah blah*) will use VIDEO 
+    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFER, *blah blah blah*) will use VIDEO
     //  memory as the source for buffer object operations."
     // Then glBufferStorage(...):
-    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFFER, *blah blah blah*) stored in SYSTEM 
+    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFFER, *blah blah blah*) stored in SYSTEM
     // HEAP memory has been updated."
-    // 
-    // However, if I do glBufferStorage(...) first and then glBufferData(...), I get the 
+    //
+    // However, if I do glBufferStorage(...) first and then glBufferData(...), I get the
     // following OpenGL debug messages:
     // Following glBufferStorage(...):
-    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFFER, "blah blah blah*) will use SYSTEM 
+    //  "Buffer object 1 (bound to GL_ATOMIC_COUNTER_BUFFER, "blah blah blah*) will use SYSTEM
     //  HEAP memory as the source for buffer object operations."
     // Following glBufferData(...):
     //  "GL_INVALID_OPERATION error generated.  Cannot modify immutable buffer."
-    // 
-    // So it looks like glBufferStorage(...) will run over glBufferData(...), but the opposite 
-    // is not true (at least for my implementation through GLLoad; I don't know if it is 
+    //
+    // So it looks like glBufferStorage(...) will run over glBufferData(...), but the opposite
+    // is not true (at least for my implementation through GLLoad; I don't know if it is
     // implementation dependent).
     //
-    // Also Also Also Note: The use of SYSTEM HEAP memory is because I am only using the 
-    // GL_MAP_WRITE_BIT.  If I use GL_MAP_WRITE_BIT | GL_MAP_READ_BIT, then the debug message 
-    // that follows glBufferStorage(...) says that it will use DMA memory, and then I loose 
-    // ~10fps on my GTX 560M and my i7-2630QM.  Apparently I can still read from it though if I 
-    // only use GL_MAP_WRITE_BIT and use fencing properly, so I can read without loosing the 
-    // ~10fps.  I suspect that the use of GL_MAP_READ_BIT makes a contract between the CPU and 
-    // the GPU that requires more synchronization than just using the write bit.  That would 
-    // slow things down.
-
-    // ??what is the "system" in "SYSTEM HEAP"? CPU heap or GPU heap??
-    // ??why can I still read from it if I don't have GL_MAP_READ_BIT set??
-
+    // Also Also Also Note: I used to only use GL_MAP_WRITE_BIT because adding GL_MAP_READ_BIT
+    // moved the buffer into DMA memory and I lost ~10fps on my GTX 560M.  That loss came from
+    // the CPU waiting on the GPU every frame.  Now that nothing waits, the read bit is back
+    // so that reading the counters is actually defined behavior.
     glGenBuffers(1, &_bufferId);
-    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, ATOMIC_COUNTER_BUFFER_BINDING, _bufferId);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _bufferId);
 
-    GLuint atomicCounterResetValue = 0;
-    GLuint flags = GL_MAP_WRITE_BIT| GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-    glBufferStorage(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), &atomicCounterResetValue, flags);
+    std::vector<GLuint> atomicCounterResetValues(_numRingSlots, 0);
+    GLuint flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr bufferSizeBytes = _numRingSlots * sizeof(GLuint);
+    glBufferStorage(GL_ATOMIC_COUNTER_BUFFER, bufferSizeBytes, atomicCounterResetValues.data(), flags);
 
     // force cast to unsigned int pointer because I know that it is a buffer of unsigned integers
-    void *voidPtr = glMapBufferRange(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), flags);
+    void *voidPtr = glMapBufferRange(GL_ATOMIC_COUNTER_BUFFER, 0, bufferSizeBytes, flags);
     _bufferPtr = static_cast<unsigned int *>(voidPtr);
-    _bufferPtr[0] = 0;
+
+    // make sure that there is always a valid counter bound, even before the first reset
+    glBindBufferRange(GL_ATOMIC_COUNTER_BUFFER, ATOMIC_COUNTER_BUFFER_BINDING, _bufferId, 0, sizeof(GLuint));
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Unmaps the atomic counter buffer and destroys it.
-
-    ??better way to do this? Note from 2D_GPU_PCollisionWithZOrderCurveRadixSorting??
-    Note: Thanks to user concerned-cynix on the OpenGL subreddit for letting me know that this static stuff causes an OpenGL error on program exit on Linux.  In VS2015 (at least at the time that this function was made), no error is printed via the debug message callback.  That may be because, if the OpenGL context is destroyed by the time that static variables are destroyed, then the debug message callback won't be called.  Huh.  I want there to only be one instance of this calss so that I only need one buffer binding, but is it possible to do a single buffer binding without static?
+    Deletes any outstanding fences, unmaps the atomic counter buffer, and destroys it.
 
+    Note: Thanks to user concerned-cynix on the OpenGL subreddit for letting me know that the
+    static singleton instance (which this class used to be) caused an OpenGL error on program
+    exit on Linux because the context was gone by the time that the static was destroyed.  Now
+    that the counters are owned by the shader controllers, this runs while the context is
+    still alive.
 Parameters: None
 Returns:    None
 Creator:    John Cox, 4/2017
 ------------------------------------------------------------------------------------------------*/
 PersistentAtomicCounterBuffer::~PersistentAtomicCounterBuffer()
 {
+    for (size_t slotIndex = 0; slotIndex < _slotFences.size(); slotIndex++)
+    {
+        if (_slotFences[slotIndex] != 0)
+        {
+            glDeleteSync(_slotFences[slotIndex]);
+        }
+    }
+
     // unsynchronize
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _bufferId);
     glUnmapBuffer(GL_ATOMIC_COUNTER_BUFFER);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
     glDeleteBuffers(1, &_bufferId);
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Returns a const shared pointer to a unique instance of the PersistentAtomicCounterBuffer.
+    Moves on to the next ring slot, zeroes it, and binds it to ATOMIC_COUNTER_BUFFER_BINDING so
+    that the next dispatch counts into it.
 
-    If this is the first call of the program, it generates a new instance.
+    The slot that was in use up until now is fenced first (if GetCounterValue() didn't already
+    do it) because all of the commands that used it have been issued by now.
 
-    Note: Returning a const reference to a const shared pointer because I don't want the class' 
-    instance pointer being messed with on the outside.
-Parameters: None
-Returns:    
-    A const reference to a const shared pointer of the class instance.  
-Creator:    John Cox, 4/2017
-------------------------------------------------------------------------------------------------*/
-const PersistentAtomicCounterBuffer::CONST_SHARED_PTR &PersistentAtomicCounterBuffer::GetInstance()
-{
-    // it is okay to make this static initializer because the static value will not be 
-    // initialized until the first call to this method (unlike static globals, which are 
-    // initialized at program start), and by then the OpenGL context will be initialized
-    // Note: CANNOT use std::make_shared<...> when in a singleton because that is outside 
-    // code that will try to call the constructor, which is private as per the definition of 
-    // a singleton and the construction will fail.  Instead, use the std::shared_ptr<...> 
-    // constructor that takes a pointer to "new" memory.  If the class is constructed via 
-    // "new", then that constructor call has the access privileges of this method, which is 
-    // part of the singleton and therefore has access to the private constructor.  The 
-    // shared memory pointer will then manage the memory until program end, when it will 
-    // destruct and clean up the buffer.
-    static CONST_SHARED_PTR instance = CONST_SHARED_PTR(new PersistentAtomicCounterBuffer());
-
-    return instance;
-}
+    The zeroing is done with glClearBufferSubData(...) instead of writing through the mapped
+    pointer.  That puts the clear in the GPU's command stream after whatever last used the
+    slot, so there is no need to wait for the GPU to finish with the slot before writing to it.
 
-/*------------------------------------------------------------------------------------------------
-Description:
-    Waits for the GPU to finish whatever it is doing, then puts a 0 into the atomic counter 
-    buffer.  Because of GL_MAP_WRITE_BIT and GL_MAP_COHERENT_BIT, this 0 will become immediately 
-    visible to GPU.
-    
-    Note: I discovered after much frustration that you should NOT do this:
+    Note: I discovered after much frustration (back when this was a single counter) that you
+    should NOT do this:
     - fence
     - _bufferPtr[0] = 0
     - client wait sync (wait for GPU to finish)
 
-    That just doesn't work.  Must do this:
-    - fence
-    - client wait sync (wait for GPU to finish)
-    - _bufferPtr[0] = 0
+    That just doesn't work, and the version that did work (wait, then write 0) stalled the CPU.
+    Letting the GPU clear it sidesteps the whole thing.
 
-    The wait for GPU to finish seems to be pretty much nonexistent on my hardware and for this 
-    implementation.
+    Also Note: If the GPU is so far behind that the next slot's fence still hasn't signaled,
+    then that slot's reading is dropped and the slot is reused anyway.  The clear is still
+    ordered after the previous use on the GPU, so the worst that happens is that the "most
+    recent value" is a little older than it could have been.
 Parameters: None
 Returns:    None
-Creator:    John Cox, 4/2017
+Creator:    John Cox, 4/2017 (ring slots added by agent, 10/2026)
 ------------------------------------------------------------------------------------------------*/
-void PersistentAtomicCounterBuffer::ResetCounter() const
+void PersistentAtomicCounterBuffer::ResetCounter()
 {
-    GLsync writeSyncFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    FenceCurrentSlot();
 
-    // Note: Thanks to this article for the idea for the wait sync loop.
-    // https://www.codeproject.com/Articles/872417/Persistent-Mapped-Buffers-in-OpenGL
-    GLenum waitReturn = GL_UNSIGNALED;
-    while (waitReturn != GL_ALREADY_SIGNALED && waitReturn != GL_CONDITION_SATISFIED)
+    _currentSlot = (_currentSlot + 1) % _numRingSlots;
+    if (_slotFences[_currentSlot] != 0)
     {
-        waitReturn = glClientWaitSync(writeSyncFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1);
+        // the slot after the current one in the ring is always the oldest one that was fenced
+        HarvestCompletedSlots();
+        if (_slotFences[_currentSlot] != 0)
+        {
+            // still in flight; drop it (see "Also Note" above)
+            glDeleteSync(_slotFences[_currentSlot]);
+            _slotFences[_currentSlot] = 0;
+            _oldestFencedSlot = (_currentSlot + 1) % _numRingSlots;
+        }
     }
-    _bufferPtr[0] = 0;
 
-    // if it has already synchronized (it has to be in order to reach this point), then the sync 
-    // object will be immediately deleted and there should be no performance problem
-    // Note: See https://www.khronos.org/opengl/wiki/GLAPI/glDeleteSync.
-    glDeleteSync(writeSyncFence);
+    GLintptr slotOffsetBytes = _currentSlot * sizeof(GLuint);
+    GLuint zero = 0;
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _bufferId);
+    glClearBufferSubData(GL_ATOMIC_COUNTER_BUFFER, GL_R32UI, slotOffsetBytes, sizeof(GLuint),
+        GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+    glBindBufferRange(GL_ATOMIC_COUNTER_BUFFER, ATOMIC_COUNTER_BUFFER_BINDING, _bufferId,
+        slotOffsetBytes, sizeof(GLuint));
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Waits for the GPU to finish whatever it is doing, then reads the atomic counter value.
+    Copies the current slot's counter (the one that the dispatches since the last
+    ResetCounter() counted into) into another buffer with glCopyBufferSubData(...).  The copy
+    happens on the GPU's timeline after those dispatches, so, unlike GetCounterValue(), the
+    other buffer gets this frame's count, and the CPU never waits for it.
+
+    Note: The caller must have issued GL_BUFFER_UPDATE_BARRIER_BIT after the dispatches (see
+    MemoryBarrierTracker) or the copy might not see their increments.
+Parameters:
+    destinationBufferId     Self-explanatory.
+    destinationOffsetBytes  Where the uint goes in that buffer.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void PersistentAtomicCounterBuffer::CopyCounterToBuffer(unsigned int destinationBufferId,
+    unsigned int destinationOffsetBytes) const
+{
+    glBindBuffer(GL_COPY_READ_BUFFER, _bufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, destinationBufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, _currentSlot * sizeof(GLuint),
+        destinationOffsetBytes, sizeof(GLuint));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
 
-    Like with ResetCounter, the wait for GPU to finish seems to be pretty much nonexistent on my 
-    hardware and for this implementation.
+/*------------------------------------------------------------------------------------------------
+Description:
+    Returns the value of the most recent counter that the GPU has finished with.  This never
+    waits on the GPU.  Every fenced slot is polled (oldest first) with a 0 timeout, and any that
+    have signaled are read and their fences deleted.
 
-    ??why can I still read from it if I don't have GL_MAP_READ_BIT set??
-    
-    Note: Failure to call glMemoryBarrier(...) with GL_ATOMIC_COUNTER_BARRIER_BIT doesn't seem 
-    to make this not work.  I can read the value regardless.  I don't know why.
+    If the current slot hasn't been fenced yet, it is fenced here.  The caller is assumed to
+    have already issued the dispatch that uses it.
 
+    Note: This used to be const and block.  It is no longer const because polling the fences
+    changes which slots are outstanding.
+Parameters: None
+Returns:
+    The most recent completed counter value, or 0 if nothing has completed yet.
+Creator:    John Cox, 4/2017 (made non-blocking by agent, 10/2026)
+------------------------------------------------------------------------------------------------*/
+unsigned int PersistentAtomicCounterBuffer::GetCounterValue()
+{
+    FenceCurrentSlot();
+
+    HarvestCompletedSlots();
+    return _mostRecentCompletedValue;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Puts a fence after all the commands that have been issued for the current ring slot so
+    that the CPU can tell when it is safe to read.  Does nothing if it was already fenced.
+
+    Note: The counter is incremented by shader atomics and is read by the CPU through the
+    persistent mapping, so the writes need GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT before the
+    fence or they are not guaranteed to be visible when the fence signals.  The barrier
+    tracker only issues it if a shader has written the counter since the last time.
 Parameters: None
 Returns:    None
-Creator:    John Cox, 4/2017
+Creator:    agent, 10/2026
 ------------------------------------------------------------------------------------------------*/
-unsigned int PersistentAtomicCounterBuffer::GetCounterValue() const
+void PersistentAtomicCounterBuffer::FenceCurrentSlot()
 {
-    GLsync readSyncFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-    GLenum waitReturn = GL_UNSIGNALED;
-    while (waitReturn != GL_ALREADY_SIGNALED && waitReturn != GL_CONDITION_SATISFIED)
+    if (_slotFences[_currentSlot] != 0)
     {
-        waitReturn = glClientWaitSync(readSyncFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1);
+        return;
     }
-    glDeleteSync(readSyncFence);
 
-    return *_bufferPtr;
+    ShaderControllers::MemoryBarrierTracker::GetInstance().WaitForAccess(
+        ShaderControllers::BufferAccess(ATOMIC_COUNTER_BUFFER_BINDING, 
+        ShaderControllers::BufferAccessType::CLIENT_MAPPED, false));
+    _slotFences[_currentSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    Walks from the oldest fence to the newest, harvesting every slot that the GPU has finished
+    with.  Stops at the first one that isn't done because fences signal in order.  Harvesting
+    in fencing order also keeps an older slot's value from overwriting a newer one.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void PersistentAtomicCounterBuffer::HarvestCompletedSlots()
+{
+    for (unsigned int count = 0; count < _numRingSlots; count++)
+    {
+        if (_slotFences[_oldestFencedSlot] == 0)
+        {
+            // no fences outstanding
+            break;
+        }
+        if (!TryHarvestSlot(_oldestFencedSlot))
+        {
+            break;
+        }
+        _oldestFencedSlot = (_oldestFencedSlot + 1) % _numRingSlots;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks (without waiting) if the given slot's fence has signaled.  If it has, the slot's
+    counter is recorded as the most recent completed value and the fence is deleted.
+Parameters:
+    slotIndex   Self-explanatory.
+Returns:
+    True if the slot was harvested or if there was no fence on it, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool PersistentAtomicCounterBuffer::TryHarvestSlot(unsigned int slotIndex)
+{
+    GLsync fence = _slotFences[slotIndex];
+    if (fence == 0)
+    {
+        return true;
+    }
+
+    // Note: Timeout 0 turns this into a poll.  GL_SYNC_FLUSH_COMMANDS_BIT makes sure that the
+    // fence actually gets to the GPU, otherwise it might never signal.
+    GLenum waitReturn = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (waitReturn != GL_ALREADY_SIGNALED && waitReturn != GL_CONDITION_SATISFIED)
+    {
+        return false;
+    }
+
+    _mostRecentCompletedValue = _bufferPtr[slotIndex];
+    glDeleteSync(fence);
+    _slotFences[slotIndex] = 0;
+    return true;
+}
@@ -6,30 +6,34 @@
 
 #include "Include/Buffers/IntermediateData.h"
 
-#include <vector>
-
 /*------------------------------------------------------------------------------------------------
 Description:
     Initializes base class, then gives derived class members initial values and allocates space 
     for the SSBO.
 Parameters: 
-    numItems    MUST be the same size as PrefixScanBuffer::PrefixSumsPerWorkGroup.
+    numItems        MUST be the same size as PrefixScanBuffer::PrefixSumsPerWorkGroup.
+    transientRange  If not 0, the SSBO uses this (see TransientBufferPool) instead of 
+                    allocating its own.  Must be at least NumBytesFor(numItems).
 Returns:    None
 Creator:    John Cox, 3/2017
 ------------------------------------------------------------------------------------------------*/
-IntermediateDataSsbo::IntermediateDataSsbo(unsigned int numItems) :
+IntermediateDataSsbo::IntermediateDataSsbo(unsigned int numItems, const GpuBufferRange &transientRange) :
     SsboBase(),  // generate buffers
     _numItems(numItems)
 {
-    std::vector<IntermediateData> v(numItems * 2);
+    if (transientRange._bufferId != 0)
+    {
+        UseBufferRange(transientRange, NumBytesFor(numItems));
+    }
+    else
+    {
+        // a default IntermediateData is all 0s, so let the arena clear it instead of 
+        // uploading a vector of them
+        AllocateBuffer("sort intermediate data", NumBytesFor(numItems), 0);
+    }
 
     // now bind this new buffer to the dedicated buffer binding location
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INTERMEDIATE_SORT_BUFFERS_BINDING, _bufferId);
-
-    // and fill it with new data
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, v.size() * sizeof(IntermediateData), v.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    BindBufferRange(INTERMEDIATE_SORT_BUFFERS_BINDING);
 }
 
 /*------------------------------------------------------------------------------------------------
@@ -67,3 +71,17 @@ unsigned int IntermediateDataSsbo::NumItems() const
     return _numItems;
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    How big the buffer will be.  It has two halves (read and write) of numItems each.  For 
+    sizing a TransientBufferPool before the SSBO exists.
+Parameters:
+    numItems    Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int IntermediateDataSsbo::NumBytesFor(unsigned int numItems)
+{
+    return numItems * 2 * sizeof(IntermediateData);
+}
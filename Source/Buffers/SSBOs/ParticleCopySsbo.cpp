@@ -1,7 +1,5 @@
 #include "Include/Buffers/SSBOs/ParticleCopySsbo.h"
 
-#include <vector>
-
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 #include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
@@ -13,22 +11,44 @@ Description:
     Initializes base class, then gives derived class members initial values and allocates space
     for the SSBO.
 Parameters:
-    numItems    However many Particles user wants to store.
+    numItems        However many Particles user wants to store.
+    transientRange  If not 0, the SSBO uses this (see TransientBufferPool) instead of 
+                    allocating its own.  Must be at least NumBytesFor(numItems).
 Returns:    None
 Creator:    John Cox, 4/2017
 ------------------------------------------------------------------------------------------------*/
-ParticleCopySsbo::ParticleCopySsbo(unsigned int numItems) :
+ParticleCopySsbo::ParticleCopySsbo(unsigned int numItems, const GpuBufferRange &transientRange) :
     SsboBase()  // generate buffers
 {
-    std::vector<Particle> v(numItems);
+    if (transientRange._bufferId != 0)
+    {
+        // the sort fills every particle before reading any of them, so the initial values 
+        // don't matter
+        UseBufferRange(transientRange, NumBytesFor(numItems));
+    }
+    else
+    {
+        // the sort fills it before reading it, so the arena's clear is enough
+        AllocateBuffer("particle sort copy", NumBytesFor(numItems), 0);
+    }
 
     // now bind this new buffer to the dedicated buffer binding location
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLE_COPY_BUFFER_BINDING, _bufferId);
-
-    // and fill it with new data
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, v.size() * sizeof(Particle), v.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    BindBufferRange(PARTICLE_COPY_BUFFER_BINDING);
 
     // ParticleBuffer already has an initializer for the size of the buffer, so don't bother
 }
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How big the buffer will be for the given number of particles.  For sizing a 
+    TransientBufferPool before the SSBO exists.
+Parameters:
+    numItems    Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ParticleCopySsbo::NumBytesFor(unsigned int numItems)
+{
+    return numItems * sizeof(Particle);
+}
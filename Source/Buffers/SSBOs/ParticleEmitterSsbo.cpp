@@ -0,0 +1,71 @@
+#include "Include/Buffers/SSBOs/ParticleEmitterSsbo.h"
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Initializes base class, then gives derived class members initial values and allocates space
+    for the SSBO.
+Parameters:
+    maxEmitters     How many emitter descriptors there is space for.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleEmitterSsbo::ParticleEmitterSsbo(unsigned int maxEmitters) :
+    SsboBase(),  // generate buffers
+    _maxEmitters(maxEmitters)
+{
+    std::vector<ParticleEmitterDescriptor> v(maxEmitters);
+
+    // fill a new buffer with the default descriptors
+    AllocateBuffer("particle emitters", v.size() * sizeof(ParticleEmitterDescriptor), v.data());
+
+    // now bind this new buffer to the dedicated buffer binding location
+    BindBufferRange(PARTICLE_EMITTER_BUFFER_BINDING);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Copies the emitter descriptors into the front of the buffer.  The number of emitters in use 
+    is not stored here.  The reset shader gets it in a uniform.
+
+    Note: glBufferSubData(...) is ordered with the rest of the GPU's commands, so there is no 
+    need to wait for the previous frame's reset to finish before overwriting its emitters.
+Parameters:
+    emitters    Self-explanatory.  At most MaxEmitters() (ParticleReset::AddEmitter(...) 
+                refuses any more).  Anything past that is not uploaded.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::UploadEmitters(const std::vector<ParticleEmitterDescriptor> &emitters) const
+{
+    size_t numToUpload = emitters.size();
+    if (numToUpload > _maxEmitters)
+    {
+        numToUpload = _maxEmitters;
+    }
+    if (numToUpload == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferRange._bufferId);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, _bufferRange._offsetBytes, 
+        numToUpload * sizeof(ParticleEmitterDescriptor), emitters.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the value that was passed in on creation.
+Parameters: None
+Returns:    
+    See Description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ParticleEmitterSsbo::MaxEmitters() const
+{
+    return _maxEmitters;
+}
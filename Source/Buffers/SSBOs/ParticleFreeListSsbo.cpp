@@ -0,0 +1,67 @@
+#include "Include/Buffers/SSBOs/ParticleFreeListSsbo.h"
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Initializes base class, then allocates space for the SSBO.
+
+    All particles start inactive, so the stack starts full with every particle index.  The 
+    ParticleSsbo fills it on the GPU along with the particles (see 
+    ParticleSsbo::InitializeOnGpu()), so this only makes room for it.
+Parameters:
+    numItems    The number of particles in the ParticleSsbo.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleFreeListSsbo::ParticleFreeListSsbo(unsigned int numItems) :
+    SsboBase()  // generate buffers
+{
+    // the +1 is for the count at the front of the buffer
+    AllocateBuffer("particle free list", (numItems + 1) * sizeof(unsigned int), 0);
+
+    // now bind this new buffer to the dedicated buffer binding location
+    BindBufferRange(PARTICLE_FREE_LIST_BUFFER_BINDING);
+
+    // the ParticleBuffer's size uniform covers this buffer too
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes room for more particle indices.  The stack that is already there (count and all) is 
+    kept as is.  The ParticleSsbo pushes the new particles' indices on the GPU (see 
+    ParticleSsbo::Resize(...)).
+Parameters:
+    numItems    The new number of particles in the ParticleSsbo.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleFreeListSsbo::Resize(unsigned int numItems)
+{
+    // the +1 is for the count at the front of the buffer
+    GrowBuffer("particle free list", (numItems + 1) * sizeof(unsigned int));
+    BindBufferRange(PARTICLE_FREE_LIST_BUFFER_BINDING);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Reads the number of indices on the stack back from the GPU.  This stalls until the GPU 
+    catches up, so it is only for rare things like resizing.
+
+    The caller must have issued GL_BUFFER_UPDATE_BARRIER_BIT since the last shader that wrote 
+    the stack.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ParticleFreeListSsbo::ReadFreeIndexCount() const
+{
+    unsigned int count = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferRange._bufferId);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, _bufferRange._offsetBytes, sizeof(count), &count);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return count;
+}
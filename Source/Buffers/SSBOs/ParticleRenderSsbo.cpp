@@ -0,0 +1,81 @@
+#include "Include/Buffers/SSBOs/ParticleRenderSsbo.h"
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Initializes base class, then allocates space for the SSBO.
+
+    The arena clears it, so every vertex starts out with color index 0, which is "active".  
+    That's alright because nothing is drawn until the draw command's count says so, and by then 
+    CountNearbyParticles.comp (or the CPU simulation) has written the vertices.
+Parameters:
+    numItems    The number of particles in the ParticleSsbo.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleRenderSsbo::ParticleRenderSsbo(unsigned int numItems) :
+    SsboBase()  // generate buffers
+{
+    AllocateBuffer("particle render vertices", numItems * sizeof(ParticleRenderVertex), 0);
+
+    // now bind this new buffer to the dedicated buffer binding location
+    BindBufferRange(PARTICLE_RENDER_BUFFER_BINDING);
+
+    // one vertex per particle
+    _numVertices = numItems;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes room for more vertices.  The ones that are already there are kept as is.
+Parameters:
+    numItems    The new number of particles in the ParticleSsbo.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleRenderSsbo::Resize(unsigned int numItems)
+{
+    GrowBuffer("particle render vertices", numItems * sizeof(ParticleRenderVertex));
+    BindBufferRange(PARTICLE_RENDER_BUFFER_BINDING);
+    _numVertices = numItems;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Overwrites the front of the buffer with vertices that were made somewhere else (see 
+    CpuParticleSimulation::ParticlesForRendering()).  Only the vertices that will be drawn need 
+    to be uploaded.
+Parameters:
+    vertices        Self-explanatory.
+    numVertices     How many of them to upload, starting at 0.  Clamped to the size of the 
+                    vector and of the buffer.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleRenderSsbo::UploadVertices(const std::vector<ParticleRenderVertex> &vertices, unsigned int numVertices)
+{
+    ShaderControllers::MemoryBarrierTracker::GetInstance().WaitForAccess(
+        ShaderControllers::BufferAccess(PARTICLE_RENDER_BUFFER_BINDING, ShaderControllers::BufferAccessType::BUFFER_UPDATE, true));
+
+    size_t numToUpload = numVertices;
+    if (numToUpload > vertices.size())
+    {
+        numToUpload = vertices.size();
+    }
+    if (numToUpload > _numVertices)
+    {
+        numToUpload = _numVertices;
+    }
+    if (numToUpload == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferRange._bufferId);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, _bufferRange._offsetBytes, numToUpload * sizeof(ParticleRenderVertex), vertices.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -1,57 +1,24 @@
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
 
+#include <stdio.h>
+#include <string>
 #include <vector>
-#include <random>   // for generating initial data
-#include <time.h>
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Shaders/ShaderStorage.h"
 #include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 #include "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp"
+#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
 
 #include "Include/Particles/Particle.h"
 
 
+// ShaderStorage key
+static const std::string PARTICLE_BUFFER_INIT_SHADER_KEY = "particle buffer init";
 
-/*------------------------------------------------------------------------------------------------
-Description:
-    Particle resetting on the GPU requires several random numbers.  GLSL doesn't have GPU 
-    clock-reading functions, so the next best thing is a chaotic hash function 
-    (see Random.comp).  Being a hash function though, if the same values are put into it (like 
-    the Particle's default position XY and velocity XY values of 0), then the result won't 
-    change.  
-
-    This method gives the particle position and velocity initial random values.
-
-    All particles start as "inactive", so they'll be reset immediately.  This method just gives 
-    them a bump toward randomization.
-Parameters: 
-    initThese   Self-explanatory.
-Returns:    None
-Creator:    John Cox, 4/2017
-------------------------------------------------------------------------------------------------*/
-static void InitializeWithRandomData(std::vector<Particle> &initThese)
-{
-    srand(static_cast<unsigned int>(time(0)));
-
-    float inverseRandMax = 1.0f / RAND_MAX;
-    for (size_t particleIndex = 0; particleIndex < initThese.size(); particleIndex++)
-    {
-        // randomized X and Y values
-        // Note: Once the sim gets running, the particles will be in window space (X and Y along 
-        // the range [-1,+1]), but for initialiation, this 0-1 range will suffice for 
-        // randomizing float values.  The 0-1 range isn't necessary, but the position and 
-        // velocity values are floats, and dividing by RAND_MAX is an easy way to get a float.  
-        // It just so happens to be along the range 0-1.
-        initThese[particleIndex]._position.x = static_cast<float>(rand()) * inverseRandMax;
-        initThese[particleIndex]._position.y = static_cast<float>(rand()) * inverseRandMax;
-        
-        // just outside the Z buffer (0 (far) to -1 (near)), so it won't draw
-        initThese[particleIndex]._position.z = +0.1f;
-
-        initThese[particleIndex]._velocity.x = static_cast<float>(rand()) * inverseRandMax;
-        initThese[particleIndex]._velocity.y = static_cast<float>(rand()) * inverseRandMax;
-    }
-}
+// the minimum GL_MAX_COMPUTE_WORK_GROUP_COUNT in X that every implementation must support
+static const unsigned int MAX_INIT_WORK_GROUPS_X = 65535;
 
 
 /*------------------------------------------------------------------------------------------------
@@ -59,10 +26,15 @@ Description:
     Initializes base class, then gives derived class members initial values and allocates space 
     for the SSBO.
 
-    Generates random initial particle positions and velocities, but all particles are still 
-    default inactive.  See description in InitializeWithRandomData(...).
+    All particles start default inactive.  See description in InitializeOnGpu().
 
-    Uploads the initialized particles to the SSBOs newly allocated buffer memory.
+    Creates the free list of inactive particle indices and the render vertices to go with it, 
+    and the draw command, which starts out drawing nothing because nothing is active yet.
+
+    Note: This used to fill a std::vector<Particle> on the CPU and upload it (and the free 
+    list did the same with a vector of indices).  At millions of particles that was hundreds 
+    of MB of host memory and a long upload, so now the buffers are made empty and a compute 
+    shader fills them.
 
 Parameters: 
     numItems    However many instances of Particle the user wants to store.
@@ -71,23 +43,75 @@ Creator:    John Cox, 4/2017
 ------------------------------------------------------------------------------------------------*/
 ParticleSsbo::ParticleSsbo(unsigned int numItems) :
     SsboBase(),  // generate buffers
-    _numItems(numItems)
+    _numItems(numItems),
+    _freeListSsbo(nullptr),
+    _renderVertexSsbo(nullptr),
+    _drawCommandBufferId(0)
 {
     // each particle is 1 vertex, so for particles, "num vertices" == "num items"
     // Note: This can't be set in the class initializer list.  The class initializer list is for 
     // members of this class only (ParticleSsbo), not for base class members. 
     _numVertices = numItems;
 
-    std::vector<Particle> v(numItems);
-    InitializeWithRandomData(v);
+    // the arena only clears it; InitializeOnGpu() fills it
+    AllocateBuffer("particles", numItems * sizeof(Particle), 0);
 
     // now bind this new buffer to the dedicated buffer binding location
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLE_BUFFER_BINDING, _bufferId);
+    BindBufferRange(PARTICLE_BUFFER_BINDING);
 
-    // and fill it with the new data
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, v.size() * sizeof(Particle), v.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    // all particles start inactive, so all of them start on the free list
+    _freeListSsbo = std::make_shared<ParticleFreeListSsbo>(numItems);
+
+    // one vertex per particle, written by the count stage
+    _renderVertexSsbo = std::make_shared<ParticleRenderSsbo>(numItems);
+
+    // count, instance count, first, base instance (see glDrawArraysIndirect(...))
+    GLuint drawCommand[4] = { 0, 1, 0, 0 };
+    glGenBuffers(1, &_drawCommandBufferId);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawCommandBufferId);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(drawCommand), drawCommand, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    InitializeOnGpu(0, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Deletes the draw command.  SsboBase's destructor takes care of the particles.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleSsbo::~ParticleSsbo()
+{
+    glDeleteBuffers(1, &_drawCommandBufferId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Hands the init shader to ShaderStorage to compile and link, unless it was already 
+    submitted.  Like the controllers' SubmitShaders(...), main(...) can call this early so that 
+    the program compiles alongside the others.  The constructor calls it too, so that is 
+    optional.
+
+    Note: There is no ComputeShaderVariant.  The shader runs once, so the default work group 
+    size is fine.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::SubmitShaders()
+{
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    if (shaderStorageRef.ProgramExists(PARTICLE_BUFFER_INIT_SHADER_KEY))
+    {
+        return;
+    }
+
+    shaderStorageRef.NewCompositeShader(PARTICLE_BUFFER_INIT_SHADER_KEY);
+    shaderStorageRef.AddPartialShaderFile(PARTICLE_BUFFER_INIT_SHADER_KEY, "Shaders/ParticleBufferInit.comp");
+    shaderStorageRef.CompileCompositeShader(PARTICLE_BUFFER_INIT_SHADER_KEY, GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(PARTICLE_BUFFER_INIT_SHADER_KEY);
 }
 
 /*------------------------------------------------------------------------------------------------
@@ -112,6 +136,54 @@ void ParticleSsbo::ConfigureConstantUniforms(unsigned int computeProgramId) cons
     glUseProgram(0);
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    Runs ParticleBufferInit.comp over the new part of the ParticleBuffer, which makes every new 
+    particle inactive and just outside of the depth range (so it won't draw) and pushes its 
+    index onto the free list.  The program is deleted afterwards because it is only needed 
+    again if the buffer grows.
+
+    Note: This used to seed rand() with the time and give every particle a random position and 
+    velocity because the old random hash in Random.comp was seeded with the particle's previous 
+    position and velocity, and a hash of all 0s is always the same value.  The reset shader's 
+    random numbers are now keyed on the frame, the emitter, and a seed from the host 
+    (see ParticleReset::SetRandomSeed(...)), so the initial values don't matter anymore, and 
+    leaving them alone means that two runs with the same seed are identical.
+Parameters: 
+    firstNewParticle        Self-explanatory.  0 if the whole buffer is new.
+    freeIndexCountBefore    How many indices are already on the free list.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::InitializeOnGpu(unsigned int firstNewParticle, unsigned int freeIndexCountBefore)
+{
+    SubmitShaders();
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    unsigned int programId = shaderStorageRef.GetShaderProgram(PARTICLE_BUFFER_INIT_SHADER_KEY);
+    ConfigureConstantUniforms(programId);
+
+    unsigned int numNewParticles = _numItems - firstNewParticle;
+    unsigned int numWorkGroupsX = (numNewParticles + PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X - 1) / PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X;
+    if (numWorkGroupsX > MAX_INIT_WORK_GROUPS_X)
+    {
+        numWorkGroupsX = MAX_INIT_WORK_GROUPS_X;
+    }
+
+    glUseProgram(programId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(PARTICLE_BUFFER_INIT_SHADER_KEY, "uFirstNewParticle"), firstNewParticle);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(PARTICLE_BUFFER_INIT_SHADER_KEY, "uFreeIndexCountBefore"), freeIndexCountBefore);
+    glDispatchCompute(numWorkGroupsX, 1, 1);
+    glUseProgram(0);
+
+    // whoever uses the particles next waits for these writes like any others
+    ShaderControllers::MemoryBarrierTracker &barrierTrackerRef = ShaderControllers::MemoryBarrierTracker::GetInstance();
+    barrierTrackerRef.RecordAccess(ShaderControllers::BufferAccess(PARTICLE_BUFFER_BINDING, ShaderControllers::BufferAccessType::SHADER_STORAGE, true));
+    barrierTrackerRef.RecordAccess(ShaderControllers::BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, ShaderControllers::BufferAccessType::SHADER_STORAGE, true));
+
+    shaderStorageRef.DeleteShader(PARTICLE_BUFFER_INIT_SHADER_KEY);
+}
+
 /*------------------------------------------------------------------------------------------------
 Description:
     A simple getter for the value that was passed in on creation.
@@ -127,7 +199,149 @@ unsigned int ParticleSsbo::NumItems() const
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Sets up the vertex attribute pointers for this SSBO's VAO.
+    Makes room for more particles without losing the ones that are already there.  The 
+    particles (active or not) keep their indices, the free list keeps its stack, the render 
+    vertices are kept too, and the new particles start inactive and on the free list, just like 
+    at startup.
+
+    Everything that was set up for the old size has to be redone by whoever set it up:
+    - Every program's uParticleBufferSize (see ConfigureConstantUniforms(...)).  The 
+    controllers do it in their ParticleBufferResized(...).
+    - The VAO's attribute pointers, because the render vertices are in a different range (see 
+    RenderParticles::ConfigureSsboForRendering(...)).
+
+    Note: This reads the free list's count back from the GPU, so it stalls.  Grow rarely and 
+    by a lot (see GrownCapacity(...)).
+Parameters: 
+    numItems    The new number of particles.  Must be more than NumItems().
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::Resize(unsigned int numItems)
+{
+    if (numItems <= _numItems)
+    {
+        fprintf(stderr, "ParticleSsbo can only grow, not go from %u to %u particles\n", _numItems, numItems);
+        return;
+    }
+
+    // the copies and the count readback need the shaders' writes
+    ShaderControllers::MemoryBarrierTracker &barrierTrackerRef = ShaderControllers::MemoryBarrierTracker::GetInstance();
+    barrierTrackerRef.WaitForAccess(ShaderControllers::BufferAccess(PARTICLE_BUFFER_BINDING, ShaderControllers::BufferAccessType::BUFFER_UPDATE, false));
+    barrierTrackerRef.WaitForAccess(ShaderControllers::BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, ShaderControllers::BufferAccessType::BUFFER_UPDATE, false));
+    unsigned int freeIndexCountBefore = _freeListSsbo->ReadFreeIndexCount();
+
+    unsigned int oldNumItems = _numItems;
+    GrowBuffer("particles", numItems * sizeof(Particle));
+    BindBufferRange(PARTICLE_BUFFER_BINDING);
+    _numItems = numItems;
+    _numVertices = numItems;
+
+    _freeListSsbo->Resize(numItems);
+    _renderVertexSsbo->Resize(numItems);
+    InitializeOnGpu(oldNumItems, freeIndexCountBefore);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The growth policy.  Doubling means that growing one particle at a time up to N particles 
+    only resizes log2(N) times, and the copies add up to less than N particles.
+Parameters: 
+    currentNumItems     Self-explanatory.
+    minNumItems         How many particles are needed.
+Returns:
+    The smallest doubling of currentNumItems that is at least minNumItems, or currentNumItems 
+    if it already is.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ParticleSsbo::GrownCapacity(unsigned int currentNumItems, unsigned int minNumItems)
+{
+    unsigned int numItems = (currentNumItems > 0) ? currentNumItems : 1;
+    while (numItems < minNumItems)
+    {
+        numItems *= 2;
+    }
+    return numItems;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Copies every particle back to the CPU.  This stalls until the GPU is done with them, so 
+    it is for checking results (see the headless runner), not for every frame.
+Parameters: 
+    particles   Resized to NumItems() and filled in.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::ReadParticles(std::vector<Particle> &particles) const
+{
+    ShaderControllers::MemoryBarrierTracker::GetInstance().WaitForAccess(
+        ShaderControllers::BufferAccess(PARTICLE_BUFFER_BINDING, ShaderControllers::BufferAccessType::BUFFER_UPDATE, false));
+
+    particles.resize(_numItems);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferRange._bufferId);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, _bufferRange._offsetBytes, _numItems * sizeof(Particle), particles.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Overwrites the front of the render vertices with ones that were made from particles that 
+    were simulated somewhere else (see CpuParticleSimulation::ParticlesForRendering()) so that 
+    RenderParticles can draw them.
+
+    Note: This used to upload whole Particles, and they were drawn straight out of the 
+    ParticleBuffer.  Now only the vertices that will be drawn are uploaded, at 12 bytes apiece.
+Parameters: 
+    vertices        Self-explanatory.
+    numVertices     How many to upload from the front of vertices.  Clamped to NumItems().
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::UploadRenderVertices(const std::vector<ParticleRenderVertex> &vertices, unsigned int numVertices)
+{
+    _renderVertexSsbo->UploadVertices(vertices, numVertices);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the buffer that holds the particles' glDrawArraysIndirect(...) 
+    command.  The GPU fills in its count (see ParticleUpdate).
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ParticleSsbo::DrawCommandBufferId() const
+{
+    return _drawCommandBufferId;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Sets the draw command's count from the CPU, for particles that were simulated on the CPU 
+    and uploaded (see UploadRenderVertices(...)).  The GPU simulation doesn't use this; 
+    ParticleUpdate copies the count on the GPU.
+Parameters: 
+    numParticles    The particles in [0, this) are drawn.  Clamped to NumItems().
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ParticleSsbo::SetDrawCount(unsigned int numParticles)
+{
+    ShaderControllers::MemoryBarrierTracker::GetInstance().WaitForAccess(
+        ShaderControllers::BufferAccess(PARTICLE_DRAW_COMMAND_BUFFER_BINDING, ShaderControllers::BufferAccessType::BUFFER_UPDATE, true));
+
+    GLuint count = (numParticles < _numItems) ? numParticles : _numItems;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawCommandBufferId);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, DRAW_COMMAND_COUNT_OFFSET_BYTES, sizeof(count), &count);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Generates this SSBO's VAO and sets up the vertex attribute pointers.  They point at the 
+    render vertices (see ParticleRenderSsbo), not at the particles.
 Parameters: 
     renderProgramId     Self-explanatory
     drawStyle           Expected to be GL_POINTS.
@@ -144,96 +358,46 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     // spit out an error but will rather silently bind to whatever program is currently bound, 
     // even if it is the undefined program 0.
     glUseProgram(renderProgramId);
+    if (_vaoId == 0)
+    {
+        glGenVertexArrays(1, &_vaoId);
+    }
     glBindVertexArray(_vaoId);
 
     // the vertex array attributes only work on whatever is bound to the array buffer, so bind 
-    // shader storage buffer to the array buffer, set up the vertex array attributes, and the 
-    // VAO will then use the buffer ID of whatever is bound to it
-    glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
-    // do NOT call glBufferData(...) because it was called earlier for the shader storage buffer
-
-    // vertex attribute order is same as the structure
-    // - glm::vec4 _position;
-    // - glm::vec4 _velocity;
-    // - float _mass;
-    // - float _collisionRadius;
-    // - unsigned int _hasCollidedAlreadyThisFrame;
-    // - int _isActive;
+    // the render vertices' buffer to the array buffer, set up the vertex array attributes, and 
+    // the VAO will then use the buffer ID of whatever is bound to it
+    glBindBuffer(GL_ARRAY_BUFFER, _renderVertexSsbo->BufferId());
+    // do NOT call glBufferData(...) because the storage came from the GpuBufferArena earlier
+
+    // vertex attribute order is same as the structure (see ParticleRenderVertex.h)
+    // - float _positionX, _positionY;
+    // - unsigned int _colorIndex;
+    // Note: This used to be one attribute for every field in Particle, straight out of the 
+    // ParticleBuffer, so every vertex pulled 64 bytes, most of which the vertex shader ignored.
 
     unsigned int vertexArrayIndex = 0;
-    unsigned int bufferStartOffset = 0;
-    unsigned int bytesPerStep = sizeof(Particle);
+    // the vertices are a range of a shared buffer, so the first attribute starts where the 
+    // range does
+    unsigned int bufferStartOffset = _renderVertexSsbo->BufferOffsetBytes();
+    unsigned int bytesPerStep = sizeof(ParticleRenderVertex);
     unsigned int sizeOfLastItem = 0;
 
-    // position
+    // position (X and Y)
     GLenum itemType = GL_FLOAT;
-    unsigned int numItems = sizeof(Particle::_position) / sizeof(float);
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_position);
-
-    // velocity
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_velocity) / sizeof(float);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_velocity);
-
-    // numberOfNearbyParticles
-    itemType = GL_UNSIGNED_INT;
-    numItems = sizeof(Particle::_numberOfNearbyParticles) / sizeof(unsigned int);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribIPointer(vertexArrayIndex, numItems, itemType, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_numberOfNearbyParticles);
-
-    // mass
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_mass) / sizeof(float);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
+    unsigned int numItems = 2;
     glEnableVertexAttribArray(vertexArrayIndex);
     glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_mass);
-
-    // collision radius
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_collisionRadius) / sizeof(float);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_collisionRadius);
-
-    // morton coode
-    itemType = GL_UNSIGNED_INT;
-    numItems = sizeof(Particle::_mortonCode) / sizeof(unsigned int);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribIPointer(vertexArrayIndex, numItems, itemType, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_mortonCode);
+    sizeOfLastItem = sizeof(ParticleRenderVertex::_positionX) + sizeof(ParticleRenderVertex::_positionY);
 
-    // "has already collided this frame" flag
+    // color index
     itemType = GL_UNSIGNED_INT;
-    numItems = sizeof(Particle::_hasCollidedAlreadyThisFrame) / sizeof(unsigned int);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribIPointer(vertexArrayIndex, numItems, itemType, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_hasCollidedAlreadyThisFrame);
-
-    // "is active" flag
-    itemType = GL_INT;
-    numItems = sizeof(Particle::_isActive) / sizeof(int);
+    numItems = sizeof(ParticleRenderVertex::_colorIndex) / sizeof(unsigned int);
     bufferStartOffset += sizeOfLastItem;
     vertexArrayIndex++;
     glEnableVertexAttribArray(vertexArrayIndex);
     glVertexAttribIPointer(vertexArrayIndex, numItems, itemType, bytesPerStep, (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_isActive);
+    sizeOfLastItem = sizeof(ParticleRenderVertex::_colorIndex);
 
     // cleanup
     glBindVertexArray(0);   // unbind this BEFORE the array or else the VAO will bind to buffer 0
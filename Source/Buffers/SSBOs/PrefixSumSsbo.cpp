@@ -2,12 +2,9 @@
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
 #include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 #include "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp"
 
-#include <vector>
-
 /*------------------------------------------------------------------------------------------------
 Description:
     Further explanation of the number of data entries:
@@ -36,7 +33,7 @@ Description:
     the data and give the threads something to chew on.  Like hay for horses.  It's cheap.
 
     In the following examples, work group size = 512, so
-    PARALLEL_SORT_ITEMS_PER_WORK_GROUP = work group size * 2 = 1024.
+    items per work group = work group size * 2 = 1024.
 
     Ex 1: data size = 42
     allocated data  = ((42 / 1024) + (42 % 1024 == 0) ? 0 : 1) * 1024
@@ -107,24 +104,26 @@ Description:
     Initializes the base class, then initializes derived class members and allocates space for 
     the SSBO.
 Parameters: 
-    numDataEntries  How many items the user wants to have.  The only restriction is that it be 
-    less than (due to restrictions in the ParallelPrefixScan) 1024x1024 = 1,048,576.
+    numDataEntries      How many items the user wants to have.  The only restriction is that 
+                        it be less than (due to restrictions in the ParallelPrefixScan) 
+                        itemsPerWorkGroup^2 (1024x1024 = 1,048,576 by default).
+    itemsPerWorkGroup   2x the sort's work group size.  Must match the 
+                        PARALLEL_SORT_ITEMS_PER_WORK_GROUP that the sort's shaders were built 
+                        with (see ComputeShaderVariant::ParallelSortItemsPerWorkGroup()) 
+                        because it sets the size of PrefixScanBuffer::PrefixSumsOfWorkGroupSums.
+    transientRange      If not 0, the SSBO uses this (see TransientBufferPool) instead of 
+                        allocating its own.  Must be at least NumBytesFor(...).
 Returns:    None
 Creator:    John Cox, 3/2017
 ------------------------------------------------------------------------------------------------*/
-PrefixSumSsbo::PrefixSumSsbo(unsigned int numDataEntries) :
+PrefixSumSsbo::PrefixSumSsbo(unsigned int numDataEntries, unsigned int itemsPerWorkGroup, 
+    const GpuBufferRange &transientRange) :
     SsboBase(),  // generate buffers
     _numPerGroupPrefixSums(0),
     _numDataEntries(0)
 {
     // see explanation essay at the top of the file
-    // Note: If the user passes in a data set of size 0, then the following calculation 
-    // will give a number of data entries of 0, so the number of work groups calculated in the 
-    // ParallelSort compute controller will lso be 0 and the sorting process will go nowhere.  
-    // At least it won't crash.
-    _numDataEntries = (numDataEntries / PARALLEL_SORT_ITEMS_PER_WORK_GROUP);
-    _numDataEntries += (numDataEntries % PARALLEL_SORT_ITEMS_PER_WORK_GROUP == 0) ? 0 : 1;
-    _numDataEntries *= PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
+    _numDataEntries = NumDataEntriesFor(numDataEntries, itemsPerWorkGroup);
 
     // use one work group's worth of data for the per-work-group prefix sums
     // Note: The prefix scan of the "per work group sums" is a necessary step in preparation for 
@@ -133,23 +132,70 @@ PrefixSumSsbo::PrefixSumSsbo(unsigned int numDataEntries) :
     // data will also have the prefix scan run on it, so it must be the size of one work group's 
     // worth of data.  
     // Also Note: If the original data set is larger than 
-    // PARALLEL_SORT_ITEMS_PER_WORK_GROUP * PARALLEL_SORT_ITEMS_PER_WORK_GROUP 
+    // itemsPerWorkGroup * itemsPerWorkGroup 
     // (number of work group sums * amount of data that each work group operates on), then 
-    // PARALLEL_SORT_ITEMS_PER_WORK_GROUP will need to be increased.
-    _numPerGroupPrefixSums = PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
-
-    // the std::vector<...>(...) constructor will set everything to 0
-    // Note: The +1 is because of a single uint in the buffer, totalNumberOfOnes.  See 
-    // explanation in PrefixScanBuffer.comp.
-    std::vector<unsigned int> v(_numPerGroupPrefixSums + 1 + _numDataEntries);
+    // the sort's work group size will need to be increased.
+    _numPerGroupPrefixSums = itemsPerWorkGroup;
+
+    if (transientRange._bufferId != 0)
+    {
+        // every radix pass writes all of it (GetBitForPrefixScan.comp, then 
+        // ParallelPrefixScan.comp) before reading any of it, so whatever another buffer left 
+        // in the range doesn't matter
+        UseBufferRange(transientRange, NumBytesFor(numDataEntries, itemsPerWorkGroup));
+    }
+    else
+    {
+        // no initial data, so the arena will fill it with 0s
+        AllocateBuffer("sort prefix scan", NumBytesFor(numDataEntries, itemsPerWorkGroup), 0);
+    }
 
     // now bind this new buffer to the dedicated buffer binding location
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PREFIX_SCAN_BUFFER_BINDING, _bufferId);
+    BindBufferRange(PREFIX_SCAN_BUFFER_BINDING);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Rounds the number of items up to a whole number of work groups' worth.  See the 
+    explanation essay at the top of the file.
+
+    Note: If the user passes in a data set of size 0, then this will give a number of data 
+    entries of 0, so the number of work groups calculated in the ParallelSort compute 
+    controller will also be 0 and the sorting process will go nowhere.  At least it won't 
+    crash.
+Parameters: 
+    numDataEntries      See constructor.
+    itemsPerWorkGroup   See constructor.
+Returns:    
+    See description.
+Creator:    John Cox, 3/2017 (split out of the constructor by agent, 10/2026)
+------------------------------------------------------------------------------------------------*/
+unsigned int PrefixSumSsbo::NumDataEntriesFor(unsigned int numDataEntries, unsigned int itemsPerWorkGroup)
+{
+    unsigned int numEntries = (numDataEntries / itemsPerWorkGroup);
+    numEntries += (numDataEntries % itemsPerWorkGroup == 0) ? 0 : 1;
+    numEntries *= itemsPerWorkGroup;
+    return numEntries;
+}
 
-    // and fill it with 0s
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, v.size() * sizeof(unsigned int), v.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+/*------------------------------------------------------------------------------------------------
+Description:
+    How big the buffer will be: one work group's worth of per-work-group sums, the total 
+    number of 1s, and the (rounded up) per-item sums.  For sizing a TransientBufferPool before 
+    the SSBO exists.
+Parameters: 
+    numDataEntries      See constructor.
+    itemsPerWorkGroup   See constructor.
+Returns:    
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int PrefixSumSsbo::NumBytesFor(unsigned int numDataEntries, unsigned int itemsPerWorkGroup)
+{
+    // Note: The +1 is because of a single uint in the buffer, totalNumberOfOnes.  See 
+    // explanation in PrefixScanBuffer.comp.
+    unsigned int numUints = itemsPerWorkGroup + 1 + NumDataEntriesFor(numDataEntries, itemsPerWorkGroup);
+    return numUints * sizeof(unsigned int);
 }
 
 /*------------------------------------------------------------------------------------------------
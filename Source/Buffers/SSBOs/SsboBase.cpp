@@ -1,5 +1,7 @@
 #include "Include/Buffers/SSBOs/SsboBase.h"
 
+#include <stdio.h>
+
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 /*------------------------------------------------------------------------------------------------
@@ -22,12 +24,14 @@ Description:
     Gives members default values.
 
     Note: As part of the Resource Acquisition is Initialization (RAII) approach that I am trying 
-    to use in this program, the SSBOs are generated here.  This means that the OpenGL context 
-    MUST be started up prior to initialization.  Prior to OpenGL context instantiation, any 
-    gl*(...) function calls will throw an exception.
+    to use in this program, the derived classes allocate their SSBOs in their constructors 
+    (see AllocateBuffer(...)).  This means that the OpenGL context MUST be started up prior to 
+    initialization.  Prior to OpenGL context instantiation, any gl*(...) function calls will 
+    throw an exception.
 
     The SSBO is linked up with the compute shader in ConfigureCompute(...).
-    The VAO is initialized in ConfigureRender(...).
+    The VAO is generated and initialized in ConfigureRender(...), and only by derived classes 
+    that render.  Most of the SSBOs are compute-only and never need one.
 
 Parameters: None
 Returns:    None
@@ -35,29 +39,121 @@ Creator:    John Cox, 9-20-2016
 ------------------------------------------------------------------------------------------------*/
 SsboBase::SsboBase() :
     _vaoId(0),
-    _bufferId(0),
+    _ownsBufferRange(false),
     _drawStyle(0),
     _numVertices(0),
     _ssboBindingPointIndex(GetNewStorageBlockBindingPointIndex())
 {
-    glGenBuffers(1, &_bufferId);
-    glGenVertexArrays(1, &_vaoId);
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    Cleans up the buffer and VAO.  If either is 0, then the glDelete*(...) call silently does 
-    nothing.
+    Gives the buffer's range back to the arena (if it came from there) and cleans up the VAO.  
+    If either is 0, then nothing happens to it.
 Parameters: None
 Returns:    None
 Creator:    John Cox, 9-20-2016
 ------------------------------------------------------------------------------------------------*/
 SsboBase::~SsboBase()
 {
-    glDeleteBuffers(1, &_bufferId);
+    if (_ownsBufferRange)
+    {
+        GpuBufferArena::GetInstance().Free(_bufferRange);
+    }
     glDeleteVertexArrays(1, &_vaoId);
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gets the SSBO's storage from the GpuBufferArena.  Call once, in the derived class' 
+    constructor.
+Parameters: 
+    name            Shows up in GpuBufferArena::PrintMemoryReport().
+    numBytes        Self-explanatory.
+    initialData     numBytes worth of data, or null to start with 0s.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void SsboBase::AllocateBuffer(const std::string &name, unsigned int numBytes, const void *initialData)
+{
+    _bufferRange = GpuBufferArena::GetInstance().Allocate(name, numBytes, initialData);
+    _ownsBufferRange = true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The alternative to AllocateBuffer(...) for SSBOs whose memory is managed by someone else 
+    (a TransientBufferPool, usually).  The SSBO doesn't free it.
+Parameters: 
+    range           Self-explanatory.
+    numBytesNeeded  How big the SSBO needs to be.  Complains if the range is smaller.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void SsboBase::UseBufferRange(const GpuBufferRange &range, unsigned int numBytesNeeded)
+{
+    if (range._sizeBytes < numBytesNeeded)
+    {
+        fprintf(stderr, "SSBO needs %u bytes, but was given a range of %u\n", numBytesNeeded, 
+            range._sizeBytes);
+    }
+    _bufferRange = range;
+    _ownsBufferRange = false;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Moves the SSBO to a bigger range from the GpuBufferArena.  The old contents are copied to 
+    the start of the new range, the rest of it is 0s, and the old range is given back.  Only for 
+    SSBOs that got their range from AllocateBuffer(...).
+
+    The derived class has to bind the new range (see BindBufferRange(...)), and anyone who 
+    wrote the old range with a shader has to have issued GL_BUFFER_UPDATE_BARRIER_BIT first 
+    because it is read with glCopyBufferSubData(...).
+Parameters: 
+    name        Shows up in GpuBufferArena::PrintMemoryReport().
+    numBytes    The new size.  Must be bigger than the old one.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void SsboBase::GrowBuffer(const std::string &name, unsigned int numBytes)
+{
+    if (!_ownsBufferRange || numBytes <= _bufferRange._sizeBytes)
+    {
+        fprintf(stderr, "SSBO '%s' can't grow from %u bytes to %u\n", name.c_str(), 
+            _bufferRange._sizeBytes, numBytes);
+        return;
+    }
+
+    GpuBufferArena &arenaRef = GpuBufferArena::GetInstance();
+    GpuBufferRange oldRange = _bufferRange;
+    _bufferRange = arenaRef.Allocate(name, numBytes, 0);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, oldRange._bufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _bufferRange._bufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, oldRange._offsetBytes, 
+        _bufferRange._offsetBytes, oldRange._sizeBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    arenaRef.Free(oldRange);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO's range to the given binding point (one of the *_BINDING values in 
+    SsboBufferBindings.comp), which is what the shaders see as the start of the buffer.
+Parameters: 
+    ssboBindingIndex    Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void SsboBase::BindBufferRange(unsigned int ssboBindingIndex) const
+{
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, ssboBindingIndex, _bufferRange._bufferId, 
+        _bufferRange._offsetBytes, _bufferRange._sizeBytes);
+}
+
 /*------------------------------------------------------------------------------------------------
 Description:
     This is a convenience method for setting constant values, like buffer sizes, that must be 
@@ -111,7 +207,8 @@ unsigned int SsboBase::VaoId() const
 
 /*------------------------------------------------------------------------------------------------
 Description:
-    A simple getter for the vertex buffer object's ID.
+    A simple getter for the vertex buffer object's ID.  This is the arena block that the SSBO 
+    lives in, so it is shared with other SSBOs.
 Parameters: None
 Returns:
     A copy of the VBO's ID.
@@ -119,7 +216,33 @@ Creator:    John Cox, 9-20-2016
 ------------------------------------------------------------------------------------------------*/
 unsigned int SsboBase::BufferId() const
 {
-    return _bufferId;
+    return _bufferRange._bufferId;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for where the SSBO starts within BufferId().
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int SsboBase::BufferOffsetBytes() const
+{
+    return _bufferRange._offsetBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the SSBO's size.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int SsboBase::BufferSizeBytes() const
+{
+    return _bufferRange._sizeBytes;
 }
 
 /*------------------------------------------------------------------------------------------------
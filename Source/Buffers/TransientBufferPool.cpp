@@ -0,0 +1,271 @@
+#include "Include/Buffers/TransientBufferPool.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  Nothing is allocated until Allocate().
+Parameters:
+    name    Shows up in PrintReport() and GpuBufferArena::PrintMemoryReport().
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+TransientBufferPool::TransientBufferPool(const std::string &name) :
+    _name(name)
+{
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives the pool's range back to the arena.  Any SSBOs that were using ranges of it must be
+    gone already.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+TransientBufferPool::~TransientBufferPool()
+{
+    GpuBufferArena::GetInstance().Free(_poolRange);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Declares a buffer and the steps that it is alive for.  Must be called before Allocate().
+Parameters:
+    name        Only used by PrintReport().
+    numBytes    Self-explanatory.  Must be a multiple of 4.
+    firstStep   The first step that reads or writes the buffer.
+    lastStep    The last step that reads or writes the buffer.  Inclusive.
+Returns:
+    The index to pass to BufferRange(...).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int TransientBufferPool::AddBuffer(const std::string &name, unsigned int numBytes,
+    unsigned int firstStep, unsigned int lastStep)
+{
+    if (_poolRange._bufferId != 0)
+    {
+        fprintf(stderr, "TransientBufferPool '%s': buffer '%s' added after Allocate()\n",
+            _name.c_str(), name.c_str());
+    }
+    if (lastStep < firstStep)
+    {
+        fprintf(stderr, "TransientBufferPool '%s': buffer '%s' ends (step %u) before it starts (step %u)\n",
+            _name.c_str(), name.c_str(), lastStep, firstStep);
+        lastStep = firstStep;
+    }
+
+    TransientBuffer newBuffer;
+    newBuffer._name = name;
+    newBuffer._sizeBytes = numBytes;
+    newBuffer._firstStep = firstStep;
+    newBuffer._lastStep = lastStep;
+    newBuffer._offsetBytes = 0;
+    _buffers.push_back(newBuffer);
+    return static_cast<unsigned int>(_buffers.size() - 1);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Lays out the buffers, biggest first, each at the lowest aligned offset that is clear of
+    every already-placed buffer that is alive at the same time, and then takes the total from
+    the GpuBufferArena.
+
+    The only offsets worth trying are 0 and the (aligned) end of each conflicting buffer.  That
+    is the usual greedy approach for this (it's the "interval graph" version of bin packing),
+    and it is optimal when the lifetimes are nested or disjoint, which they usually are.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void TransientBufferPool::Allocate()
+{
+    GpuBufferArena &arenaRef = GpuBufferArena::GetInstance();
+    unsigned int alignmentBytes = arenaRef.AlignmentBytes();
+
+    std::vector<unsigned int> placementOrder(_buffers.size());
+    for (size_t bufferIndex = 0; bufferIndex < _buffers.size(); bufferIndex++)
+    {
+        placementOrder[bufferIndex] = static_cast<unsigned int>(bufferIndex);
+    }
+    std::stable_sort(placementOrder.begin(), placementOrder.end(),
+        [this](unsigned int a, unsigned int b) { return _buffers[a]._sizeBytes > _buffers[b]._sizeBytes; });
+
+    unsigned int peakBytes = 0;
+    for (size_t orderIndex = 0; orderIndex < placementOrder.size(); orderIndex++)
+    {
+        TransientBuffer &buffer = _buffers[placementOrder[orderIndex]];
+
+        // the placed buffers that this one can't overlap
+        std::vector<const TransientBuffer *> conflicts;
+        std::vector<unsigned int> candidateOffsets(1, 0);
+        for (size_t placedIndex = 0; placedIndex < orderIndex; placedIndex++)
+        {
+            const TransientBuffer &placed = _buffers[placementOrder[placedIndex]];
+            if (LifetimesOverlap(buffer, placed))
+            {
+                conflicts.push_back(&placed);
+                unsigned int placedEnd = placed._offsetBytes + placed._sizeBytes;
+                candidateOffsets.push_back(((placedEnd + alignmentBytes - 1) / alignmentBytes) * alignmentBytes);
+            }
+        }
+        std::sort(candidateOffsets.begin(), candidateOffsets.end());
+
+        for (size_t candidateIndex = 0; candidateIndex < candidateOffsets.size(); candidateIndex++)
+        {
+            unsigned int begin = candidateOffsets[candidateIndex];
+            unsigned int end = begin + buffer._sizeBytes;
+            bool isClear = true;
+            for (size_t conflictIndex = 0; conflictIndex < conflicts.size() && isClear; conflictIndex++)
+            {
+                const TransientBuffer &other = *conflicts[conflictIndex];
+                isClear = (end <= other._offsetBytes) || (begin >= other._offsetBytes + other._sizeBytes);
+            }
+
+            if (isClear)
+            {
+                buffer._offsetBytes = begin;
+                break;
+            }
+        }
+
+        peakBytes = std::max(peakBytes, buffer._offsetBytes + buffer._sizeBytes);
+    }
+
+    // the arena clears it, so every buffer's first use starts with 0s
+    _poolRange = arenaRef.Allocate(_name, peakBytes, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives the pool's range back to the arena and forgets every buffer, so that they can be 
+    added again with new sizes.  Any SSBOs that were using ranges of it must be gone already.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void TransientBufferPool::Clear()
+{
+    GpuBufferArena::GetInstance().Free(_poolRange);
+    _poolRange = GpuBufferRange();
+    _buffers.clear();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Where one of the buffers ended up.  Bind it with glBindBufferRange(...) like any other
+    arena range (see SsboBase).
+Parameters:
+    bufferIndex     Something that AddBuffer(...) returned.
+Returns:
+    See description.  All 0s if Allocate() hasn't been called or the index is bad.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuBufferRange TransientBufferPool::BufferRange(unsigned int bufferIndex) const
+{
+    GpuBufferRange range;
+    if (_poolRange._bufferId == 0 || bufferIndex >= _buffers.size())
+    {
+        fprintf(stderr, "TransientBufferPool '%s': no buffer %u\n", _name.c_str(), bufferIndex);
+        return range;
+    }
+
+    const TransientBuffer &buffer = _buffers[bufferIndex];
+    range._bufferId = _poolRange._bufferId;
+    range._offsetBytes = _poolRange._offsetBytes + buffer._offsetBytes;
+    range._sizeBytes = buffer._sizeBytes;
+    return range;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    For owners that need to tell MemoryBarrierTracker (or anyone else that goes by binding 
+    points) that two buffers are really the same memory.
+Parameters:
+    bufferIndexA    Something that AddBuffer(...) returned.
+    bufferIndexB    Something that AddBuffer(...) returned.
+Returns:
+    True if Allocate() put any part of the two buffers in the same place, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool TransientBufferPool::BuffersShareMemory(unsigned int bufferIndexA, unsigned int bufferIndexB) const
+{
+    if (bufferIndexA >= _buffers.size() || bufferIndexB >= _buffers.size() || bufferIndexA == bufferIndexB)
+    {
+        return false;
+    }
+
+    const TransientBuffer &a = _buffers[bufferIndexA];
+    const TransientBuffer &b = _buffers[bufferIndexB];
+    return (a._offsetBytes < b._offsetBytes + b._sizeBytes) && (b._offsetBytes < a._offsetBytes + a._sizeBytes);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How much memory the pool actually takes.
+Parameters: None
+Returns:
+    See description.  0 until Allocate().
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int TransientBufferPool::PeakBytes() const
+{
+    return _poolRange._sizeBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How much memory the buffers would take if they each had their own.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int TransientBufferPool::UnaliasedBytes() const
+{
+    unsigned int numBytes = 0;
+    for (size_t bufferIndex = 0; bufferIndex < _buffers.size(); bufferIndex++)
+    {
+        numBytes += _buffers[bufferIndex]._sizeBytes;
+    }
+    return numBytes;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints the layout of the buffers and how much sharing memory saved.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void TransientBufferPool::PrintReport() const
+{
+    unsigned int unaliasedBytes = UnaliasedBytes();
+    unsigned int peakBytes = PeakBytes();
+    printf("transient buffers '%s': %.1lf KB instead of %.1lf KB (%.1lf KB saved)\n",
+        _name.c_str(), peakBytes / 1024.0, unaliasedBytes / 1024.0,
+        (unaliasedBytes > peakBytes) ? (unaliasedBytes - peakBytes) / 1024.0 : 0.0);
+    for (size_t bufferIndex = 0; bufferIndex < _buffers.size(); bufferIndex++)
+    {
+        const TransientBuffer &buffer = _buffers[bufferIndex];
+        printf("    %10u  %10.1lf KB  steps %u-%u  %s\n", buffer._offsetBytes,
+            buffer._sizeBytes / 1024.0, buffer._firstStep, buffer._lastStep, buffer._name.c_str());
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.  The steps are inclusive.
+Parameters:
+    a   Self-explanatory.
+    b   Self-explanatory.
+Returns:
+    True if there is a step where both buffers are alive, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool TransientBufferPool::LifetimesOverlap(const TransientBuffer &a, const TransientBuffer &b)
+{
+    return (a._firstStep <= b._lastStep) && (b._firstStep <= a._lastStep);
+}
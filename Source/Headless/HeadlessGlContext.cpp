@@ -0,0 +1,327 @@
+#include "Include/Headless/HeadlessGlContext.h"
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#pragma comment(lib, "opengl32.lib")
+
+// from wglext.h; not worth including the whole thing for these
+#define WGL_CONTEXT_MAJOR_VERSION_ARB       0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB       0x2092
+#define WGL_CONTEXT_FLAGS_ARB               0x2094
+#define WGL_CONTEXT_PROFILE_MASK_ARB        0x9126
+#define WGL_CONTEXT_DEBUG_BIT_ARB           0x0001
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB    0x00000001
+typedef HGLRC(WINAPI *PFN_WGL_CREATE_CONTEXT_ATTRIBS_ARB)(HDC, HGLRC, const int *);
+
+static const char *HEADLESS_WINDOW_CLASS_NAME = "HeadlessGlContextWindow";
+#else
+#include <string.h>
+#include <EGL/egl.h>
+
+// from eglext.h; the surfaceless platform is a Mesa extension
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA       0x31DD
+#endif
+typedef EGLDisplay(EGLAPIENTRY *PFN_EGL_GET_PLATFORM_DISPLAY_EXT)(EGLenum, void *, const EGLint *);
+#endif
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  Nothing is created until Init(...).
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+HeadlessGlContext::HeadlessGlContext() :
+#ifdef WIN32
+    _windowHandle(0),
+    _deviceContextHandle(0),
+    _glContextHandle(0)
+#else
+    _eglDisplay(0),
+    _eglSurface(0),
+    _eglContext(0)
+#endif
+{
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Releases the context if the user didn't call Cleanup().
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+HeadlessGlContext::~HeadlessGlContext()
+{
+    Cleanup();
+}
+
+#ifdef WIN32
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Creates a window that is never shown, gives it a pixel format that supports OpenGL, and 
+    then makes a context of the requested version with wglCreateContextAttribsARB(...).
+
+    Note: wglCreateContextAttribsARB(...) is an extension function, and extension functions 
+    can only be looked up when a context is current, so a plain old context is made first, 
+    used to look up the function, and then thrown away.
+Parameters: 
+    majorVersion    Ex: 4
+    minorVersion    Ex: 5
+    debugContext    If true, the context will report errors via glDebugMessageCallback(...).
+Returns:
+    True if a context of the requested version is current, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool HeadlessGlContext::Init(int majorVersion, int minorVersion, bool debugContext)
+{
+    HINSTANCE instanceHandle = GetModuleHandle(0);
+    WNDCLASSA windowClass = {};
+    windowClass.style = CS_OWNDC;
+    windowClass.lpfnWndProc = DefWindowProcA;
+    windowClass.hInstance = instanceHandle;
+    windowClass.lpszClassName = HEADLESS_WINDOW_CLASS_NAME;
+    RegisterClassA(&windowClass);
+
+    // never shown (no WS_VISIBLE and no ShowWindow(...))
+    HWND windowHandle = CreateWindowA(HEADLESS_WINDOW_CLASS_NAME, "headless", WS_OVERLAPPEDWINDOW,
+        0, 0, 1, 1, 0, 0, instanceHandle, 0);
+    if (windowHandle == 0)
+    {
+        fprintf(stderr, "HeadlessGlContext: CreateWindow(...) failed\n");
+        return false;
+    }
+    _windowHandle = windowHandle;
+
+    HDC deviceContextHandle = GetDC(windowHandle);
+    _deviceContextHandle = deviceContextHandle;
+
+    PIXELFORMATDESCRIPTOR pfd = {};
+    pfd.nSize = sizeof(pfd);
+    pfd.nVersion = 1;
+    pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+    pfd.iPixelType = PFD_TYPE_RGBA;
+    pfd.cColorBits = 32;
+    pfd.cDepthBits = 24;
+    pfd.iLayerType = PFD_MAIN_PLANE;
+    int pixelFormat = ChoosePixelFormat(deviceContextHandle, &pfd);
+    if (pixelFormat == 0 || !SetPixelFormat(deviceContextHandle, pixelFormat, &pfd))
+    {
+        fprintf(stderr, "HeadlessGlContext: could not set a pixel format\n");
+        Cleanup();
+        return false;
+    }
+
+    HGLRC tempContext = wglCreateContext(deviceContextHandle);
+    if (tempContext == 0 || !wglMakeCurrent(deviceContextHandle, tempContext))
+    {
+        fprintf(stderr, "HeadlessGlContext: could not make a temporary context\n");
+        Cleanup();
+        return false;
+    }
+
+    PFN_WGL_CREATE_CONTEXT_ATTRIBS_ARB wglCreateContextAttribsARB = 
+        (PFN_WGL_CREATE_CONTEXT_ATTRIBS_ARB)wglGetProcAddress("wglCreateContextAttribsARB");
+    wglMakeCurrent(0, 0);
+    wglDeleteContext(tempContext);
+    if (wglCreateContextAttribsARB == 0)
+    {
+        fprintf(stderr, "HeadlessGlContext: wglCreateContextAttribsARB is not supported\n");
+        Cleanup();
+        return false;
+    }
+
+    int contextAttributes[] =
+    {
+        WGL_CONTEXT_MAJOR_VERSION_ARB, majorVersion,
+        WGL_CONTEXT_MINOR_VERSION_ARB, minorVersion,
+        WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+        WGL_CONTEXT_FLAGS_ARB, debugContext ? WGL_CONTEXT_DEBUG_BIT_ARB : 0,
+        0
+    };
+    HGLRC glContextHandle = wglCreateContextAttribsARB(deviceContextHandle, 0, contextAttributes);
+    if (glContextHandle == 0 || !wglMakeCurrent(deviceContextHandle, glContextHandle))
+    {
+        fprintf(stderr, "HeadlessGlContext: could not make an OpenGL %d.%d core context\n", majorVersion, minorVersion);
+        Cleanup();
+        return false;
+    }
+    _glContextHandle = glContextHandle;
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Releases the context, the device context, and the window.  Safe to call more than once.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void HeadlessGlContext::Cleanup()
+{
+    if (_glContextHandle != 0)
+    {
+        wglMakeCurrent(0, 0);
+        wglDeleteContext((HGLRC)_glContextHandle);
+        _glContextHandle = 0;
+    }
+    if (_deviceContextHandle != 0)
+    {
+        ReleaseDC((HWND)_windowHandle, (HDC)_deviceContextHandle);
+        _deviceContextHandle = 0;
+    }
+    if (_windowHandle != 0)
+    {
+        DestroyWindow((HWND)_windowHandle);
+        _windowHandle = 0;
+    }
+}
+
+#else
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gets an EGL display that doesn't need a window system, binds the desktop OpenGL API 
+    (EGL defaults to OpenGL ES), and makes a context of the requested version current without 
+    a surface (or with a 1x1 pbuffer if surfaceless contexts aren't supported).
+Parameters: 
+    majorVersion    Ex: 4
+    minorVersion    Ex: 5
+    debugContext    If true, the context will report errors via glDebugMessageCallback(...).
+Returns:
+    True if a context of the requested version is current, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool HeadlessGlContext::Init(int majorVersion, int minorVersion, bool debugContext)
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions != 0 && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != 0)
+    {
+        PFN_EGL_GET_PLATFORM_DISPLAY_EXT eglGetPlatformDisplayEXT = 
+            (PFN_EGL_GET_PLATFORM_DISPLAY_EXT)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (eglGetPlatformDisplayEXT != 0)
+        {
+            display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+        }
+    }
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint eglMajor = 0;
+    EGLint eglMinor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajor, &eglMinor))
+    {
+        fprintf(stderr, "HeadlessGlContext: could not initialize an EGL display\n");
+        return false;
+    }
+    _eglDisplay = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        fprintf(stderr, "HeadlessGlContext: this EGL implementation doesn't do desktop OpenGL\n");
+        Cleanup();
+        return false;
+    }
+
+    EGLint configAttributes[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = 0;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs == 0)
+    {
+        fprintf(stderr, "HeadlessGlContext: no EGL config supports desktop OpenGL\n");
+        Cleanup();
+        return false;
+    }
+
+    // Note: These are the EGL 1.5 names.  They have the same values as the 
+    // EGL_KHR_create_context ones.
+    EGLint contextAttributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+        EGL_CONTEXT_MINOR_VERSION, minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, debugContext ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        fprintf(stderr, "HeadlessGlContext: could not make an OpenGL %d.%d core context (EGL error 0x%x)\n", 
+            majorVersion, minorVersion, eglGetError());
+        Cleanup();
+        return false;
+    }
+    _eglContext = context;
+
+    const char *displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    bool surfacelessSupported = 
+        (displayExtensions != 0 && strstr(displayExtensions, "EGL_KHR_surfaceless_context") != 0);
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (!surfacelessSupported)
+    {
+        EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, pbufferAttributes);
+        if (surface == EGL_NO_SURFACE)
+        {
+            fprintf(stderr, "HeadlessGlContext: could not make a pbuffer surface\n");
+            Cleanup();
+            return false;
+        }
+        _eglSurface = surface;
+    }
+
+    if (!eglMakeCurrent(display, surface, surface, context))
+    {
+        fprintf(stderr, "HeadlessGlContext: eglMakeCurrent(...) failed (EGL error 0x%x)\n", eglGetError());
+        Cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Releases the context, the surface (if there is one), and the display.  Safe to call more 
+    than once.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void HeadlessGlContext::Cleanup()
+{
+    if (_eglDisplay == 0)
+    {
+        return;
+    }
+
+    eglMakeCurrent(_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (_eglContext != 0)
+    {
+        eglDestroyContext(_eglDisplay, _eglContext);
+        _eglContext = 0;
+    }
+    if (_eglSurface != 0)
+    {
+        eglDestroySurface(_eglDisplay, _eglSurface);
+        _eglSurface = 0;
+    }
+    eglTerminate(_eglDisplay);
+    _eglDisplay = 0;
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include "Include/RenderFrameRate/CpuStageStopwatch.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+Parameters: 
+    numStages   How many EndStage(...) calls there are per frame.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+CpuStageStopwatch::CpuStageStopwatch(unsigned int numStages) :
+    _numStages(numStages),
+    _numFramesMeasured(0)
+{
+    Reset();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Marks the start of the frame's first stage.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuStageStopwatch::StartFrame()
+{
+    _stopwatch.Start();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Records the time since the end of the previous stage (or the start of the frame).  The 
+    last stage of a frame also counts the frame as measured.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuStageStopwatch::EndStage(unsigned int stageIndex)
+{
+    if (stageIndex >= _numStages)
+    {
+        return;
+    }
+
+    double stageTime = _stopwatch.Lap();
+    _totalStageTimes[stageIndex] += stageTime;
+    if (_numFramesMeasured == 0 || stageTime < _minStageTimes[stageIndex])
+    {
+        _minStageTimes[stageIndex] = stageTime;
+    }
+    if (stageTime > _maxStageTimes[stageIndex])
+    {
+        _maxStageTimes[stageIndex] = stageTime;
+    }
+
+    if (stageIndex == _numStages - 1)
+    {
+        _numFramesMeasured++;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Forgets everything that has been measured (after the warmup frames, for example).
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuStageStopwatch::Reset()
+{
+    _numFramesMeasured = 0;
+    _totalStageTimes.assign(_numStages, 0.0);
+    _minStageTimes.assign(_numStages, 0.0);
+    _maxStageTimes.assign(_numStages, 0.0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the value that was passed in on creation.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int CpuStageStopwatch::NumStages() const
+{
+    return _numStages;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of frames whose last stage has ended since the last 
+    Reset().
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int CpuStageStopwatch::NumFramesMeasured() const
+{
+    return _numFramesMeasured;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The average CPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double CpuStageStopwatch::AverageStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return _totalStageTimes[stageIndex] / _numFramesMeasured;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The shortest CPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double CpuStageStopwatch::MinStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return _minStageTimes[stageIndex];
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The longest CPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double CpuStageStopwatch::MaxStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return _maxStageTimes[stageIndex];
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The sum of the average stage times.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double CpuStageStopwatch::AverageFrameTime() const
+{
+    double frameTime = 0.0;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        frameTime += AverageStageTime(stageIndex);
+    }
+    return frameTime;
+}
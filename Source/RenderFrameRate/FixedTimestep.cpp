@@ -0,0 +1,95 @@
+#include "Include/RenderFrameRate/FixedTimestep.h"
+
+#include <math.h>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  Call Start() right before the first frame.
+Parameters: 
+    stepSizeSec         How much simulated time passes in a single step.
+    maxStepsPerFrame    The most steps that StepsThisFrame() will ever return.  0 is bumped up 
+                        to 1.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+FixedTimestep::FixedTimestep(float stepSizeSec, unsigned int maxStepsPerFrame) :
+    _stepSizeSec(stepSizeSec),
+    _maxStepsPerFrame(maxStepsPerFrame),
+    _accumulatedTime(0.0),
+    _numDroppedSteps(0)
+{
+    if (_maxStepsPerFrame == 0)
+    {
+        _maxStepsPerFrame = 1;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Starts the clock.  Time before this (shader compiling, buffer setup, etc.) doesn't count.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void FixedTimestep::Start()
+{
+    _accumulatedTime = 0.0;
+    _timer.Start();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds the time since the last call to the accumulator and takes out as many whole steps as 
+    will fit, up to the max steps per frame.  If there was more time than that, the extra 
+    whole steps are dropped and counted (see NumDroppedSteps()).
+Parameters: None
+Returns:
+    The number of steps to run this frame.  May be 0 if the frames are coming faster than 
+    the step size.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int FixedTimestep::StepsThisFrame()
+{
+    _accumulatedTime += _timer.Lap();
+
+    unsigned int numSteps = static_cast<unsigned int>(_accumulatedTime / _stepSizeSec);
+    if (numSteps > _maxStepsPerFrame)
+    {
+        _numDroppedSteps += numSteps - _maxStepsPerFrame;
+        numSteps = _maxStepsPerFrame;
+
+        // keep the fraction of a step, but throw away the rest
+        _accumulatedTime = fmod(_accumulatedTime, (double)_stepSizeSec) + (numSteps * _stepSizeSec);
+    }
+
+    _accumulatedTime -= numSteps * _stepSizeSec;
+    return numSteps;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The step size that was given to the constructor.  Pass this to the update.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+float FixedTimestep::StepSize() const
+{
+    return _stepSizeSec;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The total number of steps that were thrown away because of the max steps per frame.  If 
+    this keeps going up, the simulation can't keep up with real time.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int FixedTimestep::NumDroppedSteps() const
+{
+    return _numDroppedSteps;
+}
@@ -0,0 +1,213 @@
+#include "Include/RenderFrameRate/FramePacer.h"
+
+#include <stdio.h>
+#include <thread>
+#include <chrono>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values and makes room for one fence per frame in flight.
+
+    Note: A max of 0 frames in flight would mean that BeginFrame() can never succeed, so it 
+    is bumped up to 1 (CPU and GPU in lockstep).
+Parameters: 
+    maxFramesInFlight   How many frames the CPU may issue before the GPU finishes the first.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+FramePacer::FramePacer(unsigned int maxFramesInFlight) :
+    _maxFramesInFlight(maxFramesInFlight),
+    _oldestFrameFence(0),
+    _numFramesInFlight(0),
+    _lastFrameWaitTime(0.0),
+    _totalWaitTime(0.0),
+    _numFramesSinceStatReset(0)
+{
+    if (_maxFramesInFlight == 0)
+    {
+        _maxFramesInFlight = 1;
+    }
+    _frameFences.resize(_maxFramesInFlight, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Cleans up any fences that haven't been waited on yet.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+FramePacer::~FramePacer()
+{
+    for (size_t fenceIndex = 0; fenceIndex < _frameFences.size(); fenceIndex++)
+    {
+        if (_frameFences[fenceIndex] != 0)
+        {
+            glDeleteSync(_frameFences[fenceIndex]);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Call before issuing a frame's commands.  If the max number of frames are already in 
+    flight, this waits until the GPU finishes the oldest of them.
+
+    The wait polls the fence without blocking in the driver.  If the fence isn't ready, the 
+    thread yields the rest of its time slice, and once it has done that a few times in a row, 
+    it sleeps briefly between polls instead.  This gives the core back to the OS instead of 
+    spinning.
+
+    Note: On Windows, std::this_thread::sleep_for(...) can oversleep up to the scheduler's tick 
+    (~1ms if something in the process called timeBeginPeriod(1), ~15ms if not), so yielding comes 
+    first to handle the common case of "GPU almost done" without that penalty.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void FramePacer::BeginFrame()
+{
+    _waitTimer.Start();
+    unsigned int numEmptyPolls = 0;
+    while (_numFramesInFlight >= _maxFramesInFlight)
+    {
+        if (TryRetireOldestFrame())
+        {
+            continue;
+        }
+
+        numEmptyPolls++;
+        if (numEmptyPolls < YIELDS_BEFORE_SLEEPING)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(SLEEP_MICROSECONDS));
+        }
+    }
+
+    _lastFrameWaitTime = _waitTimer.TotalTime();
+    _totalWaitTime += _lastFrameWaitTime;
+    _numFramesSinceStatReset++;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Call after issuing a frame's commands.  Puts a fence behind them so that BeginFrame() can 
+    tell when the GPU is done with them.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void FramePacer::EndFrame()
+{
+    if (_numFramesInFlight >= _maxFramesInFlight)
+    {
+        // BeginFrame() wasn't called; don't lose track of a fence
+        fprintf(stderr, "FramePacer::EndFrame(): %u frames already in flight; call BeginFrame() first\n", _numFramesInFlight);
+        return;
+    }
+
+    unsigned int newestFrameFence = (_oldestFrameFence + _numFramesInFlight) % _maxFramesInFlight;
+    _frameFences[newestFrameFence] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _numFramesInFlight++;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The number of seconds that the most recent BeginFrame() spent waiting on the GPU.
+Parameters: None
+Returns:
+    See Description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double FramePacer::LastFrameWaitTime() const
+{
+    return _lastFrameWaitTime;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The average number of seconds that BeginFrame() spent waiting on the GPU per frame since 
+    the last ResetWaitStats().
+Parameters: None
+Returns:
+    See Description.  0 if no frames have gone by.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double FramePacer::AverageFrameWaitTime() const
+{
+    if (_numFramesSinceStatReset == 0)
+    {
+        return 0.0;
+    }
+    return _totalWaitTime / _numFramesSinceStatReset;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The number of BeginFrame() calls since the last ResetWaitStats().
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int FramePacer::NumFramesSinceStatReset() const
+{
+    return _numFramesSinceStatReset;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Starts the average wait time over.  Useful for once-per-second reporting.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void FramePacer::ResetWaitStats()
+{
+    _totalWaitTime = 0.0;
+    _numFramesSinceStatReset = 0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks, without waiting, if the GPU is done with the oldest frame in flight.  If it is, 
+    the fence is deleted and the frame no longer counts as in flight.
+
+    Note: GL_SYNC_FLUSH_COMMANDS_BIT makes sure that the fence has actually been sent to the 
+    GPU.  Without it, a fence could sit in the driver's queue forever and the poll would never 
+    succeed.
+Parameters: None
+Returns:
+    True if a frame was retired, otherwise false.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool FramePacer::TryRetireOldestFrame()
+{
+    if (_numFramesInFlight == 0)
+    {
+        return false;
+    }
+
+    GLsync oldestFence = _frameFences[_oldestFrameFence];
+    GLenum waitReturn = glClientWaitSync(oldestFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (waitReturn == GL_WAIT_FAILED)
+    {
+        // something is wrong with the fence, so don't wait on it forever
+        fprintf(stderr, "FramePacer: glClientWaitSync(...) failed; dropping the fence\n");
+    }
+    else if (waitReturn != GL_ALREADY_SIGNALED && waitReturn != GL_CONDITION_SATISFIED)
+    {
+        // GL_TIMEOUT_EXPIRED; the GPU isn't done yet
+        return false;
+    }
+
+    glDeleteSync(oldestFence);
+    _frameFences[_oldestFrameFence] = 0;
+    _oldestFrameFence = (_oldestFrameFence + 1) % _maxFramesInFlight;
+    _numFramesInFlight--;
+    return true;
+}
@@ -0,0 +1,267 @@
+#include "Include/RenderFrameRate/GpuStopwatch.h"
+
+#include <stdio.h>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values and generates all the query objects that will ever be needed.
+Parameters: 
+    numStages           How many times EndStage(...) will be called per frame.
+    numFramesInFlight   How many frames of queries to keep around before reading the oldest.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuStopwatch::GpuStopwatch(unsigned int numStages, unsigned int numFramesInFlight) :
+    _numStages(numStages),
+    _numFramesInFlight(numFramesInFlight),
+    _currentFrameSlot(0),
+    _numFramesMeasured(0)
+{
+    if (_numFramesInFlight == 0)
+    {
+        _numFramesInFlight = 1;
+    }
+
+    _queryIds.resize((_numStages + 1) * _numFramesInFlight, 0);
+    glGenQueries(static_cast<GLsizei>(_queryIds.size()), _queryIds.data());
+    _frameSlotPending.resize(_numFramesInFlight, false);
+
+    _totalStageTimes.resize(_numStages);
+    _minStageTimes.resize(_numStages);
+    _maxStageTimes.resize(_numStages);
+    Reset();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Cleans up the query objects.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuStopwatch::~GpuStopwatch()
+{
+    glDeleteQueries(static_cast<GLsizei>(_queryIds.size()), _queryIds.data());
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Moves on to the next frame slot and writes the "frame start" timestamp.  If that slot 
+    still has results from a few frames ago, they are read first.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuStopwatch::StartFrame()
+{
+    _currentFrameSlot = (_currentFrameSlot + 1) % _numFramesInFlight;
+    if (_frameSlotPending[_currentFrameSlot])
+    {
+        HarvestFrame(_currentFrameSlot);
+    }
+
+    unsigned int firstQuery = _currentFrameSlot * (_numStages + 1);
+    glQueryCounter(_queryIds[firstQuery], GL_TIMESTAMP);
+    _frameSlotPending[_currentFrameSlot] = true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Writes the "end of stage" timestamp for the given stage.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuStopwatch::EndStage(unsigned int stageIndex)
+{
+    if (stageIndex >= _numStages)
+    {
+        fprintf(stderr, "GpuStopwatch::EndStage(...): stage index %u is out of range (%u stages)\n", stageIndex, _numStages);
+        return;
+    }
+
+    unsigned int firstQuery = _currentFrameSlot * (_numStages + 1);
+    glQueryCounter(_queryIds[firstQuery + 1 + stageIndex], GL_TIMESTAMP);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Reads the results of every frame that hasn't been read yet.  This waits for the GPU, so 
+    call it after the last frame, not during.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuStopwatch::Finish()
+{
+    // oldest first, not that it matters for the totals
+    for (unsigned int slotCount = 1; slotCount <= _numFramesInFlight; slotCount++)
+    {
+        unsigned int frameSlot = (_currentFrameSlot + slotCount) % _numFramesInFlight;
+        if (_frameSlotPending[frameSlot])
+        {
+            HarvestFrame(frameSlot);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Throws away the measurements so far.  Useful for skipping warmup frames.  
+
+    Note: Frames that were issued but not yet read will still be counted when they are read.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuStopwatch::Reset()
+{
+    _numFramesMeasured = 0;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        _totalStageTimes[stageIndex] = 0;
+        _minStageTimes[stageIndex] = ~GLuint64(0);
+        _maxStageTimes[stageIndex] = 0;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The number of stages that were given to the constructor.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuStopwatch::NumStages() const
+{
+    return _numStages;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The number of frames whose results have been read since the last Reset().
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuStopwatch::NumFramesMeasured() const
+{
+    return _numFramesMeasured;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The average GPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double GpuStopwatch::AverageStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return (double)_totalStageTimes[stageIndex] / _numFramesMeasured / 1000000000.0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The shortest GPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double GpuStopwatch::MinStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return (double)_minStageTimes[stageIndex] / 1000000000.0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    stageIndex  0 to NumStages() - 1.
+Returns:
+    The longest GPU time of the stage in fractions of a second, or 0 if nothing has been 
+    measured.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double GpuStopwatch::MaxStageTime(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages || _numFramesMeasured == 0)
+    {
+        return 0.0;
+    }
+    return (double)_maxStageTimes[stageIndex] / 1000000000.0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The sum of all the stages' average times.
+Parameters: None
+Returns:
+    See Description.  In fractions of a second.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double GpuStopwatch::AverageFrameTime() const
+{
+    double frameTime = 0.0;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        frameTime += AverageStageTime(stageIndex);
+    }
+    return frameTime;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Reads a frame's timestamps and adds the differences to the stage totals.
+
+    Note: GL_QUERY_RESULT waits if the result isn't ready yet.  By the time a slot comes 
+    around again, it has been a few frames, so it is almost always ready.
+Parameters: 
+    frameSlot   Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuStopwatch::HarvestFrame(unsigned int frameSlot)
+{
+    unsigned int firstQuery = frameSlot * (_numStages + 1);
+    GLuint64 previousTimestamp = 0;
+    glGetQueryObjectui64v(_queryIds[firstQuery], GL_QUERY_RESULT, &previousTimestamp);
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(_queryIds[firstQuery + 1 + stageIndex], GL_QUERY_RESULT, &timestamp);
+        GLuint64 stageTime = (timestamp > previousTimestamp) ? (timestamp - previousTimestamp) : 0;
+        previousTimestamp = timestamp;
+
+        _totalStageTimes[stageIndex] += stageTime;
+        if (stageTime < _minStageTimes[stageIndex])
+        {
+            _minStageTimes[stageIndex] = stageTime;
+        }
+        if (stageTime > _maxStageTimes[stageIndex])
+        {
+            _maxStageTimes[stageIndex] = stageTime;
+        }
+    }
+
+    _numFramesMeasured++;
+    _frameSlotPending[frameSlot] = false;
+}
@@ -22,7 +22,7 @@ Creator:    John Cox, 3/2017
 ------------------------------------------------------------------------------------------------*/
 void Stopwatch::Start()
 {
-    _startTime = std::chrono::high_resolution_clock::now();
+    _startTime = std::chrono::steady_clock::now();
     _lastLapTime = _startTime;
 }
 
@@ -40,10 +40,10 @@ double Stopwatch::Lap()
 {
     using namespace std::chrono;
 
-    // there is no performance penalty to using high_resolution_clock over something else (like 
-    // steady_clock) it always reads the CPU's clock counter and then converts that into 
-    // whatever time span the user wants 
-    steady_clock::time_point currentTime = high_resolution_clock::now();
+    // Note: This used to call high_resolution_clock::now(), which is steady_clock in Visual 
+    // Studio but system_clock in GCC's library, so it didn't compile on Linux (and 
+    // system_clock can jump).  steady_clock reads the same counter on Windows anyway.
+    steady_clock::time_point currentTime = steady_clock::now();
     unsigned int deltaTime = duration_cast<microseconds>(currentTime - _lastLapTime).count();
     _lastLapTime = currentTime;
 
@@ -65,7 +65,7 @@ Creator:    John Cox, 3/2017
 double Stopwatch::TotalTime()
 {
     using namespace std::chrono;
-    steady_clock::time_point currentTime = high_resolution_clock::now();
+    steady_clock::time_point currentTime = steady_clock::now();
     unsigned int microsecondsPassed =
         duration_cast<microseconds>(currentTime - _startTime).count();
 
@@ -0,0 +1,523 @@
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+
+#include "Shaders/ShaderStorage.h"
+#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+
+
+namespace ShaderControllers
+{
+    // also the names in the profile file, so no spaces
+    static const char *COMPUTE_STAGE_NAMES[NUM_COMPUTE_STAGES] =
+    {
+        "reset",
+        "update",
+        "sort_keys",
+        "sort_get_bit",
+        "sort_prefix_scan",
+        "sort_scatter",
+        "sort_gather",
+        "collide",
+        "count_nearby",
+    };
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Self-explanatory.
+    Parameters:
+        stage   Self-explanatory.
+    Returns:
+        A short name without spaces, or "unknown".
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    const char *ComputeStageName(ComputeStage stage)
+    {
+        if (stage < 0 || stage >= NUM_COMPUTE_STAGES)
+        {
+            return "unknown";
+        }
+
+        return COMPUTE_STAGE_NAMES[stage];
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The sort's programs use PARALLEL_SORT_WORK_GROUP_SIZE_X and the prefix scan buffer,
+        while the others use PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X.
+    Parameters:
+        stage   Self-explanatory.
+    Returns:
+        True if the stage is one of ParallelSort's programs.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool IsParallelSortStage(ComputeStage stage)
+    {
+        return stage >= COMPUTE_STAGE_SORT_KEYS && stage <= COMPUTE_STAGE_SORT_GATHER;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The sizes in ComputeShaderWorkGroupSizes.comp and no feature defines.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    ComputeShaderVariant::ComputeShaderVariant() :
+        ComputeShaderVariant(PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X, PARALLEL_SORT_WORK_GROUP_SIZE_X)
+    {
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Gives every particle stage one size and every sort stage another, all at 1 item per
+        thread (2 for the prefix scan).  Nothing is checked until IsSupported(...).
+    Parameters:
+        particleOperationsWorkGroupSizeX    Threads per work group for reset, update, collide,
+                                            and the nearby count.
+        parallelSortWorkGroupSizeX          Threads per work group for the sort.  Must be a
+                                            power of 2.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    ComputeShaderVariant::ComputeShaderVariant(unsigned int particleOperationsWorkGroupSizeX,
+        unsigned int parallelSortWorkGroupSizeX)
+    {
+        for (int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+        {
+            ComputeStage stage = static_cast<ComputeStage>(stageIndex);
+            _workGroupSizesX[stage] = IsParallelSortStage(stage) ? parallelSortWorkGroupSizeX : particleOperationsWorkGroupSizeX;
+            _itemsPerThread[stage] = (stage == COMPUTE_STAGE_SORT_PREFIX_SCAN) ? 2 : 1;
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Sets one stage's work group size and the number of items that each of its threads
+        works on.  Nothing is checked until IsSupported(...).
+    Parameters:
+        stage           Self-explanatory.
+        workGroupSizeX  Threads per work group.
+        itemsPerThread  Must be 2 for the prefix scan.  Anything 1 or more for the others.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ComputeShaderVariant::SetStage(ComputeStage stage, unsigned int workGroupSizeX, unsigned int itemsPerThread)
+    {
+        _workGroupSizesX[stage] = workGroupSizeX;
+        _itemsPerThread[stage] = itemsPerThread;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Adds a "#define name value" that will go into every compute shader built from this
+        variant.  The shaders can test for it with #ifdef or use its value.
+    Parameters:
+        name    The macro name.
+        value   Defaults to 1 so that a plain switch can be tested with #if.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ComputeShaderVariant::AddFeatureDefine(const std::string &name, const std::string &value)
+    {
+        _featureDefines.push_back({ name, value });
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A simple getter for the number of threads per work group for the given stage.
+    Parameters:
+        stage   Self-explanatory.
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::WorkGroupSizeX(ComputeStage stage) const
+    {
+        return _workGroupSizesX[stage];
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A simple getter for the number of items that each of the stage's threads works on.
+    Parameters:
+        stage   Self-explanatory.
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::ItemsPerThread(ComputeStage stage) const
+    {
+        return _itemsPerThread[stage];
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Self-explanatory.
+    Parameters:
+        stage   Self-explanatory.
+    Returns:
+        Work group size * items per thread.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::ItemsPerWorkGroup(ComputeStage stage) const
+    {
+        return _workGroupSizesX[stage] * _itemsPerThread[stage];
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The dispatch math for a 1-dimensional stage.  Rounds up so that every item gets a
+        thread, so the shaders must ignore the items past the end.
+    Parameters:
+        stage       Self-explanatory.
+        numItems    How many things the stage works on (particles, particle pairs, prefix
+                    sums, etc.).
+    Returns:
+        The number of work groups in X.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::NumWorkGroups(ComputeStage stage, unsigned int numItems) const
+    {
+        unsigned int itemsPerWorkGroup = ItemsPerWorkGroup(stage);
+        unsigned int numWorkGroups = numItems / itemsPerWorkGroup;
+        numWorkGroups += (numItems % itemsPerWorkGroup == 0) ? 0 : 1;
+        return numWorkGroups;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The runtime version of PARALLEL_SORT_ITEMS_PER_WORK_GROUP.  This is the prefix scan's
+        items per work group, and it sets the size of the prefix scan buffer's
+        PrefixSumsOfWorkGroupSums for all of the sort's programs.
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::ParallelSortItemsPerWorkGroup() const
+    {
+        return ItemsPerWorkGroup(COMPUTE_STAGE_SORT_PREFIX_SCAN);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The prefix scan sums within each work group and then runs once more over the work
+        group sums, which must all fit in one work group, so it can handle (items per work
+        group)^2 items.  1024 * 1024 = 1,048,576 with the default size.
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int ComputeShaderVariant::ParallelSortMaxItems() const
+    {
+        return ParallelSortItemsPerWorkGroup() * ParallelSortItemsPerWorkGroup();
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Checks the variant against the current context's compute limits (work group size, 
+        invocations, shared memory, and the number of work groups in one dispatch) and against 
+        what the sort can handle.  Requires a current OpenGL context.
+
+        Prints the reason for any failure to stderr.
+    Parameters:
+        numParticles    The particle buffer size that the variant will be used with.
+    Returns:
+        True if the shaders built from this variant will compile and sort correctly.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool ComputeShaderVariant::IsSupported(unsigned int numParticles) const
+    {
+        GLint maxWorkGroupSizeX = 0;
+        GLint maxInvocations = 0;
+        GLint maxSharedMemoryBytes = 0;
+        GLint maxWorkGroupCountX = 0;
+        glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, 0, &maxWorkGroupSizeX);
+        glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxWorkGroupCountX);
+        // Note: glload calls GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS by its pre-release name.
+        glGetIntegerv(GL_MAX_COMPUTE_LOCAL_INVOCATIONS, &maxInvocations);
+        glGetIntegerv(GL_MAX_COMPUTE_SHARED_MEMORY_SIZE, &maxSharedMemoryBytes);
+        unsigned int maxThreads = (unsigned int)((maxWorkGroupSizeX < maxInvocations) ? maxWorkGroupSizeX : maxInvocations);
+
+        bool isSupported = true;
+        for (int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+        {
+            ComputeStage stage = static_cast<ComputeStage>(stageIndex);
+            if (_workGroupSizesX[stage] == 0 || _workGroupSizesX[stage] > maxThreads)
+            {
+                fprintf(stderr, "%s work group size %u is outside of [1, %u]\n",
+                    ComputeStageName(stage), _workGroupSizesX[stage], maxThreads);
+                isSupported = false;
+            }
+            if (_itemsPerThread[stage] == 0)
+            {
+                fprintf(stderr, "%s needs at least 1 item per thread\n", ComputeStageName(stage));
+                isSupported = false;
+            }
+        }
+
+        // the prefix scan is a binary tree within each work group
+        unsigned int scanWorkGroupSize = _workGroupSizesX[COMPUTE_STAGE_SORT_PREFIX_SCAN];
+        bool isPowerOf2 = (scanWorkGroupSize != 0) && ((scanWorkGroupSize & (scanWorkGroupSize - 1)) == 0);
+        if (!isPowerOf2)
+        {
+            fprintf(stderr, "sort_prefix_scan work group size %u must be a power of 2\n", scanWorkGroupSize);
+            isSupported = false;
+        }
+        if (_itemsPerThread[COMPUTE_STAGE_SORT_PREFIX_SCAN] != 2)
+        {
+            fprintf(stderr, "sort_prefix_scan always works on 2 items per thread, not %u\n",
+                _itemsPerThread[COMPUTE_STAGE_SORT_PREFIX_SCAN]);
+            isSupported = false;
+        }
+        if (isSupported)
+        {
+            // ParallelPrefixScan.comp's shared array
+            unsigned int sharedMemoryBytes = ParallelSortItemsPerWorkGroup() * sizeof(unsigned int);
+            if (sharedMemoryBytes > (unsigned int)maxSharedMemoryBytes)
+            {
+                fprintf(stderr, "sort_prefix_scan work group size %u needs %u bytes of shared memory (max %d)\n",
+                    scanWorkGroupSize, sharedMemoryBytes, maxSharedMemoryBytes);
+                isSupported = false;
+            }
+
+            if (numParticles > ParallelSortMaxItems())
+            {
+                fprintf(stderr, "sort_prefix_scan work group size %u can sort at most %u particles, not %u\n",
+                    scanWorkGroupSize, ParallelSortMaxItems(), numParticles);
+                isSupported = false;
+            }
+
+            // small work groups on a big buffer can need more work groups than one dispatch 
+            // can have
+            // Note: The sort's stages run over the prefix scan buffer, which is the particle 
+            // count rounded up to a whole number of prefix scan work groups (see PrefixSumSsbo).
+            unsigned int numSortItems = NumWorkGroups(COMPUTE_STAGE_SORT_PREFIX_SCAN, numParticles) * ParallelSortItemsPerWorkGroup();
+            for (int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+            {
+                ComputeStage stage = static_cast<ComputeStage>(stageIndex);
+                unsigned int numItems = IsParallelSortStage(stage) ? numSortItems : numParticles;
+                unsigned int numWorkGroups = NumWorkGroups(stage, numItems);
+                if (numWorkGroups > (unsigned int)maxWorkGroupCountX)
+                {
+                    fprintf(stderr, "%s needs %u work groups for %u particles (max %d)\n",
+                        ComputeStageName(stage), numWorkGroups, numParticles, maxWorkGroupCountX);
+                    isSupported = false;
+                }
+            }
+        }
+
+        return isSupported;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Describes the variant for printing.
+    Parameters: None
+    Returns:
+        Something like "reset 512x1, update 256x2, ..., FOO=1".
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    std::string ComputeShaderVariant::Name() const
+    {
+        std::string name;
+        for (int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+        {
+            ComputeStage stage = static_cast<ComputeStage>(stageIndex);
+            name += (stageIndex == 0) ? "" : ", ";
+            name += std::string(ComputeStageName(stage)) + " " + std::to_string(_workGroupSizesX[stage]) +
+                "x" + std::to_string(_itemsPerThread[stage]);
+        }
+        for (size_t defineIndex = 0; defineIndex < _featureDefines.size(); defineIndex++)
+        {
+            name += ", " + _featureDefines[defineIndex].first + "=" + _featureDefines[defineIndex].second;
+        }
+
+        return name;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Every variant of a program needs its own ShaderStorage key, but only the settings that
+        go into that program's defines (see AddDefinesToProgram(...)) are part of it, so that
+        variants that differ in other stages share the program.
+    Parameters:
+        baseProgramKey  The key that the controller would use without variants.
+        stage           The stage that the program is for.
+    Returns:
+        The base key with the stage's settings tacked on.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    std::string ComputeShaderVariant::ProgramKey(const std::string &baseProgramKey, ComputeStage stage) const
+    {
+        std::string key = baseProgramKey + " (" + std::to_string(_workGroupSizesX[stage]) + "x" +
+            std::to_string(_itemsPerThread[stage]);
+        if (IsParallelSortStage(stage))
+        {
+            key += ", scan " + std::to_string(ParallelSortItemsPerWorkGroup());
+        }
+        for (size_t defineIndex = 0; defineIndex < _featureDefines.size(); defineIndex++)
+        {
+            key += ", " + _featureDefines[defineIndex].first + "=" + _featureDefines[defineIndex].second;
+        }
+
+        return key + ")";
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Tells ShaderStorage to put the stage's work group size, items per thread, and the
+        feature defines into the program's shaders.  Call after NewCompositeShader(...) and
+        before CompileCompositeShader(...).
+
+        Note: ComputeShaderWorkGroupSizes.comp only defines these if they aren't already
+        defined, and these go ahead of it.
+    Parameters:
+        programKey  Self-explanatory.
+        stage       The stage that the program is for.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ComputeShaderVariant::AddDefinesToProgram(const std::string &programKey, ComputeStage stage) const
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (IsParallelSortStage(stage))
+        {
+            shaderStorageRef.AddShaderDefine(programKey, "PARALLEL_SORT_WORK_GROUP_SIZE_X",
+                std::to_string(_workGroupSizesX[stage]));
+            shaderStorageRef.AddShaderDefine(programKey, "PARALLEL_SORT_ITEMS_PER_WORK_GROUP",
+                std::to_string(ParallelSortItemsPerWorkGroup()));
+        }
+        else
+        {
+            shaderStorageRef.AddShaderDefine(programKey, "PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X",
+                std::to_string(_workGroupSizesX[stage]));
+        }
+        shaderStorageRef.AddShaderDefine(programKey, "WORK_GROUP_ITEMS_PER_THREAD",
+            std::to_string(_itemsPerThread[stage]));
+        for (size_t defineIndex = 0; defineIndex < _featureDefines.size(); defineIndex++)
+        {
+            shaderStorageRef.AddShaderDefine(programKey, _featureDefines[defineIndex].first,
+                _featureDefines[defineIndex].second);
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Reads the stage settings from a file that SaveProfile(...) wrote.  Stages that aren't
+        in the file keep their current settings, and the feature defines are left alone.
+
+        A profile is only good for the renderer that it was measured on, so a profile from a
+        different renderer is ignored.  Requires a current OpenGL context.
+
+        Prints the reason for any failure to stderr, except for a missing file, which just
+        means that nobody has run the tuner on this machine yet.
+    Parameters:
+        filePath    Self-explanatory.
+    Returns:
+        True if the file was loaded, otherwise false (and nothing changed).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool ComputeShaderVariant::LoadProfile(const std::string &filePath)
+    {
+        std::ifstream profileFile(filePath);
+        if (!profileFile.is_open())
+        {
+            return false;
+        }
+
+        // load into a copy so that a bad file doesn't leave a half-loaded variant
+        ComputeShaderVariant loaded = *this;
+        std::string thisRenderer = (const char *)glGetString(GL_RENDERER);
+        bool foundRenderer = false;
+        std::string line;
+        unsigned int lineNumber = 0;
+        while (std::getline(profileFile, line))
+        {
+            lineNumber++;
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream lineStream(line);
+            std::string name;
+            lineStream >> name;
+            if (name == "renderer")
+            {
+                std::string profileRenderer;
+                std::getline(lineStream >> std::ws, profileRenderer);
+                if (profileRenderer != thisRenderer)
+                {
+                    fprintf(stderr, "compute profile '%s' was measured on '%s', not '%s'; ignoring it\n",
+                        filePath.c_str(), profileRenderer.c_str(), thisRenderer.c_str());
+                    return false;
+                }
+                foundRenderer = true;
+                continue;
+            }
+
+            int stageIndex = 0;
+            while (stageIndex < NUM_COMPUTE_STAGES && name != COMPUTE_STAGE_NAMES[stageIndex])
+            {
+                stageIndex++;
+            }
+            unsigned int workGroupSizeX = 0;
+            unsigned int itemsPerThread = 0;
+            if (stageIndex == NUM_COMPUTE_STAGES || !(lineStream >> workGroupSizeX >> itemsPerThread))
+            {
+                fprintf(stderr, "compute profile '%s', line %u: expected '<stage> <work group size> <items per thread>', got '%s'\n",
+                    filePath.c_str(), lineNumber, line.c_str());
+                return false;
+            }
+            loaded.SetStage(static_cast<ComputeStage>(stageIndex), workGroupSizeX, itemsPerThread);
+        }
+
+        if (!foundRenderer)
+        {
+            fprintf(stderr, "compute profile '%s' doesn't say what renderer it is for; ignoring it\n", filePath.c_str());
+            return false;
+        }
+
+        *this = loaded;
+        return true;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Writes the current renderer and each stage's settings in a form that LoadProfile(...)
+        can read.  The feature defines aren't saved because they change what the shaders do,
+        not just how fast they do it.  Requires a current OpenGL context.
+    Parameters:
+        filePath    Self-explanatory.
+    Returns:
+        True if the file was written, otherwise false.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool ComputeShaderVariant::SaveProfile(const std::string &filePath) const
+    {
+        std::ofstream profileFile(filePath, std::ios::trunc);
+        if (!profileFile.is_open())
+        {
+            fprintf(stderr, "Could not open compute profile '%s' for writing\n", filePath.c_str());
+            return false;
+        }
+
+        profileFile << "# compute shader work group sizes, measured by the headless runner's --tune" << std::endl;
+        profileFile << "# <stage> <work group size> <items per thread>" << std::endl;
+        profileFile << "renderer " << (const char *)glGetString(GL_RENDERER) << std::endl;
+        for (int stageIndex = 0; stageIndex < NUM_COMPUTE_STAGES; stageIndex++)
+        {
+            profileFile << COMPUTE_STAGE_NAMES[stageIndex] << " " << _workGroupSizesX[stageIndex] <<
+                " " << _itemsPerThread[stageIndex] << std::endl;
+        }
+
+        return profileFile.good();
+    }
+}
@@ -3,13 +3,16 @@
 #include <string>
 
 #include "Shaders/ShaderStorage.h"
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 
 namespace ShaderControllers
 {
+    // the ShaderStorage key
+    static const std::string COUNT_NEARBY_PARTICLES_SHADER_KEY = "count nearby particles";
+
     /*--------------------------------------------------------------------------------------------
     Description:
         Gives members initial values.
@@ -21,34 +24,27 @@ namespace ShaderControllers
         non-const to const by copying to a new shared pointer.
     Parameters: 
         particlesToAnalyze  A copy of a const shared pointer to the particle SSBO.
+        variant         The work group sizes and feature defines to build the shaders with.
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
-    CountNearbyParticles::CountNearbyParticles(const ParticleSsbo::CONST_SHARED_PTR particlesToAnalyze) :
+    CountNearbyParticles::CountNearbyParticles(const ParticleSsbo::CONST_SHARED_PTR particlesToAnalyze,
+        const ComputeShaderVariant &variant) :
+        _variant(variant),
         _totalParticleCount(0),
-        _computeProgramId(0)
+        _computeProgramId(0),
+        _countGraph("count nearby particles")
     {
         _totalParticleCount = particlesToAnalyze->NumItems();
 
-        // construct the compute shader
-        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        SubmitShaders(variant);
 
-        std::string shaderKey = "count nearby particles";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-            shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleRegionBoundaries.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/PositionToMortonCode.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/CountNearbyParticlesLimits.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/CountNearbyParticles.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _computeProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        std::string programKey = _variant.ProgramKey(COUNT_NEARBY_PARTICLES_SHADER_KEY, COMPUTE_STAGE_COUNT_NEARBY);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        _computeProgramId = shaderStorageRef.GetShaderProgram(programKey);
         particlesToAnalyze->ConfigureConstantUniforms(_computeProgramId);
 
+        BuildCountGraph();
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -61,7 +57,53 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     CountNearbyParticles::~CountNearbyParticles()
     {
-        glDeleteProgram(_computeProgramId);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(COUNT_NEARBY_PARTICLES_SHADER_KEY, COMPUTE_STAGE_COUNT_NEARBY));
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The particle buffer grew (see ParticleSsbo::Resize(...)), so the program's buffer size 
+        uniform is set again and the graph is rebuilt with the new dispatch size.
+    Parameters:
+        resizedSsbo     The same SSBO that was given to the constructor.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void CountNearbyParticles::ParticleBufferResized(const ParticleSsbo::CONST_SHARED_PTR resizedSsbo)
+    {
+        _totalParticleCount = resizedSsbo->NumItems();
+        resizedSsbo->ConfigureConstantUniforms(_computeProgramId);
+
+        _countGraph.Clear();
+        BuildCountGraph();
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the shader program and hands it to ShaderStorage to compile and link.  Does 
+        not wait for the driver to finish it (see ParallelSort::SubmitShaders()).
+
+        Does nothing if the program was already submitted.
+    Parameters:
+        variant     The work group sizes and feature defines to build the shaders with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void CountNearbyParticles::SubmitShaders(const ComputeShaderVariant &variant)
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (shaderStorageRef.ProgramExists(variant.ProgramKey(COUNT_NEARBY_PARTICLES_SHADER_KEY, COMPUTE_STAGE_COUNT_NEARBY)))
+        {
+            return;
+        }
+
+        std::string shaderKey = variant.ProgramKey(COUNT_NEARBY_PARTICLES_SHADER_KEY, COMPUTE_STAGE_COUNT_NEARBY);
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        variant.AddDefinesToProgram(shaderKey, COMPUTE_STAGE_COUNT_NEARBY);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/CountNearbyParticles.comp");
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -71,17 +113,34 @@ namespace ShaderControllers
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
-    void CountNearbyParticles::Count() const
+    void CountNearbyParticles::Count()
     {
-        glUseProgram(_computeProgramId);
-
-        GLuint numWorkGroupsX = (_totalParticleCount / PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X) + 1;
-        GLuint numWorkGroupsY = 1;
-        GLuint numWorkGroupsZ = 1;
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+        _countGraph.Execute();
+    }
 
-        // cleanup
-        glUseProgram(0);
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Declares the one stage and the buffers that it touches.  The dispatch graph works out 
+        the barriers.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void CountNearbyParticles::BuildCountGraph()
+    {
+        std::vector<BufferAccess> countAccesses =
+        {
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+            BufferAccess(PARTICLE_RENDER_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        _countGraph.AddStage("count nearby particles", countAccesses, [this]()
+        {
+            glUseProgram(_computeProgramId);
+            GLuint numWorkGroupsX = (_totalParticleCount / _variant.ItemsPerWorkGroup(COMPUTE_STAGE_COUNT_NEARBY)) + 1;
+            GLuint numWorkGroupsY = 1;
+            GLuint numWorkGroupsZ = 1;
+            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+            glUseProgram(0);
+        });
     }
 }
@@ -0,0 +1,246 @@
+#include "Include/ShaderControllers/DispatchGraph.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+
+namespace ShaderControllers
+{
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Gives members initial values.
+    Parameters:
+        name    Only used by PrintSchedule().
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    DispatchGraph::DispatchGraph(const std::string &name) :
+        _name(name),
+        _isScheduled(false)
+    {
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Adds a stage after all the stages that have already been added.  The stages will be
+        re-scheduled on the next Execute().
+    Parameters:
+        stageName       Only used by PrintSchedule().
+        accesses        Every buffer that the stage's commands touch and how they touch it.
+        issueCommands   Issues the stage's GL commands.  Must not issue barriers of its own.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void DispatchGraph::AddStage(const std::string &stageName,
+        const std::vector<BufferAccess> &accesses, const std::function<void()> &issueCommands)
+    {
+        Stage newStage;
+        newStage._name = stageName;
+        newStage._accesses = accesses;
+        newStage._issueCommands = issueCommands;
+        newStage._level = 0;
+        _stages.push_back(newStage);
+        _isScheduled = false;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Removes every stage so that the graph can be built again (the particle buffer grew, 
+        etc.).
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void DispatchGraph::Clear()
+    {
+        _stages.clear();
+        _issueOrder.clear();
+        _levelStarts.clear();
+        _isScheduled = false;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Issues every stage, level by level, with the narrowest barrier that each level needs in
+        front of it.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void DispatchGraph::Execute()
+    {
+        if (!_isScheduled)
+        {
+            Schedule();
+        }
+
+        MemoryBarrierTracker &barrierTrackerRef = MemoryBarrierTracker::GetInstance();
+        for (size_t levelIndex = 0; levelIndex + 1 < _levelStarts.size(); levelIndex++)
+        {
+            unsigned int levelBegin = _levelStarts[levelIndex];
+            unsigned int levelEnd = _levelStarts[levelIndex + 1];
+
+            // the stages within a level don't touch each other's buffers, so their barriers
+            // can all be issued up front
+            GLbitfield levelBarrierBits = 0;
+            for (unsigned int orderIndex = levelBegin; orderIndex < levelEnd; orderIndex++)
+            {
+                const Stage &stage = _stages[_issueOrder[orderIndex]];
+                for (size_t accessIndex = 0; accessIndex < stage._accesses.size(); accessIndex++)
+                {
+                    levelBarrierBits |= barrierTrackerRef.BarrierBitsFor(stage._accesses[accessIndex]);
+                }
+            }
+            barrierTrackerRef.IssueBarrier(levelBarrierBits);
+
+            for (unsigned int orderIndex = levelBegin; orderIndex < levelEnd; orderIndex++)
+            {
+                const Stage &stage = _stages[_issueOrder[orderIndex]];
+                stage._issueCommands();
+                for (size_t accessIndex = 0; accessIndex < stage._accesses.size(); accessIndex++)
+                {
+                    barrierTrackerRef.RecordAccess(stage._accesses[accessIndex]);
+                }
+            }
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A simple getter for the number of stages.
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int DispatchGraph::NumStages() const
+    {
+        return static_cast<unsigned int>(_stages.size());
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Returns the number of levels that the stages were scheduled into, which is also the
+        most barriers that one Execute() can issue.
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int DispatchGraph::NumLevels()
+    {
+        if (!_isScheduled)
+        {
+            Schedule();
+        }
+
+        return static_cast<unsigned int>(_levelStarts.size() - 1);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Prints each level and the stages in it.  Handy for checking that stages that should be
+        independent actually ended up that way.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void DispatchGraph::PrintSchedule()
+    {
+        if (!_isScheduled)
+        {
+            Schedule();
+        }
+
+        printf("dispatch graph '%s': %u stages in %u levels\n", _name.c_str(), NumStages(),
+            NumLevels());
+        for (size_t levelIndex = 0; levelIndex + 1 < _levelStarts.size(); levelIndex++)
+        {
+            printf("    level %u:", static_cast<unsigned int>(levelIndex));
+            for (unsigned int orderIndex = _levelStarts[levelIndex]; orderIndex < _levelStarts[levelIndex + 1]; orderIndex++)
+            {
+                printf(" '%s'", _stages[_issueOrder[orderIndex]]._name.c_str());
+            }
+            printf("\n");
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Two stages conflict if they touch the same buffer and at least one of them writes it.
+        Two reads of the same buffer can happen in either order.
+    Parameters:
+        earlier     The stage that was declared first.
+        later       The stage that was declared second.
+    Returns:
+        True if "later" must be issued after "earlier", otherwise false.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool DispatchGraph::StagesConflict(const Stage &earlier, const Stage &later)
+    {
+        for (size_t earlierIndex = 0; earlierIndex < earlier._accesses.size(); earlierIndex++)
+        {
+            const BufferAccess &earlierAccess = earlier._accesses[earlierIndex];
+            for (size_t laterIndex = 0; laterIndex < later._accesses.size(); laterIndex++)
+            {
+                const BufferAccess &laterAccess = later._accesses[laterIndex];
+                if (earlierAccess._bufferBinding == laterAccess._bufferBinding &&
+                    (earlierAccess._isWrite || laterAccess._isWrite))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assigns every stage a level and sorts the issue order by level.  O(stages^2), but it
+        only runs once and the largest graph (the radix sort) has ~130 stages.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void DispatchGraph::Schedule()
+    {
+        unsigned int numLevels = 0;
+        for (size_t laterIndex = 0; laterIndex < _stages.size(); laterIndex++)
+        {
+            Stage &laterStage = _stages[laterIndex];
+            laterStage._level = 0;
+            for (size_t earlierIndex = 0; earlierIndex < laterIndex; earlierIndex++)
+            {
+                const Stage &earlierStage = _stages[earlierIndex];
+                if (earlierStage._level + 1 > laterStage._level &&
+                    StagesConflict(earlierStage, laterStage))
+                {
+                    laterStage._level = earlierStage._level + 1;
+                }
+            }
+            numLevels = std::max(numLevels, laterStage._level + 1);
+        }
+
+        _issueOrder.resize(_stages.size());
+        for (size_t stageIndex = 0; stageIndex < _stages.size(); stageIndex++)
+        {
+            _issueOrder[stageIndex] = static_cast<unsigned int>(stageIndex);
+        }
+        std::stable_sort(_issueOrder.begin(), _issueOrder.end(),
+            [this](unsigned int a, unsigned int b) { return _stages[a]._level < _stages[b]._level; });
+
+        _levelStarts.assign(numLevels + 1, 0);
+        for (size_t stageIndex = 0; stageIndex < _stages.size(); stageIndex++)
+        {
+            // count, then prefix sum, so that _levelStarts[n] is where level n starts
+            _levelStarts[_stages[stageIndex]._level + 1]++;
+        }
+        for (unsigned int levelIndex = 0; levelIndex < numLevels; levelIndex++)
+        {
+            _levelStarts[levelIndex + 1] += _levelStarts[levelIndex];
+        }
+
+        _isScheduled = true;
+    }
+}
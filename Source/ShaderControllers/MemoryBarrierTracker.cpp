@@ -0,0 +1,186 @@
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
+
+
+namespace ShaderControllers
+{
+    // every consumer that a shader's write might need to be made visible to
+    static const GLbitfield ALL_TRACKED_BARRIER_BITS =
+        GL_SHADER_STORAGE_BARRIER_BIT |
+        GL_ATOMIC_COUNTER_BARRIER_BIT |
+        GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+        GL_COMMAND_BARRIER_BIT |
+        GL_BUFFER_UPDATE_BARRIER_BIT |
+        GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT;
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Maps an access type to the glMemoryBarrier(...) bit that makes prior shader writes
+        visible to it.
+    Parameters:
+        accessType  Self-explanatory
+    Returns:
+        One GL_*_BARRIER_BIT.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    GLbitfield BarrierBitForAccessType(BufferAccessType accessType)
+    {
+        switch (accessType)
+        {
+        case BufferAccessType::SHADER_STORAGE:
+            return GL_SHADER_STORAGE_BARRIER_BIT;
+        case BufferAccessType::ATOMIC_COUNTER:
+            return GL_ATOMIC_COUNTER_BARRIER_BIT;
+        case BufferAccessType::VERTEX_ATTRIB:
+            return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+        case BufferAccessType::COMMAND:
+            return GL_COMMAND_BARRIER_BIT;
+        case BufferAccessType::BUFFER_UPDATE:
+            return GL_BUFFER_UPDATE_BARRIER_BIT;
+        case BufferAccessType::CLIENT_MAPPED:
+            return GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT;
+        default:
+            // shouldn't happen, but if it does, be safe
+            return ALL_TRACKED_BARRIER_BITS;
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Returns the one and only instance.
+    Parameters: None
+    Returns:
+        A reference to the singleton.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    MemoryBarrierTracker &MemoryBarrierTracker::GetInstance()
+    {
+        static MemoryBarrierTracker instance;
+        return instance;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Gives members initial values.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    MemoryBarrierTracker::MemoryBarrierTracker() :
+        _numBarriersIssued(0)
+    {
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Figures out which barrier bit, if any, needs to be issued before the given access.  A
+        bit is needed only if a shader wrote the buffer and that bit hasn't been issued since.
+    Parameters:
+        access  The buffer and how it is about to be used.
+    Returns:
+        0 if the access is already safe, otherwise a single barrier bit.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    GLbitfield MemoryBarrierTracker::BarrierBitsFor(const BufferAccess &access) const
+    {
+        if (access._bufferBinding >= _owedBarrierBits.size())
+        {
+            // never written by a shader
+            return 0;
+        }
+
+        return _owedBarrierBits[access._bufferBinding] & BarrierBitForAccessType(access._accessType);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Call after issuing the command that made the access.  A shader write means that every
+        kind of consumer will need a barrier before it can see the results.  Reads and writes
+        by other commands don't change anything.
+    Parameters:
+        access  The buffer and how it was used.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void MemoryBarrierTracker::RecordAccess(const BufferAccess &access)
+    {
+        bool isIncoherentWrite = access._isWrite &&
+            (access._accessType == BufferAccessType::SHADER_STORAGE ||
+            access._accessType == BufferAccessType::ATOMIC_COUNTER);
+        if (!isIncoherentWrite)
+        {
+            return;
+        }
+
+        if (access._bufferBinding >= _owedBarrierBits.size())
+        {
+            _owedBarrierBits.resize(access._bufferBinding + 1, 0);
+        }
+        _owedBarrierBits[access._bufferBinding] = ALL_TRACKED_BARRIER_BITS;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Issues glMemoryBarrier(...) (if there is anything to issue) and marks those bits as no
+        longer owed by any buffer.  A barrier is global, so it serves every buffer at once.
+    Parameters:
+        barrierBits     Self-explanatory.  0 does nothing.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void MemoryBarrierTracker::IssueBarrier(GLbitfield barrierBits)
+    {
+        if (barrierBits == 0)
+        {
+            return;
+        }
+
+        glMemoryBarrier(barrierBits);
+        _numBarriersIssued++;
+        for (size_t bindingIndex = 0; bindingIndex < _owedBarrierBits.size(); bindingIndex++)
+        {
+            _owedBarrierBits[bindingIndex] &= ~barrierBits;
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        For one-off commands that aren't part of a DispatchGraph (drawing, reading a
+        persistently mapped buffer, etc.).  Issues the barrier that the access needs (if any)
+        and records the access.
+    Parameters:
+        access  The buffer and how it is about to be used.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void MemoryBarrierTracker::WaitForAccess(const BufferAccess &access)
+    {
+        IssueBarrier(BarrierBitsFor(access));
+        RecordAccess(access);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A simple getter for the number of glMemoryBarrier(...) calls since the last
+        ResetStats().
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int MemoryBarrierTracker::NumBarriersIssued() const
+    {
+        return _numBarriersIssued;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Starts the barrier count over.  Does not forget which bits are owed.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void MemoryBarrierTracker::ResetStats()
+    {
+        _numBarriersIssued = 0;
+    }
+}
@@ -6,9 +6,11 @@
 #include "Include/Buffers/SSBOs/PrefixSumSsbo.h"
 #include "Include/Particles/Particle.h"     // for copying data back and verifying 
 
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 #include "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp"
+#include "Shaders/ParticleScenes.comp"
 
+#include <stdio.h>
 #include <iostream>
 #include <fstream>
 
@@ -20,11 +22,28 @@ using std::endl;
 
 namespace ShaderControllers
 {
+    // ShaderStorage keys
+    static const std::string PARTICLE_DATA_TO_INTERMEDIATE_DATA_SHADER_KEY = "particle data to intermediate data";
+    static const std::string GET_BIT_FOR_PREFIX_SUMS_SHADER_KEY = "get bit for prefix sums";
+    static const std::string PARALLEL_PREFIX_SCAN_SHADER_KEY = "parallel prefix scan";
+    static const std::string SORT_INTERMEDIATE_DATA_SHADER_KEY = "sort intermediate data";
+    static const std::string SORT_ORIGINAL_DATA_SHADER_KEY = "sort original data";
+
+    // the steps that the scratch buffers are alive for (see TransientBufferPool)
+    enum SortStep
+    {
+        SORT_STEP_KEYS = 0,
+        SORT_STEP_RADIX_PASSES,
+        SORT_STEP_GATHER,
+        SORT_STEP_COPY_BACK,
+    };
+
     /*--------------------------------------------------------------------------------------------
     Description:
         Generates multiple compute shaders for the different stages of the parallel sort, and
         allocates various buffers for the sorting.  Buffer sizes are highly dependent on the 
-        size of the original data.  They are expected to remain constant after class creation.
+        size of the original data.  They only change if the particle buffer grows (see 
+        ParticleBufferResized()).
 
         Note: The argument is a copy, not a reference.  A const pointer in the land of shared
         pointers is a different type than a non-const pointer (see the definition of the type)
@@ -52,123 +71,144 @@ namespace ShaderControllers
         concern.
 
         I'll take option (2).
+
+        Also Also Note: The three scratch buffers come out of one TransientBufferPool.  The 
+        PrefixSumBuffer is only needed during the radix passes and the copy buffer is only 
+        needed after them, so they share memory, which saves the size of the PrefixSumBuffer 
+        (~4MB at 1M particles).
     Parameters:
         dataToSort  See Description.
+        variant     The work group sizes and feature defines to build the shaders with.
     Returns:    None
     Creator:    John Cox, 3/2017
     --------------------------------------------------------------------------------------------*/
-    ParallelSort::ParallelSort(const ParticleSsbo::CONST_SHARED_PTR dataToSort) :
+    ParallelSort::ParallelSort(const ParticleSsbo::CONST_SHARED_PTR dataToSort,
+        const ComputeShaderVariant &variant) :
+        _variant(variant),
         _particleDataToIntermediateDataProgramId(0),
         _getBitForPrefixScansProgramId(0),
         _parallelPrefixScanProgramId(0),
         _sortIntermediateDataProgramId(0),
         _sortParticlesProgramId(0),
+        _transientBuffers("parallel sort transients"),
+        _prefixSumBufferIndex(0),
+        _particleCopyBufferIndex(0),
         _particleCopySsbo(nullptr),
         _intermediateDataSsbo(nullptr),
         _prefixSumSsbo(nullptr),
-        _particleSsbo(dataToSort)
+        _particleSsbo(dataToSort),
+        _sortGraph("parallel sort")
     {
+        SubmitShaders(variant);
+
         ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
-        std::string shaderKey;
+        _particleDataToIntermediateDataProgramId = shaderStorageRef.GetShaderProgram(_variant.ProgramKey(PARTICLE_DATA_TO_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_KEYS));
+        _getBitForPrefixScansProgramId = shaderStorageRef.GetShaderProgram(_variant.ProgramKey(GET_BIT_FOR_PREFIX_SUMS_SHADER_KEY, COMPUTE_STAGE_SORT_GET_BIT));
+        _parallelPrefixScanProgramId = shaderStorageRef.GetShaderProgram(_variant.ProgramKey(PARALLEL_PREFIX_SCAN_SHADER_KEY, COMPUTE_STAGE_SORT_PREFIX_SCAN));
+        _sortIntermediateDataProgramId = shaderStorageRef.GetShaderProgram(_variant.ProgramKey(SORT_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_SCATTER));
+        _sortParticlesProgramId = shaderStorageRef.GetShaderProgram(_variant.ProgramKey(SORT_ORIGINAL_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_GATHER));
+
+        AllocateSortBuffers();
+        BuildSortGraph();
+    }
 
-        // take a data structure that needs to be sorted by a value (must be unsigned int for 
-        // radix sort to work) and put it into an intermediate structure that has the value and 
-        // the index of the original data structure in the ParticleBuffer
-        shaderKey = "particle data to intermediate data";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/IntermediateSortBuffers.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleRegionBoundaries.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/PositionToMortonCode.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/ParticleDataToIntermediateData.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _particleDataToIntermediateDataProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The particle buffer grew (see ParticleSsbo::Resize(...)), so the scratch buffers and 
+        every dispatch size and buffer size uniform that came from the old size are made again.
 
-        // on each loop in Sort(), pluck out a single bit and add it to the 
-        // PrefixScanBuffer::PrefixSumsPerWorkGroup array
-        shaderKey = "get bit for prefix sums";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/IntermediateSortBuffers.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/PrefixScanBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/GetBitForPrefixScan.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _getBitForPrefixScansProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        The caller must check CanSort(...) before growing the particle buffer.  If it didn't, 
+        then nothing is rebuilt, because the prefix scan would come out wrong at the new size.  
+        The sort graph is emptied instead, so Sort() does nothing rather than sort with the old 
+        sizes or a broken scan.
+    Parameters: None
+    Returns:    
+        False if the variant can't sort the new number of particles, otherwise true.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool ParallelSort::ParticleBufferResized()
+    {
+        _sortGraph.Clear();
+        if (!CanSort(_particleSsbo->NumItems()))
+        {
+            fprintf(stderr, "ParallelSort: can't sort %u particles with variant '%s'; the sort is disabled\n", 
+                _particleSsbo->NumItems(), _variant.Name().c_str());
+            return false;
+        }
 
-        // run the prefix scan over PrefixScanBuffer::PrefixSumsPerWorkGroup, and after that run 
-        // the scan again over PrefixScanBuffer::PrefixSumsOfWorkGroupSums
-        shaderKey = "parallel prefix scan";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/PrefixScanBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/ParallelPrefixScan.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _parallelPrefixScanProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        AllocateSortBuffers();
+        BuildSortGraph();
+        return true;
+    }
 
-        // and finally sort the "read" array from IntermediateSortBuffers into the "write" array
-        shaderKey = "sort intermediate data";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/PrefixScanBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/IntermediateSortBuffers.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/SortIntermediateData.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _sortIntermediateDataProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Whether the variant can run every stage on this many items: the sort's work group 
+        sizes must be big enough for the prefix scan, and no stage may need more work groups 
+        than one dispatch can have (see ComputeShaderVariant::IsSupported(...)).
+    Parameters: 
+        numItems    Self-explanatory.
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool ParallelSort::CanSort(unsigned int numItems) const
+    {
+        return _variant.IsSupported(numItems);
+    }
 
-        // after the loop, sort the original data according to the sorted intermediate data
-        shaderKey = "sort original data";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/IntermediateSortBuffers.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParallelSort/SortParticleData.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _sortParticlesProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Sizes the scratch buffers for the ParticleBuffer's current size and tells the programs 
+        about the sizes.  Any scratch buffers from before are let go first so that their memory
+        can be reused.
+    Parameters: None
+    Returns:    None
+    Creator:    John Cox, 3/2017 (split out of the constructor by agent, 10/2026)
+    --------------------------------------------------------------------------------------------*/
+    void ParallelSort::AllocateSortBuffers()
+    {
+        // the SSBOs are using the pool's memory, so they go first
+        _particleCopySsbo = nullptr;
+        _intermediateDataSsbo = nullptr;
+        _prefixSumSsbo = nullptr;
+        _transientBuffers.Clear();
 
         // the size of the ParticleBuffer is needed by these shaders, and it is known (as 
         // per my design) only by the OriginalDataSsbo object
-        dataToSort->ConfigureConstantUniforms(_particleDataToIntermediateDataProgramId);
-        dataToSort->ConfigureConstantUniforms(_sortParticlesProgramId);
+        _particleSsbo->ConfigureConstantUniforms(_particleDataToIntermediateDataProgramId);
+        _particleSsbo->ConfigureConstantUniforms(_sortParticlesProgramId);
 
-        unsigned int numParticles = dataToSort->NumItems();
-        _particleCopySsbo = std::make_unique<ParticleCopySsbo>(numParticles);
-        _prefixSumSsbo = std::make_unique<PrefixSumSsbo>(numParticles);
+        // see explanation in the PrefixSumSsbo constructor for why there are likely more 
+        // entries in PrefixScanBuffer::PrefixSumsPerWorkGroup than the requested number of items 
+        // that need sorting
+        unsigned int numParticles = _particleSsbo->NumItems();
+        unsigned int itemsPerWorkGroup = _variant.ParallelSortItemsPerWorkGroup();
+        unsigned int numEntriesInPrefixSumBuffer = PrefixSumSsbo::NumDataEntriesFor(numParticles, itemsPerWorkGroup);
+
+        unsigned int intermediateDataBufferIndex = _transientBuffers.AddBuffer("intermediate data", 
+            IntermediateDataSsbo::NumBytesFor(numEntriesInPrefixSumBuffer), SORT_STEP_KEYS, SORT_STEP_GATHER);
+        _prefixSumBufferIndex = _transientBuffers.AddBuffer("prefix sums", 
+            PrefixSumSsbo::NumBytesFor(numParticles, itemsPerWorkGroup), SORT_STEP_RADIX_PASSES, SORT_STEP_RADIX_PASSES);
+        _particleCopyBufferIndex = _transientBuffers.AddBuffer("particle copy", 
+            ParticleCopySsbo::NumBytesFor(numParticles), SORT_STEP_GATHER, SORT_STEP_COPY_BACK);
+        _transientBuffers.Allocate();
+
+        _particleCopySsbo = std::make_unique<ParticleCopySsbo>(numParticles, 
+            _transientBuffers.BufferRange(_particleCopyBufferIndex));
+        _prefixSumSsbo = std::make_unique<PrefixSumSsbo>(numParticles, itemsPerWorkGroup, 
+            _transientBuffers.BufferRange(_prefixSumBufferIndex));
 
         // the PrefixScanBuffer is used in three shaders
         _prefixSumSsbo->ConfigureConstantUniforms(_getBitForPrefixScansProgramId);
         _prefixSumSsbo->ConfigureConstantUniforms(_parallelPrefixScanProgramId);
         _prefixSumSsbo->ConfigureConstantUniforms(_sortIntermediateDataProgramId);
 
-        // see explanation in the PrefixSumSsbo constructor for why there are likely more 
-        // entries in PrefixScanBuffer::PrefixSumsPerWorkGroup than the requested number of items 
-        // that need sorting
-        unsigned int numEntriesInPrefixSumBuffer = _prefixSumSsbo->NumDataEntries();
-        _intermediateDataSsbo = std::make_unique<IntermediateDataSsbo>(numEntriesInPrefixSumBuffer);
+        _intermediateDataSsbo = std::make_unique<IntermediateDataSsbo>(numEntriesInPrefixSumBuffer, 
+            _transientBuffers.BufferRange(intermediateDataBufferIndex));
         _intermediateDataSsbo->ConfigureConstantUniforms(_particleDataToIntermediateDataProgramId);
         _intermediateDataSsbo->ConfigureConstantUniforms(_getBitForPrefixScansProgramId);
         _intermediateDataSsbo->ConfigureConstantUniforms(_sortIntermediateDataProgramId);
-
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -181,11 +221,84 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     ParallelSort::~ParallelSort()
     {
-        glDeleteProgram(_particleDataToIntermediateDataProgramId);
-        glDeleteProgram(_getBitForPrefixScansProgramId);
-        glDeleteProgram(_parallelPrefixScanProgramId);
-        glDeleteProgram(_sortIntermediateDataProgramId);
-        glDeleteProgram(_sortParticlesProgramId);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(PARTICLE_DATA_TO_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_KEYS));
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(GET_BIT_FOR_PREFIX_SUMS_SHADER_KEY, COMPUTE_STAGE_SORT_GET_BIT));
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(PARALLEL_PREFIX_SCAN_SHADER_KEY, COMPUTE_STAGE_SORT_PREFIX_SCAN));
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(SORT_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_SCATTER));
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(SORT_ORIGINAL_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_GATHER));
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles one of the sort's programs for the variant and hands it to ShaderStorage to 
+        compile and link, unless it was already submitted.
+    Parameters:
+        baseProgramKey  One of the ShaderStorage keys above.
+        stage           The sort stage that the program is for.
+        filePath        The program's top-level shader file.
+        variant         The work group sizes and feature defines to build the shader with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    static void SubmitSortShader(const std::string &baseProgramKey, ComputeStage stage, 
+        const std::string &filePath, const ComputeShaderVariant &variant)
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        std::string shaderKey = variant.ProgramKey(baseProgramKey, stage);
+        if (shaderStorageRef.ProgramExists(shaderKey))
+        {
+            return;
+        }
+
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        variant.AddDefinesToProgram(shaderKey, stage);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, filePath);
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the sort's shader programs and hands them to ShaderStorage to compile and 
+        link.  Does not wait for the driver to finish (see ShaderStorage::LinkShader(...)), so 
+        main(...) can submit every controller's shaders before constructing any of them, and the 
+        driver can work on all of them at once.  The constructor calls this too, so calling it 
+        first is optional.
+
+        Skips any program that was already submitted.  Variants that only differ in some of 
+        the sort's stages share the programs for the others (see 
+        ComputeShaderVariant::ProgramKey(...)).
+    Parameters:
+        variant     The work group sizes and feature defines to build the shaders with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParallelSort::SubmitShaders(const ComputeShaderVariant &variant)
+    {
+        // take a data structure that needs to be sorted by a value (must be unsigned int for 
+        // radix sort to work) and put it into an intermediate structure that has the value and 
+        // the index of the original data structure in the ParticleBuffer
+        SubmitSortShader(PARTICLE_DATA_TO_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_KEYS, 
+            "Shaders/ParallelSort/ParticleDataToIntermediateData.comp", variant);
+
+        // on each loop in Sort(), pluck out a single bit and add it to the 
+        // PrefixScanBuffer::PrefixSumsPerWorkGroup array
+        SubmitSortShader(GET_BIT_FOR_PREFIX_SUMS_SHADER_KEY, COMPUTE_STAGE_SORT_GET_BIT, 
+            "Shaders/ParallelSort/GetBitForPrefixScan.comp", variant);
+
+        // run the prefix scan over PrefixScanBuffer::PrefixSumsPerWorkGroup, and after that run 
+        // the scan again over PrefixScanBuffer::PrefixSumsOfWorkGroupSums
+        SubmitSortShader(PARALLEL_PREFIX_SCAN_SHADER_KEY, COMPUTE_STAGE_SORT_PREFIX_SCAN, 
+            "Shaders/ParallelSort/ParallelPrefixScan.comp", variant);
+
+        // and finally sort the "read" array from IntermediateSortBuffers into the "write" array
+        SubmitSortShader(SORT_INTERMEDIATE_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_SCATTER, 
+            "Shaders/ParallelSort/SortIntermediateData.comp", variant);
+
+        // after the loop, sort the original data according to the sorted intermediate data
+        SubmitSortShader(SORT_ORIGINAL_DATA_SHADER_KEY, COMPUTE_STAGE_SORT_GATHER, 
+            "Shaders/ParallelSort/SortParticleData.comp", variant);
     }
 
         /*--------------------------------------------------------------------------------------------
@@ -205,98 +318,28 @@ namespace ShaderControllers
         - Copy the sorted copy buffer back into ParticleBuffer
 
         The ParticleBuffer is now sorted.
+
+        All of these are stages in _sortGraph (see BuildSortGraph()), which takes care of the 
+        barriers between them.
     Parameters: None
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
-    void ParallelSort::SortWithoutProfiling() const
+    void ParallelSort::SortWithoutProfiling()
     {
-        unsigned int numItemsInPrefixScanBuffer = _prefixSumSsbo->NumDataEntries();
-        
-        // for ParallelPrefixScan.comp, which works on 2 items per thread
-        int numWorkGroupsXByItemsPerWorkGroup = numItemsInPrefixScanBuffer / PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
-        int remainder = numItemsInPrefixScanBuffer % PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
-        numWorkGroupsXByItemsPerWorkGroup += (remainder == 0) ? 0 : 1;
-
-        // for other shaders, which work on 1 item per thread
-        int numWorkGroupsXByWorkGroupSize = numItemsInPrefixScanBuffer / PARALLEL_SORT_WORK_GROUP_SIZE_X;
-        remainder = numItemsInPrefixScanBuffer % PARALLEL_SORT_WORK_GROUP_SIZE_X;
-        numWorkGroupsXByWorkGroupSize += (remainder == 0) ? 0 : 1;
-
-        // working on a 1D array (X dimension), so these are always 1
-        int numWorkGroupsY = 1;
-        int numWorkGroupsZ = 1;
-
-        // moving original data to intermediate data is 1 item per thread
-        glUseProgram(_particleDataToIntermediateDataProgramId);
-        glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    
-        // for 32bit unsigned integers, make 32 passes, one for each bit
-        bool writeToSecondBuffer = true;
-        for (unsigned int bitNumber = 0; bitNumber < 32; bitNumber++)
-        {
-            // this will either be 0 or half the size of IntermediateDataBuffer
-            unsigned int intermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
-            unsigned int intermediateDataWriteBufferOffset = (unsigned int)writeToSecondBuffer * numItemsInPrefixScanBuffer;
-
-            // getting 1 bit value from intermediate data to prefix sum is 1 item per thread
-            glUseProgram(_getBitForPrefixScansProgramId);
-            glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
-            glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
-            glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
-            glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-            // prefix scan over all values
-            // Note: Parallel prefix scan is 2 items per thread.
-            glUseProgram(_parallelPrefixScanProgramId);
-            glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 1);
-            glDispatchCompute(numWorkGroupsXByItemsPerWorkGroup, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-            // prefix scan over per-work-group sums
-            // Note: The PrefixSumsOfWorkGroupSums array is sized to be exactly enough for 1 work group.  
-            // It makes the prefix sum easier than trying to eliminate excess threads.
-            glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 0);
-            glDispatchCompute(1, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-            // and sort the intermediate data with the scanned values
-            glUseProgram(_sortIntermediateDataProgramId);
-            glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
-            glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
-            glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
-            glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-            // now switch intermediate buffers and do it again
-            writeToSecondBuffer = !writeToSecondBuffer;
-        }
-
-        // now use the sorted IntermediateData objects to sort the original data objects into a 
-        // copy buffer (there is no "swap" in parallel sorting, so must write to a dedicated 
-        // copy buffer
-        glUseProgram(_sortParticlesProgramId);
-        unsigned int intermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
-        glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
-        glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
-
-        // make the results of the last one available for rendering
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
-
-        // and finally, move the sorted original data from the copy buffer back to the 
-        // ParticleBuffer
-        glBindBuffer(GL_COPY_READ_BUFFER, _particleCopySsbo->BufferId());
-        glBindBuffer(GL_COPY_WRITE_BUFFER, _particleSsbo->BufferId());
-        unsigned int ParticleBufferSizeBytes = _particleSsbo->NumItems() * sizeof(Particle);
-        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, ParticleBufferSizeBytes);
-        glBindBuffer(GL_COPY_READ_BUFFER, 0);
-        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        _sortGraph.Execute();
+    }
 
-        // end sorting
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        glUseProgram(0);
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Prints how the scratch buffers were laid out and how much memory sharing saved.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParallelSort::PrintTransientBufferReport() const
+    {
+        _transientBuffers.PrintReport();
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -328,28 +371,32 @@ namespace ShaderControllers
         std::vector<long long> durationsSortIntermediateData(32);
 
         // begin
-        parallelSortStart = high_resolution_clock::now();
-
-        // for ParallelPrefixScan.comp, which works on 2 items per thread
-        int numWorkGroupsXByItemsPerWorkGroup = numItemsInPrefixScanBuffer / PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
-        int remainder = numItemsInPrefixScanBuffer % PARALLEL_SORT_ITEMS_PER_WORK_GROUP;
-        numWorkGroupsXByItemsPerWorkGroup += (remainder == 0) ? 0 : 1;
+        parallelSortStart = steady_clock::now();
 
-        // for other shaders, which work on 1 item per thread
-        int numWorkGroupsXByWorkGroupSize = numItemsInPrefixScanBuffer / PARALLEL_SORT_WORK_GROUP_SIZE_X;
-        remainder = numItemsInPrefixScanBuffer % PARALLEL_SORT_WORK_GROUP_SIZE_X;
-        numWorkGroupsXByWorkGroupSize += (remainder == 0) ? 0 : 1;
+        // each stage has its own work group size and items per thread
+        // Note: ParallelPrefixScan.comp always works on 2 items per thread.
+        int numWorkGroupsXSortKeys = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_KEYS, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXGetBit = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_GET_BIT, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXPrefixScan = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_PREFIX_SCAN, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXScatter = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_SCATTER, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXGather = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_GATHER, numItemsInPrefixScanBuffer);
 
         // working on a 1D array (X dimension), so these are always 1
         int numWorkGroupsY = 1;
         int numWorkGroupsZ = 1;
 
-        // moving original data to intermediate data is 1 item per thread
-        start = high_resolution_clock::now();
+        // this path issues its own barriers, but whatever ran before it left its barriers to 
+        // the tracker
+        // Note: GL_ALL_BARRIER_BITS is overkill, but this is the profiling path.
+        MemoryBarrierTracker &barrierTrackerRef = MemoryBarrierTracker::GetInstance();
+        barrierTrackerRef.IssueBarrier(GL_ALL_BARRIER_BITS);
+
+        // move the original data to the intermediate data
+        start = steady_clock::now();
         glUseProgram(_particleDataToIntermediateDataProgramId);
-        glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
+        glDispatchCompute(numWorkGroupsXSortKeys, numWorkGroupsY, numWorkGroupsZ);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-        end = high_resolution_clock::now();
+        end = steady_clock::now();
         durationOriginalDataToIntermediateData = duration_cast<microseconds>(end - start).count();
     
         // for 32bit unsigned integers, make 32 passes
@@ -360,46 +407,46 @@ namespace ShaderControllers
             unsigned int intermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
             unsigned int intermediateDataWriteBufferOffset = (unsigned int)writeToSecondBuffer * numItemsInPrefixScanBuffer;
 
-            // getting 1 bit value from intermediate data to prefix sum is 1 item per thread
-            start = high_resolution_clock::now();
+            // get 1 bit value from each intermediate data item into the prefix sums
+            start = steady_clock::now();
             glUseProgram(_getBitForPrefixScansProgramId);
             glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
             glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
             glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
-            glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
+            glDispatchCompute(numWorkGroupsXGetBit, numWorkGroupsY, numWorkGroupsZ);
             glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-            end = high_resolution_clock::now();
+            end = steady_clock::now();
             durationsGetBitForPrefixScan[bitNumber] = (duration_cast<microseconds>(end - start).count());
 
             // prefix scan over all values
             // Note: Parallel prefix scan is 2 items per thread.
-            start = high_resolution_clock::now();
+            start = steady_clock::now();
             glUseProgram(_parallelPrefixScanProgramId);
             glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 1);
-            glDispatchCompute(numWorkGroupsXByItemsPerWorkGroup, numWorkGroupsY, numWorkGroupsZ);
+            glDispatchCompute(numWorkGroupsXPrefixScan, numWorkGroupsY, numWorkGroupsZ);
             glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-            end = high_resolution_clock::now();
+            end = steady_clock::now();
             durationsPrefixScanAll[bitNumber] = (duration_cast<microseconds>(end - start).count());
 
             // prefix scan over per-work-group sums
             // Note: The PrefixSumsOfWorkGroupSums array is sized to be exactly enough for 1 work group.  
             // It makes the prefix sum easier than trying to eliminate excess threads.
-            start = high_resolution_clock::now();
+            start = steady_clock::now();
             glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 0);
             glDispatchCompute(1, numWorkGroupsY, numWorkGroupsZ);
             glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-            end = high_resolution_clock::now();
+            end = steady_clock::now();
             durationsPrefixScanWorkGroupSums[bitNumber] = (duration_cast<microseconds>(end - start).count());
 
             // and sort the intermediate data with the scanned values
-            start = high_resolution_clock::now();
+            start = steady_clock::now();
             glUseProgram(_sortIntermediateDataProgramId);
             glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
             glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
             glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
-            glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
+            glDispatchCompute(numWorkGroupsXScatter, numWorkGroupsY, numWorkGroupsZ);
             glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-            end = high_resolution_clock::now();
+            end = steady_clock::now();
             durationsSortIntermediateData[bitNumber] = (duration_cast<microseconds>(end - start).count());
 
             // now switch intermediate buffers and do it again
@@ -409,47 +456,57 @@ namespace ShaderControllers
         // now use the sorted IntermediateData objects to sort the original data objects into a 
         // copy buffer (there is no "swap" in parallel sorting, so must write to a dedicated 
         // copy buffer
-        start = high_resolution_clock::now();
+        start = steady_clock::now();
         glUseProgram(_sortParticlesProgramId);
         unsigned int intermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
         glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
-        glDispatchCompute(numWorkGroupsXByWorkGroupSize, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-        end = high_resolution_clock::now();
+        glDispatchCompute(numWorkGroupsXGather, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        end = steady_clock::now();
         long long durationSortParticleData = duration_cast<microseconds>(end - start).count();
 
         // and finally, move the sorted original data from the copy buffer back to the 
         // ParticleBuffer
-        start = high_resolution_clock::now();
+        start = steady_clock::now();
         glBindBuffer(GL_COPY_READ_BUFFER, _particleCopySsbo->BufferId());
         glBindBuffer(GL_COPY_WRITE_BUFFER, _particleSsbo->BufferId());
         unsigned int ParticleBufferSizeBytes = _particleSsbo->NumItems() * sizeof(Particle);
-        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, ParticleBufferSizeBytes);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+            _particleCopySsbo->BufferOffsetBytes(), _particleSsbo->BufferOffsetBytes(), ParticleBufferSizeBytes);
         glBindBuffer(GL_COPY_READ_BUFFER, 0);
         glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-        end = high_resolution_clock::now();
+        end = steady_clock::now();
         long long durationCopySortedOriginalData = duration_cast<microseconds>(end - start).count();
 
+        // let the tracker know what the sort wrote so that whatever comes next gets its barriers
+        barrierTrackerRef.RecordAccess(BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true));
+        barrierTrackerRef.RecordAccess(BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true));
+
         // end sorting
-        steady_clock::time_point parallelSortEnd = high_resolution_clock::now();
+        steady_clock::time_point parallelSortEnd = steady_clock::now();
 
         // verify sorted data
-        start = high_resolution_clock::now();
-        unsigned int startingIndex = 0;
+        start = steady_clock::now();
+        // Note: The arena's buffers can't be mapped (see GpuBufferArena), so copy it out.
         std::vector<Particle> checkOriginalData(_particleSsbo->NumItems());
         unsigned int bufferSizeBytes = checkOriginalData.size() * sizeof(Particle);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, _particleSsbo->BufferId());
-        void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, startingIndex, bufferSizeBytes, GL_MAP_READ_BIT);
-        memcpy(checkOriginalData.data(), bufferPtr, bufferSizeBytes);
-        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, _particleSsbo->BufferOffsetBytes(), bufferSizeBytes, 
+            checkOriginalData.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
         // check
         for (unsigned int i = 1; i < checkOriginalData.size(); i++)
         {
             unsigned int thisIndex = i;
             unsigned int prevIndex = i - 1;
-            unsigned int val = checkOriginalData[thisIndex]._mortonCode;
-            unsigned int prevVal = checkOriginalData[prevIndex]._mortonCode;
+            // same key as ParticleDataToIntermediateData.comp
+            const Particle &thisParticle = checkOriginalData[thisIndex];
+            const Particle &prevParticle = checkOriginalData[prevIndex];
+            unsigned int val = (thisParticle._sceneId << PARTICLE_SORT_KEY_SCENE_ID_SHIFT) | 
+                (thisParticle._mortonCode >> PARTICLE_SORT_KEY_MORTON_CODE_SHIFT);
+            unsigned int prevVal = (prevParticle._sceneId << PARTICLE_SORT_KEY_SCENE_ID_SHIFT) | 
+                (prevParticle._mortonCode >> PARTICLE_SORT_KEY_MORTON_CODE_SHIFT);
 
             if (checkOriginalData[thisIndex]._isActive == 0)
             {
@@ -468,7 +525,7 @@ namespace ShaderControllers
             }
         }
 
-        end = high_resolution_clock::now();
+        end = steady_clock::now();
         durationDataVerification = duration_cast<microseconds>(end - start).count();
 
         // write the results to stdout and to a text file so that I can dump them into an Excel spreadsheet
@@ -539,4 +596,165 @@ namespace ShaderControllers
     }
 
 
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Declares every stage of the sort (see SortWithoutProfiling()) and the buffers that each 
+        one touches.  The dispatch graph works out the barriers.
+
+        The number of items only changes when the particle buffer grows, which rebuilds the 
+        graph (see ParticleBufferResized()), so the dispatch sizes and the intermediate buffer 
+        offsets are the same on every sort and are captured here.
+
+        Note: Every stage depends on the one before it, so there is nothing to reorder, but the 
+        barriers got narrower.  The steps within the radix loop still need 
+        GL_SHADER_STORAGE_BARRIER_BIT, but the copy back to the ParticleBuffer only needs 
+        GL_BUFFER_UPDATE_BARRIER_BIT (it used to get "SSBO | vertex", which didn't cover it), 
+        and the vertex bit is left to whoever draws the particles.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParallelSort::BuildSortGraph()
+    {
+        unsigned int numItemsInPrefixScanBuffer = _prefixSumSsbo->NumDataEntries();
+        
+        // each stage has its own work group size and items per thread
+        // Note: ParallelPrefixScan.comp always works on 2 items per thread.
+        int numWorkGroupsXSortKeys = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_KEYS, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXGetBit = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_GET_BIT, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXPrefixScan = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_PREFIX_SCAN, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXScatter = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_SCATTER, numItemsInPrefixScanBuffer);
+        int numWorkGroupsXGather = _variant.NumWorkGroups(COMPUTE_STAGE_SORT_GATHER, numItemsInPrefixScanBuffer);
+
+        // move the original data to the intermediate data
+        // Note: This also writes the particles' Morton codes and empties the free list.
+        std::vector<BufferAccess> toIntermediateAccesses =
+        {
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+            BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+            BufferAccess(INTERMEDIATE_SORT_BUFFERS_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        _sortGraph.AddStage("particles to intermediate data", toIntermediateAccesses, 
+            [this, numWorkGroupsXSortKeys]()
+        {
+            glUseProgram(_particleDataToIntermediateDataProgramId);
+            glDispatchCompute(numWorkGroupsXSortKeys, 1, 1);
+        });
+
+        std::vector<BufferAccess> getBitAccesses =
+        {
+            BufferAccess(INTERMEDIATE_SORT_BUFFERS_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(PREFIX_SCAN_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        std::vector<BufferAccess> prefixScanAccesses =
+        {
+            BufferAccess(PREFIX_SCAN_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        std::vector<BufferAccess> sortIntermediateAccesses =
+        {
+            BufferAccess(PREFIX_SCAN_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(INTERMEDIATE_SORT_BUFFERS_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+
+        // for 32bit unsigned integers, make 32 passes, one for each bit
+        bool writeToSecondBuffer = true;
+        for (unsigned int bitNumber = 0; bitNumber < 32; bitNumber++)
+        {
+            // this will either be 0 or half the size of IntermediateDataBuffer
+            unsigned int intermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
+            unsigned int intermediateDataWriteBufferOffset = (unsigned int)writeToSecondBuffer * numItemsInPrefixScanBuffer;
+            std::string bitString = std::to_string(bitNumber);
+
+            // get 1 bit value from each intermediate data item into the prefix sums
+            _sortGraph.AddStage("get bit " + bitString, getBitAccesses, 
+                [this, intermediateDataReadBufferOffset, intermediateDataWriteBufferOffset, bitNumber, numWorkGroupsXGetBit]()
+            {
+                glUseProgram(_getBitForPrefixScansProgramId);
+                glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
+                glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
+                glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
+                glDispatchCompute(numWorkGroupsXGetBit, 1, 1);
+            });
+
+            // prefix scan over all values
+            // Note: Parallel prefix scan is 2 items per thread.
+            _sortGraph.AddStage("prefix scan all " + bitString, prefixScanAccesses, 
+                [this, numWorkGroupsXPrefixScan]()
+            {
+                glUseProgram(_parallelPrefixScanProgramId);
+                glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 1);
+                glDispatchCompute(numWorkGroupsXPrefixScan, 1, 1);
+            });
+
+            // prefix scan over per-work-group sums
+            // Note: The PrefixSumsOfWorkGroupSums array is sized to be exactly enough for 1 work 
+            // group.  It makes the prefix sum easier than trying to eliminate excess threads.
+            _sortGraph.AddStage("prefix scan work group sums " + bitString, prefixScanAccesses, [this]()
+            {
+                glUseProgram(_parallelPrefixScanProgramId);
+                glUniform1ui(UNIFORM_LOCATION_CALCULATE_ALL, 0);
+                glDispatchCompute(1, 1, 1);
+            });
+
+            // and sort the intermediate data with the scanned values
+            _sortGraph.AddStage("sort intermediate data " + bitString, sortIntermediateAccesses, 
+                [this, intermediateDataReadBufferOffset, intermediateDataWriteBufferOffset, bitNumber, numWorkGroupsXScatter]()
+            {
+                glUseProgram(_sortIntermediateDataProgramId);
+                glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, intermediateDataReadBufferOffset);
+                glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_WRITE_OFFSET, intermediateDataWriteBufferOffset);
+                glUniform1ui(UNIFORM_LOCATION_BIT_NUMBER, bitNumber);
+                glDispatchCompute(numWorkGroupsXScatter, 1, 1);
+            });
+
+            // now switch intermediate buffers and do it again
+            writeToSecondBuffer = !writeToSecondBuffer;
+        }
+
+        // now use the sorted IntermediateData objects to sort the original data objects into a 
+        // copy buffer (there is no "swap" in parallel sorting, so must write to a dedicated 
+        // copy buffer
+        // Note: This also rebuilds the free list.
+        unsigned int finalIntermediateDataReadBufferOffset = (unsigned int)!writeToSecondBuffer * numItemsInPrefixScanBuffer;
+        std::vector<BufferAccess> sortParticlesAccesses =
+        {
+            BufferAccess(INTERMEDIATE_SORT_BUFFERS_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(PARTICLE_COPY_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+            BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        if (_transientBuffers.BuffersShareMemory(_prefixSumBufferIndex, _particleCopyBufferIndex))
+        {
+            // the copy buffer is written over the PrefixSumBuffer, which the barrier tracker 
+            // can't see because they have different binding points
+            sortParticlesAccesses.push_back(BufferAccess(PREFIX_SCAN_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true));
+        }
+        _sortGraph.AddStage("sort particles", sortParticlesAccesses, 
+            [this, finalIntermediateDataReadBufferOffset, numWorkGroupsXGather]()
+        {
+            glUseProgram(_sortParticlesProgramId);
+            glUniform1ui(UNIFORM_LOCATION_INTERMEDIATE_BUFFER_READ_OFFSET, finalIntermediateDataReadBufferOffset);
+            glDispatchCompute(numWorkGroupsXGather, 1, 1);
+            glUseProgram(0);
+        });
+
+        // and finally, move the sorted original data from the copy buffer back to the 
+        // ParticleBuffer
+        std::vector<BufferAccess> copyBackAccesses =
+        {
+            BufferAccess(PARTICLE_COPY_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, false),
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, true),
+        };
+        _sortGraph.AddStage("copy back", copyBackAccesses, [this]()
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, _particleCopySsbo->BufferId());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, _particleSsbo->BufferId());
+            unsigned int ParticleBufferSizeBytes = _particleSsbo->NumItems() * sizeof(Particle);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+                _particleCopySsbo->BufferOffsetBytes(), _particleSsbo->BufferOffsetBytes(), ParticleBufferSizeBytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        });
+    }
 }
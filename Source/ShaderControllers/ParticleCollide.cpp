@@ -3,13 +3,16 @@
 #include <string>
 
 #include "Shaders/ShaderStorage.h"
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 
 namespace ShaderControllers
 {
+    // the ShaderStorage key
+    static const std::string PARTICLE_COLLISIONS_SHADER_KEY = "particle collisions";
+
     /*--------------------------------------------------------------------------------------------
     Description:
         Gives members initial values.
@@ -17,33 +20,30 @@ namespace ShaderControllers
         Constructs the PaticleCollide compute shader out of the necessary shader pieces.
     Parameters: 
         ssboToWorkWith  The SSBO that will be configured to work with this shader controller.
+        variant         The work group sizes and feature defines to build the shaders with.
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
-    ParticleCollide::ParticleCollide(const ParticleSsbo::SHARED_PTR &ssboToWorkWith) :
+    ParticleCollide::ParticleCollide(const ParticleSsbo::SHARED_PTR &ssboToWorkWith,
+        const ComputeShaderVariant &variant) :
+        _variant(variant),
         _totalParticleCount(0),
         _computeProgramId(0),
-        _unifLocIndexOffsetBy0Or1(-1)
+        _unifLocIndexOffsetBy0Or1(-1),
+        _collideGraph("particle collide")
     {
         _totalParticleCount = ssboToWorkWith->NumItems();
 
-        // construct the compute shader
-        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        SubmitShaders(variant);
 
-        std::string shaderKey = "particle collisions";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp"); 
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleCollisions.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _computeProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        std::string programKey = _variant.ProgramKey(PARTICLE_COLLISIONS_SHADER_KEY, COMPUTE_STAGE_COLLIDE);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        _computeProgramId = shaderStorageRef.GetShaderProgram(programKey);
         ssboToWorkWith->ConfigureConstantUniforms(_computeProgramId);
 
-        _unifLocIndexOffsetBy0Or1 = shaderStorageRef.GetUniformLocation(shaderKey, "uIndexOffsetBy0Or1");
+        _unifLocIndexOffsetBy0Or1 = shaderStorageRef.GetUniformLocation(programKey, "uIndexOffsetBy0Or1");
+
+        BuildCollideGraph();
     }   
 
     /*--------------------------------------------------------------------------------------------
@@ -55,7 +55,53 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     ParticleCollide::~ParticleCollide()
     {
-        glDeleteProgram(_computeProgramId);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(PARTICLE_COLLISIONS_SHADER_KEY, COMPUTE_STAGE_COLLIDE));
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The particle buffer grew (see ParticleSsbo::Resize(...)), so the program's buffer size 
+        uniform is set again and the graph is rebuilt with the new dispatch size.
+    Parameters:
+        resizedSsbo     The same SSBO that was given to the constructor.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleCollide::ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo)
+    {
+        _totalParticleCount = resizedSsbo->NumItems();
+        resizedSsbo->ConfigureConstantUniforms(_computeProgramId);
+
+        _collideGraph.Clear();
+        BuildCollideGraph();
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the shader program and hands it to ShaderStorage to compile and link.  Does 
+        not wait for the driver to finish it (see ParallelSort::SubmitShaders()).
+
+        Does nothing if the program was already submitted.
+    Parameters:
+        variant     The work group sizes and feature defines to build the shaders with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleCollide::SubmitShaders(const ComputeShaderVariant &variant)
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (shaderStorageRef.ProgramExists(variant.ProgramKey(PARTICLE_COLLISIONS_SHADER_KEY, COMPUTE_STAGE_COLLIDE)))
+        {
+            return;
+        }
+
+        std::string shaderKey = variant.ProgramKey(PARTICLE_COLLISIONS_SHADER_KEY, COMPUTE_STAGE_COLLIDE);
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        variant.AddDefinesToProgram(shaderKey, COMPUTE_STAGE_COLLIDE);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleCollisions.comp");
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -72,30 +118,46 @@ namespace ShaderControllers
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
     void ParticleCollide::DetectAndResolveCollisions()
+    {
+        _collideGraph.Execute();
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Declares the collision stages and the buffers that they touch.  The dispatch graph 
+        works out the barriers.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleCollide::BuildCollideGraph()
     {
         // let particle collision detection and resolution occur in pairs (the collision 
         // resolution math is intended for pairs anyway)
         // Note: Add 1 in case there are an odd number of particles.  I want to make sure that 
         // all particles are covered.
         unsigned int halfParticleCount = (_totalParticleCount / 2) + 1;
-        GLuint numWorkGroupsX = (halfParticleCount / PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X) + 1;
-        GLuint numWorkGroupsY = 1;
-        GLuint numWorkGroupsZ = 1;
-
-        glUseProgram(_computeProgramId);
+        GLuint numWorkGroupsX = (halfParticleCount / _variant.ItemsPerWorkGroup(COMPUTE_STAGE_COLLIDE)) + 1;
 
         // see explanation of why this is launched twice in ParticleCollisions.comp in the 
         // comment block for uIndexOffsetBy0Or1
-        glUniform1ui(_unifLocIndexOffsetBy0Or1, 0);
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
-
-        glUniform1ui(_unifLocIndexOffsetBy0Or1, 1);
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
-
-        // cleanup
-        glUseProgram(0);
+        // Note: Both passes write the particle buffer, so the second one always gets a barrier 
+        // after the first.
+        std::vector<BufferAccess> collideAccesses =
+        {
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        for (unsigned int indexOffset = 0; indexOffset < 2; indexOffset++)
+        {
+            _collideGraph.AddStage("collide offset " + std::to_string(indexOffset), collideAccesses, 
+                [this, indexOffset, numWorkGroupsX]()
+            {
+                glUseProgram(_computeProgramId);
+                glUniform1ui(_unifLocIndexOffsetBy0Or1, indexOffset);
+                glDispatchCompute(numWorkGroupsX, 1, 1);
+                glUseProgram(0);
+            });
+        }
     }
     
 }
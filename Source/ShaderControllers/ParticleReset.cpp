@@ -1,9 +1,12 @@
 #include "Include/ShaderControllers/ParticleReset.h"
 
+#include <stdio.h>
 #include <string>
 
 #include "Shaders/ShaderStorage.h"
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
+#include "Shaders/ParticleReset/ParticleEmitterTypes.comp"
+#include "Shaders/ParticleScenes.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 #include "ThirdParty/glm/gtc/type_ptr.hpp"
@@ -11,90 +14,62 @@
 
 namespace ShaderControllers
 {
+    // the ShaderStorage key
+    static const std::string PARTICLE_RESET_SHADER_KEY = "particle reset";
+
     /*----------------------------------------------------------------------------------------
     Description:
         Gives members initial values.
         
-        Constructs the ParticleResetPoint and ParticleResetBar compute shaders out of the 
-        necessary shader pieces.
-        Looks up all uniforms in the resultant shaders.
+        Constructs the ParticleReset compute shader out of the necessary shader pieces.
+        Looks up all uniforms in the resultant shader.
+        Allocates space for the emitter descriptors.
     Parameters: 
         ssboToReset     ParticleUpdate will tell the SSBO to configure its buffer size 
                         uniforms for the compute shader.
+        variant         The work group sizes and feature defines to build the shaders with.
     Returns:    None
     Creator:    John Cox, 4/2017
     ----------------------------------------------------------------------------------------*/
-    ParticleReset::ParticleReset(const ParticleSsbo::SHARED_PTR &ssboToReset) :
+    ParticleReset::ParticleReset(const ParticleSsbo::SHARED_PTR &ssboToReset,
+        const ComputeShaderVariant &variant) :
+        _variant(variant),
         _totalParticleCount(0),
-        _computeProgramIdBarEmitters(0),
-        _computeProgramIdPointEmitters(0),
-        _particleResetAtomicCounter(nullptr),
-        _unifLocPointEmitterCenter(-1),
-        _unifLocPointMaxParticleEmitCount(-1),
-        _unifLocPointMinParticleVelocity(-1),
-        _unifLocPointMaxParticleVelocity(-1),
-        _unifLocBarEmitterP1(-1),
-        _unifLocBarEmitterP2(-1),
-        _unifLocBarEmitterEmitDir(-1),
-        _unifLocBarMaxParticleEmitCount(-1),
-        _unifLocBarMinParticleVelocity(-1),
-        _unifLocBarMaxParticleVelocity(-1)
+        _computeProgramId(0),
+        _unifLocNumEmitters(-1),
+        _unifLocParticlesPerEmitterPerFrame(-1),
+        _unifLocNumFreeIndicesToPop(-1),
+        _unifLocRandomSeed(-1),
+        _unifLocFrameNumber(-1),
+        _randomSeed(DEFAULT_RANDOM_SEED),
+        _frameNumber(0),
+        _numEmittersThisReset(0),
+        _particlesPerEmitterThisReset(0),
+        _frameNumberThisReset(0),
+        _numWorkGroupsThisReset(0),
+        _resetGraph("particle reset"),
+        _emitterSsbo(nullptr)
     {
         _totalParticleCount = ssboToReset->NumItems();
-        _particleResetAtomicCounter = PersistentAtomicCounterBuffer::GetInstance();
-
-        // construct the compute shader
-        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
-        std::string shaderKey;
+        _emitterSsbo = std::make_shared<ParticleEmitterSsbo>(static_cast<unsigned int>(MAX_EMITTERS));
+        _emitterDescriptors.reserve(MAX_EMITTERS);
 
-        // first make the particle reset shader for point emitters
-        shaderKey = "particle reset point emitter";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/Random.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/QuickNormalize.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/ParticleResetPointEmitter.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _computeProgramIdPointEmitters = shaderStorageRef.GetShaderProgram(shaderKey);
-        ssboToReset->ConfigureConstantUniforms(_computeProgramIdPointEmitters);
+        SubmitShaders(variant);
 
-        // uniform lookups for the point emitter shader
-        _unifLocPointEmitterCenter = shaderStorageRef.GetUniformLocation(shaderKey, "uPointEmitterCenter");
-        _unifLocPointMaxParticleEmitCount = shaderStorageRef.GetUniformLocation(shaderKey, "uMaxParticleEmitCount");
-        _unifLocPointMinParticleVelocity = shaderStorageRef.GetUniformLocation(shaderKey, "uMinParticleVelocity");
-        _unifLocPointMaxParticleVelocity = shaderStorageRef.GetUniformLocation(shaderKey, "uMaxParticleVelocity");
+        std::string programKey = _variant.ProgramKey(PARTICLE_RESET_SHADER_KEY, COMPUTE_STAGE_RESET);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        _computeProgramId = shaderStorageRef.GetShaderProgram(programKey);
+        ssboToReset->ConfigureConstantUniforms(_computeProgramId);
 
-        // now for the bar emitters
-        shaderKey = "particle reset bar emitter";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/Random.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/QuickNormalize.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/ParticleResetBarEmitter.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _computeProgramIdBarEmitters = shaderStorageRef.GetShaderProgram(shaderKey);
-        ssboToReset->ConfigureConstantUniforms(_computeProgramIdBarEmitters);
-
-        // uniform lookups for the bar emitter shader
-        // Note: This also requires a "min velocity between min and max".
-        _unifLocBarEmitterP1 = shaderStorageRef.GetUniformLocation(shaderKey, "uBarEmitterP1");
-        _unifLocBarEmitterP2 = shaderStorageRef.GetUniformLocation(shaderKey, "uBarEmitterP2");
-        _unifLocBarEmitterEmitDir = shaderStorageRef.GetUniformLocation(shaderKey, "uBarEmitterEmitDir");
-        _unifLocBarMaxParticleEmitCount = shaderStorageRef.GetUniformLocation(shaderKey, "uMaxParticleEmitCount");
-        _unifLocBarMinParticleVelocity = shaderStorageRef.GetUniformLocation(shaderKey, "uMinParticleVelocity");
-        _unifLocBarMaxParticleVelocity = shaderStorageRef.GetUniformLocation(shaderKey, "uMaxParticleVelocity");
+        _unifLocNumEmitters = shaderStorageRef.GetUniformLocation(programKey, "uNumEmitters");
+        _unifLocParticlesPerEmitterPerFrame = shaderStorageRef.GetUniformLocation(programKey, "uParticlesPerEmitterPerFrame");
+        _unifLocNumFreeIndicesToPop = shaderStorageRef.GetUniformLocation(programKey, "uNumFreeIndicesToPop");
+        _unifLocRandomSeed = shaderStorageRef.GetUniformLocation(programKey, "uRandomSeed");
+        _unifLocFrameNumber = shaderStorageRef.GetUniformLocation(programKey, "uFrameNumber");
 
         // uniform values are set in ResetParticles(...)
+
+        BuildResetGraph();
     }
     
     /*--------------------------------------------------------------------------------------------
@@ -106,8 +81,51 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     ParticleReset::~ParticleReset()
     {
-        glDeleteProgram(_computeProgramIdBarEmitters);
-        glDeleteProgram(_computeProgramIdPointEmitters);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(PARTICLE_RESET_SHADER_KEY, COMPUTE_STAGE_RESET));
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The particle buffer grew (see ParticleSsbo::Resize(...)), so the program's buffer size 
+        uniform is set again.  The reset's dispatch size comes from the emitters, not the 
+        buffer, so the graph stays as it is.
+    Parameters:
+        resizedSsbo     The same SSBO that was given to the constructor.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleReset::ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo)
+    {
+        _totalParticleCount = resizedSsbo->NumItems();
+        resizedSsbo->ConfigureConstantUniforms(_computeProgramId);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the shader program and hands it to ShaderStorage to compile and link.  Does 
+        not wait for the driver to finish it (see ParallelSort::SubmitShaders()).
+
+        Does nothing if the program was already submitted.
+    Parameters:
+        variant     The work group sizes and feature defines to build the shaders with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleReset::SubmitShaders(const ComputeShaderVariant &variant)
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (shaderStorageRef.ProgramExists(variant.ProgramKey(PARTICLE_RESET_SHADER_KEY, COMPUTE_STAGE_RESET)))
+        {
+            return;
+        }
+
+        std::string shaderKey = variant.ProgramKey(PARTICLE_RESET_SHADER_KEY, COMPUTE_STAGE_RESET);
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        variant.AddDefinesToProgram(shaderKey, COMPUTE_STAGE_RESET);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleReset/ParticleReset.comp");
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -115,13 +133,28 @@ namespace ShaderControllers
         An AddEmitter(...) overload that adds a point emitter to internal storage.  
     Parameters:
         pointEmitter    A shared pointer to a const point emitter.
+        sceneId         The scene that the emitter's particles belong to.
     Returns:    None
-    Creator: John Cox, 4/2017
+    Creator: John Cox, 4/2017 (scene ID added by agent, 10/2026)
     --------------------------------------------------------------------------------------------*/
-    void ParticleReset::AddEmitter(ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter)
+    void ParticleReset::AddEmitter(ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId)
     {
+        if (sceneId >= MAX_PARTICLE_SCENES)
+        {
+            fprintf(stderr, "ParticleReset::AddEmitter(...): scene ID %u is out of range (max %u scenes); emitter ignored\n", 
+                sceneId, MAX_PARTICLE_SCENES);
+            return;
+        }
+        if (_pointEmitters.size() + _barEmitters.size() >= MAX_EMITTERS)
+        {
+            fprintf(stderr, "ParticleReset::AddEmitter(...): already have the max of %u emitters; emitter ignored\n", 
+                MAX_EMITTERS);
+            return;
+        }
+
         // make a copy of it
         _pointEmitters.push_back(pointEmitter);
+        _pointEmitterSceneIds.push_back(sceneId);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -129,23 +162,58 @@ namespace ShaderControllers
         An AddEmitter(...) overload that adds a point emitter to internal storage.  
     Parameters:
         barEmitter  A shared pointer to a const bar emitter.
+        sceneId     The scene that the emitter's particles belong to.
     Returns:    None
-    Creator: John Cox, 4/2017
+    Creator: John Cox, 4/2017 (scene ID added by agent, 10/2026)
     --------------------------------------------------------------------------------------------*/
-    void ParticleReset::AddEmitter(ParticleEmitterBar::CONST_SHARED_PTR barEmitter)
+    void ParticleReset::AddEmitter(ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId)
     {
+        if (sceneId >= MAX_PARTICLE_SCENES)
+        {
+            fprintf(stderr, "ParticleReset::AddEmitter(...): scene ID %u is out of range (max %u scenes); emitter ignored\n", 
+                sceneId, MAX_PARTICLE_SCENES);
+            return;
+        }
+        if (_pointEmitters.size() + _barEmitters.size() >= MAX_EMITTERS)
+        {
+            fprintf(stderr, "ParticleReset::AddEmitter(...): already have the max of %u emitters; emitter ignored\n", 
+                MAX_EMITTERS);
+            return;
+        }
+
         // make a copy of it
         _barEmitters.push_back(barEmitter);
+        _barEmitterSceneIds.push_back(sceneId);
     }
 
     /*--------------------------------------------------------------------------------------------
     Description:
-        Dispatches a shader for each emitter, resetting up to particlesPerEmitterPerFrame for 
-        each emitter.
+        Sets the seed for the reset shader's random numbers and starts the frame count over, so 
+        everything that is emitted from here on out is the same as the last time that this seed 
+        was used (given the same emitters and the same particlesPerEmitterPerFrame).
+    Parameters:
+        seed    Any value.  
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleReset::SetRandomSeed(unsigned int seed)
+    {
+        _randomSeed = seed;
+        _frameNumber = 0;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Uploads the description of every emitter and then 
+        dispatches the reset shader once for all of them, resetting up to 
+        particlesPerEmitterPerFrame for each emitter.  Both are stages in _resetGraph (see 
+        BuildResetGraph()).
 
-        Particles are spread out evenly between all the emitters (or at least as best as 
-        possible; technically the first emitter gets first dibs at the inactive particles, then 
-        the second emitter, etc.).
+        There is one thread per particle that could be spawned (number of emitters * 
+        particlesPerEmitterPerFrame), and each one takes an inactive particle's index from its 
+        own place in the free list (see ParticleFreeListBuffer.comp), so the cost is 
+        proportional to the number of spawned particles, not to the size of the particle 
+        buffer.  A third stage then takes all of those indices off of the free list at once.
     Parameters:    
         particlesPerEmitterPerFrame     Limits the number of particles that are reset per frame 
                                         so that they don't all spawn at once.
@@ -162,62 +230,116 @@ namespace ShaderControllers
             return;
         }
 
-        // spreading the particles evenly between multiple emitters is done by letting all the 
-        // particle emitters have a go at all the inactive particles
-        // Note: Yes, this algorithm is such that emitters resetting particles have to travers 
-        // through the entire particle collection, but there isn't a way of telling the CPU 
-        // where they were when the last particle was reset.  Also, after the "particles per 
-        // emitter per frame" limit is reached, the vast majority of the threads will simply 
-        // return, so it's actually pretty fast.
-        GLuint numWorkGroupsX = (_totalParticleCount / PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X) + 1;
-        GLuint numWorkGroupsY = 1;
-        GLuint numWorkGroupsZ = 1;
-
-        // give all point emitters a chance to reactivate inactive particles at their positions
-        glUseProgram(_computeProgramIdPointEmitters);
-        glUniform1ui(_unifLocPointMaxParticleEmitCount, particlesPerEmitterPerFrame);
+        // every call is a "frame" as far as the random numbers are concerned, even if nothing 
+        // ends up being spawned, so that the count doesn't depend on the free list
+        unsigned int frameNumber = _frameNumber++;
+
+        // the emitters may have been moved since the last frame, so refresh all of them
+        // Note: The vector keeps its capacity, so this doesn't allocate.
+        _emitterDescriptors.clear();
         for (size_t pointEmitterCount = 0; pointEmitterCount < _pointEmitters.size(); pointEmitterCount++)
         {
-            // reset everything necessary to control the emission parameters for this emitter
-            _particleResetAtomicCounter->ResetCounter();
-
-            ParticleEmitterPoint::CONST_SHARED_PTR &emitter = _pointEmitters[pointEmitterCount];
-
-            glUniform1f(_unifLocPointMinParticleVelocity, emitter->GetMinVelocity());
-            glUniform1f(_unifLocPointMaxParticleVelocity, emitter->GetMaxVelocity());
-            glUniform4fv(_unifLocPointEmitterCenter, 1, glm::value_ptr(emitter->GetPos()));
-
-            // compute ALL the resets! (then make the results visible to the next use of the 
-            // SSBO and to vertext buffer)
-            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+            const ParticleEmitterPoint::CONST_SHARED_PTR &emitter = _pointEmitters[pointEmitterCount];
+            ParticleEmitterDescriptor descriptor;
+            descriptor._p1 = emitter->GetPos();
+            descriptor._minVelocity = emitter->GetMinVelocity();
+            descriptor._maxVelocity = emitter->GetMaxVelocity();
+            descriptor._emitterType = PARTICLE_EMITTER_TYPE_POINT;
+            descriptor._maxParticleEmitCount = particlesPerEmitterPerFrame;
+            descriptor._sceneId = _pointEmitterSceneIds[pointEmitterCount];
+            descriptor._firstEmissionIndex = static_cast<unsigned int>(_emitterDescriptors.size()) * particlesPerEmitterPerFrame;
+            _emitterDescriptors.push_back(descriptor);
         }
-
-        // and now for any bar emitters
-        glUseProgram(_computeProgramIdBarEmitters);
-        glUniform1ui(_unifLocBarMaxParticleEmitCount, particlesPerEmitterPerFrame);
         for (size_t barEmitterCount = 0; barEmitterCount < _barEmitters.size(); barEmitterCount++)
         {
-            _particleResetAtomicCounter->ResetCounter();
-
-            ParticleEmitterBar::CONST_SHARED_PTR &emitter = _barEmitters[barEmitterCount];
-
-            glUniform1f(_unifLocBarMinParticleVelocity, emitter->GetMinVelocity());
-            glUniform1f(_unifLocBarMaxParticleVelocity, emitter->GetMaxVelocity());
-
-            // each bar needs to upload three position vectors (p1, p2, and emit direction)
-            glUniform4fv(_unifLocBarEmitterP1, 1, glm::value_ptr(emitter->GetBarStart()));
-            glUniform4fv(_unifLocBarEmitterP2, 1, glm::value_ptr(emitter->GetBarEnd()));
-            glUniform4fv(_unifLocBarEmitterEmitDir, 1, glm::value_ptr(emitter->GetEmitDir()));
+            const ParticleEmitterBar::CONST_SHARED_PTR &emitter = _barEmitters[barEmitterCount];
+            ParticleEmitterDescriptor descriptor;
+            descriptor._p1 = emitter->GetBarStart();
+            descriptor._p2 = emitter->GetBarEnd();
+            descriptor._emitDir = emitter->GetEmitDir();
+            descriptor._minVelocity = emitter->GetMinVelocity();
+            descriptor._maxVelocity = emitter->GetMaxVelocity();
+            descriptor._emitterType = PARTICLE_EMITTER_TYPE_BAR;
+            descriptor._maxParticleEmitCount = particlesPerEmitterPerFrame;
+            descriptor._sceneId = _barEmitterSceneIds[barEmitterCount];
+            descriptor._firstEmissionIndex = static_cast<unsigned int>(_emitterDescriptors.size()) * particlesPerEmitterPerFrame;
+            _emitterDescriptors.push_back(descriptor);
+        }
+        // AddEmitter(...) refuses any past MAX_EMITTERS, so they all fit
+        unsigned int numEmitters = static_cast<unsigned int>(_emitterDescriptors.size());
 
-            // MOAR resets!
-            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+        // Note: It used to be that resetting particles had to traverse through the entire 
+        // particle collection because there wasn't a way of telling the CPU where the inactive 
+        // particles were.  Now the free list on the GPU knows where they are.
+        unsigned int maxParticlesToSpawn = numEmitters * particlesPerEmitterPerFrame;
+        if (maxParticlesToSpawn == 0)
+        {
+            return;
         }
 
-        // cleanup
-        glUseProgram(0);
+        // picked up by the stages in _resetGraph
+        _numEmittersThisReset = numEmitters;
+        _particlesPerEmitterThisReset = particlesPerEmitterPerFrame;
+        _frameNumberThisReset = frameNumber;
+        _numWorkGroupsThisReset = (maxParticlesToSpawn / _variant.ItemsPerWorkGroup(COMPUTE_STAGE_RESET)) + 1;
+
+        // upload, then compute ALL the resets, then take them off of the free list
+        _resetGraph.Execute();
     }
 
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Declares the reset's stages and the buffers that each one touches.  The dispatch graph 
+        works out the barriers.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleReset::BuildResetGraph()
+    {
+        // Note: The reset shader only reads the emitters, so the upload never waits on it, and 
+        // the reset shader can read the upload without a barrier.
+        std::vector<BufferAccess> uploadAccesses =
+        {
+            BufferAccess(PARTICLE_EMITTER_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, true),
+        };
+        _resetGraph.AddStage("upload emitters", uploadAccesses, [this]()
+        {
+            _emitterSsbo->UploadEmitters(_emitterDescriptors);
+        });
+
+        std::vector<BufferAccess> resetAccesses =
+        {
+            BufferAccess(PARTICLE_EMITTER_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, false),
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        _resetGraph.AddStage("reset particles", resetAccesses, [this]()
+        {
+            glUseProgram(_computeProgramId);
+            glUniform1ui(_unifLocNumEmitters, _numEmittersThisReset);
+            glUniform1ui(_unifLocParticlesPerEmitterPerFrame, _particlesPerEmitterThisReset);
+            glUniform1ui(_unifLocNumFreeIndicesToPop, 0);
+            glUniform1ui(_unifLocRandomSeed, _randomSeed);
+            glUniform1ui(_unifLocFrameNumber, _frameNumberThisReset);
+            glDispatchCompute(_numWorkGroupsThisReset, 1, 1);
+            glUseProgram(0);
+        });
 
+        // Note: Every reset thread reads the free list's count, so the count can't come down 
+        // until all of them are done.  The reset's free list access is only a read, which the 
+        // graph doesn't wait on, so the barrier is asked for here.
+        std::vector<BufferAccess> popAccesses =
+        {
+            BufferAccess(PARTICLE_FREE_LIST_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+        };
+        _resetGraph.AddStage("pop free list", popAccesses, [this]()
+        {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            glUseProgram(_computeProgramId);
+            glUniform1ui(_unifLocNumFreeIndicesToPop, _numEmittersThisReset * _particlesPerEmitterThisReset);
+            glDispatchCompute(1, 1, 1);
+            glUseProgram(0);
+        });
+    }
 }
@@ -3,7 +3,7 @@
 #include <string>
 
 #include "Shaders/ShaderStorage.h"
-#include "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 #include "ThirdParty/glm/gtc/type_ptr.hpp"
@@ -12,6 +12,9 @@
 
 namespace ShaderControllers
 {
+    // the ShaderStorage key
+    static const std::string PARTICLE_UPDATE_SHADER_KEY = "particle update";
+
     /*--------------------------------------------------------------------------------------------
     Description:
         Gives members initial values.
@@ -23,41 +26,40 @@ namespace ShaderControllers
                         for the compute shader.
         particleRegionCenter    Used in conjunction with radius to tell when a particle goes 
         particleRegionRedius    out of bounds.
+        variant         The work group sizes and feature defines to build the shaders with.
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
-    ParticleUpdate::ParticleUpdate(const ParticleSsbo::SHARED_PTR &ssboToUpdate) :
+    ParticleUpdate::ParticleUpdate(const ParticleSsbo::SHARED_PTR &ssboToUpdate,
+        const ComputeShaderVariant &variant) :
+        _variant(variant),
         _totalParticleCount(0),
         _activeParticleCount(0),
+        _drawCommandBufferId(0),
         _computeProgramId(0),
         _unifLocDeltaTimeSec(-1),
+        _deltaTimeSecThisUpdate(0.0f),
+        _updateGraph("particle update"),
         _activeParticlesAtomicCounter(nullptr)
     {
         _totalParticleCount = ssboToUpdate->NumItems();
-        _activeParticlesAtomicCounter = PersistentAtomicCounterBuffer::GetInstance();
+        _drawCommandBufferId = ssboToUpdate->DrawCommandBufferId();
+        _activeParticlesAtomicCounter = std::make_shared<PersistentAtomicCounterBuffer>();
 
-        // construct the compute shader
-        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        SubmitShaders(variant);
 
-        std::string shaderKey = "particle update";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/ComputeShaderWorkGroupSizes.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/SsboBufferBindings.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/CrossShaderUniformLocations.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleBuffer.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleRegionBoundaries.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleUpdate.comp");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _computeProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        std::string programKey = _variant.ProgramKey(PARTICLE_UPDATE_SHADER_KEY, COMPUTE_STAGE_UPDATE);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        _computeProgramId = shaderStorageRef.GetShaderProgram(programKey);
         ssboToUpdate->ConfigureConstantUniforms(_computeProgramId);
 
-        _unifLocDeltaTimeSec = shaderStorageRef.GetUniformLocation(shaderKey, "uDeltaTimeSec");
+        _unifLocDeltaTimeSec = shaderStorageRef.GetUniformLocation(programKey, "uDeltaTimeSec");
 
         // set uniform values and generate the atomic counters for the number of active particles
         glUseProgram(_computeProgramId);
         // delta time set in Update(...)
+
+        BuildUpdateGraph();
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -69,13 +71,61 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     ParticleUpdate::~ParticleUpdate()
     {
-        glDeleteProgram(_computeProgramId);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(_variant.ProgramKey(PARTICLE_UPDATE_SHADER_KEY, COMPUTE_STAGE_UPDATE));
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The particle buffer grew (see ParticleSsbo::Resize(...)), so the program's buffer size 
+        uniform is set again and the graph is rebuilt with the new dispatch size.
+    Parameters:
+        resizedSsbo     The same SSBO that was given to the constructor.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleUpdate::ParticleBufferResized(const ParticleSsbo::SHARED_PTR &resizedSsbo)
+    {
+        _totalParticleCount = resizedSsbo->NumItems();
+        _drawCommandBufferId = resizedSsbo->DrawCommandBufferId();
+        resizedSsbo->ConfigureConstantUniforms(_computeProgramId);
+
+        _updateGraph.Clear();
+        BuildUpdateGraph();
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the shader program and hands it to ShaderStorage to compile and link.  Does 
+        not wait for the driver to finish it (see ParallelSort::SubmitShaders()).
+
+        Does nothing if the program was already submitted.
+    Parameters:
+        variant     The work group sizes and feature defines to build the shaders with.
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleUpdate::SubmitShaders(const ComputeShaderVariant &variant)
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (shaderStorageRef.ProgramExists(variant.ProgramKey(PARTICLE_UPDATE_SHADER_KEY, COMPUTE_STAGE_UPDATE)))
+        {
+            return;
+        }
+
+        std::string shaderKey = variant.ProgramKey(PARTICLE_UPDATE_SHADER_KEY, COMPUTE_STAGE_UPDATE);
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        variant.AddDefinesToProgram(shaderKey, COMPUTE_STAGE_UPDATE);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleUpdate.comp");
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
     }
 
     /*--------------------------------------------------------------------------------------------
     Description:
-        Resets the "num active particles" atomic counter, dispatches the shader, and reads the 
-        number of active particles after the shader finished.
+        Resets the "num active particles" atomic counter, dispatches the shader (both in 
+        _updateGraph), and picks up the number of active particles from the most recent update that the GPU has finished 
+        (this does not wait for the update that was just dispatched).
     
         The number of work groups is based on the maximum number of particles.
     Parameters:    
@@ -85,37 +135,70 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     void ParticleUpdate::Update(float deltaTimeSec)
     {
-        // spread out the particles between lots of work items, but keep it 1-dimensional 
-        // because the particle buffer is a 1-dimensional array
-        // Note: +1 because integer division drops the remainder, and I want all the particles 
-        // to have a shot.
-        GLuint numWorkGroupsX = (_totalParticleCount / PARTICLE_OPERATIONS_WORK_GROUP_SIZE_X) + 1;
-        GLuint numWorkGroupsY = 1;
-        GLuint numWorkGroupsZ = 1;
-
-        glUseProgram(_computeProgramId);
+        _deltaTimeSecThisUpdate = deltaTimeSec;
+        _updateGraph.Execute();
 
-        glUniform1f(_unifLocDeltaTimeSec, deltaTimeSec);
-        _activeParticlesAtomicCounter->ResetCounter();
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-
-        // the results of the moved particles need to be visible to the next compute shader that 
-        // accesses the buffer, vertex data sourced from the particle buffer need to reflect the 
-        // updated movements, and reads from atomic counters must be visible as well (for number 
-        // of active particles)
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
-
-        // cleanup
-        glUseProgram(0);
-
-        // now that all active particles have updated, check how many active particles exist 
+        // check how many active particles existed as of the latest completed update
         _activeParticleCount = _activeParticlesAtomicCounter->GetCounterValue();
     }
 
     /*--------------------------------------------------------------------------------------------
     Description:
-        A simple getter for the number of particles that were active on the last Update(...) 
-        call.
+        Declares the update's stages and the buffers that they touch.  The dispatch graph 
+        works out the barriers.
+
+        The second stage copies the counter into the draw command so that RenderParticles only 
+        draws the particles that were active.  The counter is incremented before the bounds 
+        check (see ParticleUpdate.comp), so the count includes the particles that went inactive 
+        during this update.  That draws a few extra (the vertex shader hides them), but never 
+        too few.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void ParticleUpdate::BuildUpdateGraph()
+    {
+        // Note: The atomic counter is both cleared (glClearBufferSubData(...)) and incremented 
+        // by the shader.
+        std::vector<BufferAccess> updateAccesses =
+        {
+            BufferAccess(PARTICLE_BUFFER_BINDING, BufferAccessType::SHADER_STORAGE, true),
+            BufferAccess(ATOMIC_COUNTER_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, true),
+            BufferAccess(ATOMIC_COUNTER_BUFFER_BINDING, BufferAccessType::ATOMIC_COUNTER, true),
+        };
+        _updateGraph.AddStage("update particles", updateAccesses, [this]()
+        {
+            // spread out the particles between lots of work items, but keep it 1-dimensional 
+            // because the particle buffer is a 1-dimensional array
+            // Note: +1 because integer division drops the remainder, and I want all the 
+            // particles to have a shot.
+            GLuint numWorkGroupsX = (_totalParticleCount / _variant.ItemsPerWorkGroup(COMPUTE_STAGE_UPDATE)) + 1;
+            GLuint numWorkGroupsY = 1;
+            GLuint numWorkGroupsZ = 1;
+
+            glUseProgram(_computeProgramId);
+            glUniform1f(_unifLocDeltaTimeSec, _deltaTimeSecThisUpdate);
+            _activeParticlesAtomicCounter->ResetCounter();
+            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+            glUseProgram(0);
+        });
+
+        std::vector<BufferAccess> drawCountAccesses =
+        {
+            BufferAccess(ATOMIC_COUNTER_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, false),
+            BufferAccess(PARTICLE_DRAW_COMMAND_BUFFER_BINDING, BufferAccessType::BUFFER_UPDATE, true),
+        };
+        _updateGraph.AddStage("copy draw count", drawCountAccesses, [this]()
+        {
+            _activeParticlesAtomicCounter->CopyCounterToBuffer(_drawCommandBufferId,
+                ParticleSsbo::DRAW_COMMAND_COUNT_OFFSET_BYTES);
+        });
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        A simple getter for the number of particles that were active as of the most recent 
+        Update(...) that the GPU has finished.
         
         Useful for performance comparison with CPU version.
     Parameters: None
@@ -2,11 +2,16 @@
 
 #include <string>
 #include "Shaders/ShaderStorage.h"
+#include "Include/ShaderControllers/MemoryBarrierTracker.h"
+#include "Shaders/ComputeHeaders/SsboBufferBindings.comp"
 
 #include "ThirdParty/glload/include/glload/gl_4_4.h"
 
 namespace ShaderControllers
 {
+    // the ShaderStorage key
+    static const std::string PARTICLE_RENDER_SHADER_KEY = "particle render";
+
     /*--------------------------------------------------------------------------------------------
     Description:
         Gives members initial values.
@@ -19,18 +24,10 @@ namespace ShaderControllers
     RenderParticles::RenderParticles() :
         _renderProgramId(0)
     {
-        // construct the compute shader
-        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        SubmitShaders();
 
-        std::string shaderKey = "particle render";
-        shaderStorageRef.NewCompositeShader(shaderKey);
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ComputeHeaders/Version.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/CountNearbyParticlesLimits.comp");
-        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleRender.vert");
-        shaderStorageRef.CompileCompositeShader(shaderKey, GL_VERTEX_SHADER);
-        shaderStorageRef.AddAndCompileShaderFile(shaderKey, "Shaders/ParticleRender.frag", GL_FRAGMENT_SHADER);
-        shaderStorageRef.LinkShader(shaderKey);
-        _renderProgramId = shaderStorageRef.GetShaderProgram(shaderKey);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        _renderProgramId = shaderStorageRef.GetShaderProgram(PARTICLE_RENDER_SHADER_KEY);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -42,7 +39,34 @@ namespace ShaderControllers
     --------------------------------------------------------------------------------------------*/
     RenderParticles::~RenderParticles()
     {
-        glDeleteProgram(_renderProgramId);
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        shaderStorageRef.DeleteShader(PARTICLE_RENDER_SHADER_KEY);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Assembles the shader program and hands it to ShaderStorage to compile and link.  Does 
+        not wait for the driver to finish it (see ParallelSort::SubmitShaders()).
+
+        Does nothing if the program was already submitted.
+    Parameters: None
+    Returns:    None
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    void RenderParticles::SubmitShaders()
+    {
+        ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+        if (shaderStorageRef.ProgramExists(PARTICLE_RENDER_SHADER_KEY))
+        {
+            return;
+        }
+
+        std::string shaderKey = PARTICLE_RENDER_SHADER_KEY;
+        shaderStorageRef.NewCompositeShader(shaderKey);
+        shaderStorageRef.AddPartialShaderFile(shaderKey, "Shaders/ParticleRender.vert");
+        shaderStorageRef.CompileCompositeShader(shaderKey, GL_VERTEX_SHADER);
+        shaderStorageRef.AddAndCompileShaderFile(shaderKey, "Shaders/ParticleRender.frag", GL_FRAGMENT_SHADER);
+        shaderStorageRef.LinkShader(shaderKey);
     }
 
     /*--------------------------------------------------------------------------------------------
@@ -62,19 +86,38 @@ namespace ShaderControllers
 
     /*--------------------------------------------------------------------------------------------
     Description:
-        Binds the VAO for the particle SSBO, then calls glDrawArrays(...).
+        Binds the VAO for the particle SSBO, then calls glDrawArraysIndirect(...) with the 
+        SSBO's draw command.  The count in the command is the number of active particles, 
+        which were put at the front of the buffer by the sort, and it was filled in on the GPU 
+        (see ParticleUpdate), so only the active particles go through the vertex shader and 
+        the CPU doesn't need to know how many there are.
+
+        The vertices are the 12-byte render vertices that the count stage writes (see 
+        ParticleRenderBuffer.comp), not the 64-byte particles, so the vertex fetch only reads 
+        what the vertex shader uses.
+
+        The compute controllers no longer issue GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT after every 
+        dispatch, so it is issued here (once) if the vertices were written since the last draw.
+
+        Note: This used to be glDrawArrays(...) over the whole buffer, and the vertex shader 
+        hid the inactive particles, so every empty slot still cost a vertex.
     Parameters: 
-        particleSsboToRender    Contains the VAO ID, draw style, and number of vertices.
+        particleSsboToRender    Contains the VAO ID, draw style, and draw command.
     Returns:    None
     Creator:    John Cox, 4/2017
     --------------------------------------------------------------------------------------------*/
     void RenderParticles::Render(const ParticleSsbo::SHARED_PTR &particleSsboToRender) const
     {
+        MemoryBarrierTracker::GetInstance().WaitForAccess(
+            BufferAccess(PARTICLE_RENDER_BUFFER_BINDING, BufferAccessType::VERTEX_ATTRIB, false));
+        MemoryBarrierTracker::GetInstance().WaitForAccess(
+            BufferAccess(PARTICLE_DRAW_COMMAND_BUFFER_BINDING, BufferAccessType::COMMAND, false));
+
         glUseProgram(_renderProgramId);
         glBindVertexArray(particleSsboToRender->VaoId());
-
-        // in the case of particles, "num items" == "num vertices", so either getter is fine
-        glDrawArrays(particleSsboToRender->DrawStyle(), 0, particleSsboToRender->NumVertices());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, particleSsboToRender->DrawCommandBufferId());
+        glDrawArraysIndirect(particleSsboToRender->DrawStyle(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
         glBindVertexArray(0);
         glUseProgram(0);
     }
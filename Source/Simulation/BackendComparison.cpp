@@ -0,0 +1,429 @@
+#include "Include/Simulation/BackendComparison.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Include/Particles/MortonCode.h"
+
+
+const float BackendComparison::FLOAT_TOLERANCE = 1e-4f;
+const double BackendComparison::MAX_MISMATCH_FRACTION = 0.001;
+
+static const char *CHECK_NAMES[] =
+{
+    "reset: active per scene",
+    "reset: new particles",
+    "update: active flags",
+    "update: positions",
+    "sort: Morton Codes",
+    "sort: order",
+    "collide: velocities",
+    "count nearby: counts"
+};
+
+// these must match exactly (see the class description)
+static const bool CHECK_IS_EXACT[] =
+{
+    true,
+    false,
+    false,
+    false,
+    false,
+    true,
+    false,
+    false
+};
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How far apart two floats are, relative to the first one if it is bigger than 1.
+Parameters:
+    expected    Self-explanatory.
+    actual      Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static double FloatError(float expected, float actual)
+{
+    double scale = std::max(1.0, fabs(static_cast<double>(expected)));
+    return fabs(static_cast<double>(expected) - static_cast<double>(actual)) / scale;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The bigger of the X and Y errors.  The simulation is 2D, so Z and W are left out.
+Parameters:
+    expected    Self-explanatory.
+    actual      Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static double Vec2Error(const glm::vec4 &expected, const glm::vec4 &actual)
+{
+    return std::max(FloatError(expected.x, actual.x), FloatError(expected.y, actual.y));
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Orders new particles so that the GPU's and the CPU's can be matched up one to one no
+    matter which slots they went into.
+Parameters:
+    a   Self-explanatory.
+    b   Self-explanatory.
+Returns:
+    True if "a" goes first.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static bool NewParticleLessThan(const Particle &a, const Particle &b)
+{
+    if (a._sceneId != b._sceneId) return a._sceneId < b._sceneId;
+    if (a._position.x != b._position.x) return a._position.x < b._position.x;
+    if (a._position.y != b._position.y) return a._position.y < b._position.y;
+    if (a._velocity.x != b._velocity.x) return a._velocity.x < b._velocity.x;
+    return a._velocity.y < b._velocity.y;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A copy of the particle with the fields that the sort may change (the Morton Code) or that
+    nothing writes (the padding) zeroed, so that a particle can be found again after the
+    sort by its bytes.
+Parameters:
+    p   Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static Particle SortInvariantParticle(const Particle &p)
+{
+    Particle copy = p;
+    copy._mortonCode = 0;
+    copy._padding = 0;
+    return copy;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Zeroes the totals.  The thread pool is one per hardware thread.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+BackendComparison::BackendComparison() :
+    _threadPool(0),
+    _radixSort(_threadPool)
+{
+    memset(_checkTotals, 0, sizeof(_checkTotals));
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks ResetParticles(...).  Both backends reset the same number of particles per
+    emitter.  They take free slots in the same order too (see ParticleFreeListBuffer.comp), 
+    but that is a separate question, so the new particles (inactive before, active after) are 
+    compared as a set: counted per scene, then sorted (see
+    NewParticleLessThan(...)) and compared in that order.
+Parameters:
+    before      What both backends started from.
+    gpuAfter    The GPU's particles after the reset.
+    cpuAfter    The CPU's particles after the reset.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::CompareReset(const std::vector<Particle> &before, const std::vector<Particle> &gpuAfter,
+    const std::vector<Particle> &cpuAfter)
+{
+    std::vector<Particle> gpuNewParticles;
+    std::vector<Particle> cpuNewParticles;
+    for (size_t index = 0; index < before.size(); index++)
+    {
+        if (before[index]._isActive != 0)
+        {
+            continue;
+        }
+        if (gpuAfter[index]._isActive != 0)
+        {
+            gpuNewParticles.push_back(gpuAfter[index]);
+        }
+        if (cpuAfter[index]._isActive != 0)
+        {
+            cpuNewParticles.push_back(cpuAfter[index]);
+        }
+    }
+
+    unsigned int gpuSceneCounts[MAX_PARTICLE_SCENES] = { 0 };
+    unsigned int cpuSceneCounts[MAX_PARTICLE_SCENES] = { 0 };
+    for (size_t index = 0; index < gpuNewParticles.size(); index++)
+    {
+        gpuSceneCounts[gpuNewParticles[index]._sceneId % MAX_PARTICLE_SCENES]++;
+    }
+    for (size_t index = 0; index < cpuNewParticles.size(); index++)
+    {
+        cpuSceneCounts[cpuNewParticles[index]._sceneId % MAX_PARTICLE_SCENES]++;
+    }
+    for (unsigned int sceneId = 0; sceneId < MAX_PARTICLE_SCENES; sceneId++)
+    {
+        double difference = fabs(static_cast<double>(gpuSceneCounts[sceneId]) - cpuSceneCounts[sceneId]);
+        Record(CHECK_RESET_ACTIVE_PER_SCENE, gpuSceneCounts[sceneId] == cpuSceneCounts[sceneId], difference);
+    }
+
+    // if the counts are off then the pairing is too, so only as many as both have
+    std::sort(gpuNewParticles.begin(), gpuNewParticles.end(), NewParticleLessThan);
+    std::sort(cpuNewParticles.begin(), cpuNewParticles.end(), NewParticleLessThan);
+    size_t numPairs = std::min(gpuNewParticles.size(), cpuNewParticles.size());
+    for (size_t index = 0; index < numPairs; index++)
+    {
+        const Particle &gpuParticle = gpuNewParticles[index];
+        const Particle &cpuParticle = cpuNewParticles[index];
+        double error = std::max(Vec2Error(gpuParticle._position, cpuParticle._position),
+            Vec2Error(gpuParticle._velocity, cpuParticle._velocity));
+        bool matches = (gpuParticle._sceneId == cpuParticle._sceneId) && (error <= FLOAT_TOLERANCE);
+        Record(CHECK_RESET_NEW_PARTICLES, matches, error);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks Update(...): every particle must be active on both or neither, and the ones that
+    are active on both must be in the same place.
+Parameters:
+    gpuAfter    The GPU's particles after the update.
+    cpuAfter    The CPU's particles after the update, from the same starting particles.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::CompareUpdate(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter)
+{
+    for (size_t index = 0; index < gpuAfter.size(); index++)
+    {
+        bool gpuIsActive = (gpuAfter[index]._isActive != 0);
+        bool cpuIsActive = (cpuAfter[index]._isActive != 0);
+        Record(CHECK_UPDATE_ACTIVE_FLAGS, gpuIsActive == cpuIsActive, (gpuIsActive == cpuIsActive) ? 0.0 : 1.0);
+        if (gpuIsActive && cpuIsActive)
+        {
+            double error = Vec2Error(gpuAfter[index]._position, cpuAfter[index]._position);
+            Record(CHECK_UPDATE_POSITIONS, error <= FLOAT_TOLERANCE, error);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks the GPU's Sort().  The CPU isn't run; CpuRadixSort is the reference instead, fed
+    the GPU's own sort keys, so that a Morton Code that rounded differently doesn't look like
+    a bad sort.
+
+    (1) Recovers where each particle went: the sort only moves particles and fills in active
+    particles' Morton Codes, so before and after, sorted by everything else (and then by
+    index, which keeps equal particles in order, as a stable sort would), line up one to one.
+    A particle that can't be found means that the sort damaged it, and the whole order check
+    fails.
+    (2) The GPU's Morton Codes against MortonCode::PositionToMortonCode(...) for the same
+    positions.
+    (3) The GPU's order against CpuRadixSort::SortToPermutation(...) of the keys that the GPU
+    sorted on (rebuilt from the GPU's Morton Codes).
+Parameters:
+    before      The particles before the sort.
+    gpuAfter    The GPU's particles after it.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::CompareSort(const std::vector<Particle> &before, const std::vector<Particle> &gpuAfter)
+{
+    unsigned int numParticles = static_cast<unsigned int>(before.size());
+    std::vector<Particle> invariantBefore(numParticles);
+    std::vector<Particle> invariantAfter(numParticles);
+    std::vector<unsigned int> beforeOrder(numParticles);
+    std::vector<unsigned int> afterOrder(numParticles);
+    for (unsigned int index = 0; index < numParticles; index++)
+    {
+        invariantBefore[index] = SortInvariantParticle(before[index]);
+        invariantAfter[index] = SortInvariantParticle(gpuAfter[index]);
+        beforeOrder[index] = index;
+        afterOrder[index] = index;
+    }
+    auto byBytesThenIndex = [](const std::vector<Particle> &particles)
+    {
+        return [&particles](unsigned int a, unsigned int b)
+        {
+            int compare = memcmp(&particles[a], &particles[b], sizeof(Particle));
+            return (compare != 0) ? (compare < 0) : (a < b);
+        };
+    };
+    std::sort(beforeOrder.begin(), beforeOrder.end(), byBytesThenIndex(invariantBefore));
+    std::sort(afterOrder.begin(), afterOrder.end(), byBytesThenIndex(invariantAfter));
+
+    // (1)
+    // Note: The GPU's Morton Codes are indexed by where the particles came from so that the
+    // keys line up with the "before" indices, which is what the permutation is made of.
+    std::vector<unsigned int> gpuPermutation(numParticles);
+    std::vector<unsigned int> gpuKeys(numParticles);
+    bool isPermutation = true;
+    for (unsigned int rank = 0; rank < numParticles; rank++)
+    {
+        unsigned int sourceIndex = beforeOrder[rank];
+        unsigned int destinationIndex = afterOrder[rank];
+        if (memcmp(&invariantBefore[sourceIndex], &invariantAfter[destinationIndex], sizeof(Particle)) != 0)
+        {
+            isPermutation = false;
+        }
+        gpuPermutation[destinationIndex] = sourceIndex;
+
+        const Particle &sorted = gpuAfter[destinationIndex];
+        gpuKeys[sourceIndex] = (sorted._isActive != 0) ?
+            MortonCode::ParticleSortKey(sorted._sceneId, sorted._mortonCode) :
+            MortonCode::INACTIVE_PARTICLE_SORT_KEY;
+
+        // (2)
+        if (sorted._isActive != 0)
+        {
+            unsigned int expectedMortonCode = MortonCode::PositionToMortonCode(
+                sorted._position.x, sorted._position.y, sorted._position.z);
+            Record(CHECK_SORT_MORTON_CODES, sorted._mortonCode == expectedMortonCode,
+                (sorted._mortonCode == expectedMortonCode) ? 0.0 : 1.0);
+        }
+    }
+
+    // (3)
+    std::vector<unsigned int> expectedPermutation;
+    _radixSort.SortToPermutation(gpuKeys, expectedPermutation);
+    for (unsigned int index = 0; index < numParticles; index++)
+    {
+        bool matches = isPermutation && (gpuPermutation[index] == expectedPermutation[index]);
+        Record(CHECK_SORT_ORDER, matches, matches ? 0.0 : 1.0);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks DetectAndResolveCollisions() by the active particles' velocities.
+Parameters:
+    gpuAfter    The GPU's particles after the collisions.
+    cpuAfter    The CPU's particles after the collisions, from the same starting particles.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::CompareCollisions(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter)
+{
+    for (size_t index = 0; index < gpuAfter.size(); index++)
+    {
+        if (gpuAfter[index]._isActive != 0)
+        {
+            double error = Vec2Error(gpuAfter[index]._velocity, cpuAfter[index]._velocity);
+            Record(CHECK_COLLIDE_VELOCITIES, error <= FLOAT_TOLERANCE, error);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Checks CountNearbyParticles() by the active particles' counts.  The error is how far off
+    the count is.
+Parameters:
+    gpuAfter    The GPU's particles after counting.
+    cpuAfter    The CPU's particles after counting, from the same starting particles.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::CompareNearbyCounts(const std::vector<Particle> &gpuAfter, const std::vector<Particle> &cpuAfter)
+{
+    for (size_t index = 0; index < gpuAfter.size(); index++)
+    {
+        if (gpuAfter[index]._isActive != 0)
+        {
+            unsigned int gpuCount = gpuAfter[index]._numberOfNearbyParticles;
+            unsigned int cpuCount = cpuAfter[index]._numberOfNearbyParticles;
+            Record(CHECK_COUNT_NEARBY, gpuCount == cpuCount, fabs(static_cast<double>(gpuCount) - cpuCount));
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: None
+Returns:
+    True if every check passed (see the class description).
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool BackendComparison::Passed() const
+{
+    for (int checkIndex = 0; checkIndex < NUM_CHECKS; checkIndex++)
+    {
+        if (!CheckPassed(static_cast<Check>(checkIndex)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    One line per check: how many things it checked, how many were off, the worst error, and
+    whether it passed.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::PrintReport() const
+{
+    printf("%-26s %12s %10s %12s %6s\n", "check", "checked", "mismatched", "max error", "");
+    for (int checkIndex = 0; checkIndex < NUM_CHECKS; checkIndex++)
+    {
+        const CheckTotals &totals = _checkTotals[checkIndex];
+        printf("%-26s %12llu %10llu %12.3g %6s\n", CHECK_NAMES[checkIndex], totals._numChecked,
+            totals._numMismatches, totals._maxError, CheckPassed(static_cast<Check>(checkIndex)) ? "ok" : "FAIL");
+    }
+    printf("tolerance: %g (float), %g of each fuzzy check may mismatch\n", FLOAT_TOLERANCE, MAX_MISMATCH_FRACTION);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds one thing that was checked to a check's totals.
+Parameters:
+    check   Self-explanatory.
+    matches Whether it was within tolerance.
+    error   How far off it was.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void BackendComparison::Record(Check check, bool matches, double error)
+{
+    CheckTotals &totals = _checkTotals[check];
+    totals._numChecked++;
+    if (!matches)
+    {
+        totals._numMismatches++;
+    }
+    totals._maxError = std::max(totals._maxError, error);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Exact checks pass with no mismatches, the others with up to MAX_MISMATCH_FRACTION of what
+    they checked.  A check that didn't get to check anything fails, since that means the
+    comparison didn't run the stage.
+Parameters:
+    check   Self-explanatory.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool BackendComparison::CheckPassed(Check check) const
+{
+    const CheckTotals &totals = _checkTotals[check];
+    if (totals._numChecked == 0)
+    {
+        return false;
+    }
+    if (CHECK_IS_EXACT[check])
+    {
+        return totals._numMismatches == 0;
+    }
+    return totals._numMismatches <= static_cast<unsigned long long>(totals._numChecked * MAX_MISMATCH_FRACTION);
+}
@@ -0,0 +1,681 @@
+#include "Include/Simulation/CpuParticleKernels.h"
+
+#include <string.h>
+
+#include "Include/Particles/MortonCode.h"
+#include "Shaders/ParticleRegionBoundaries.comp"
+#include "Shaders/ParticleScenes.comp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_PARTICLE_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Visual Studio lets any function use any intrinsic, but gcc and clang only let a function use
+// the ones for the instruction sets that it is compiled for, so tell them per function
+#if defined(CPU_PARTICLE_KERNELS_X86) && !defined(_MSC_VER)
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+
+namespace CpuParticleKernels
+{
+    static const char *SIMD_LEVEL_NAMES[NUM_SIMD_LEVELS] = { "scalar", "sse4.1", "avx2" };
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Counts the 1s.  The vector loops turn their masks into bits with movemask, and this
+        counts the active particles in them without needing the POPCNT instruction.
+    Parameters:
+        bits    Self-explanatory.
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    static unsigned int CountBits(unsigned int bits)
+    {
+        unsigned int count = 0;
+        while (bits != 0)
+        {
+            bits &= bits - 1;
+            count++;
+        }
+        return count;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Does ParticleUpdate.comp's work on the particles in [begin, end).  The vector versions
+        also use this for what's left over.  See CpuParticleSimulation::Update(...).
+    Parameters:
+        particles       Self-explanatory.
+        begin           The first particle.
+        end             One past the last particle.
+        deltaTimeSec    Self-explanatory.
+        freedIndices    The particles that left the region are added to this, in order.
+    Returns:
+        The number of particles that were active before moving.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    static unsigned int UpdateParticlesScalar(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, float deltaTimeSec, std::vector<unsigned int> &freedIndices)
+    {
+        float regionCenterX = static_cast<float>(PARTICLE_REGION_CENTER_X);
+        float regionCenterY = static_cast<float>(PARTICLE_REGION_CENTER_Y);
+        float regionRadius = static_cast<float>(PARTICLE_REGION_RADIUS);
+        float regionRadiusSqr = regionRadius * regionRadius;
+
+        unsigned int numActive = 0;
+        for (unsigned int index = begin; index < end; index++)
+        {
+            if (particles._isActive[index] == 0)
+            {
+                continue;
+            }
+            numActive++;
+
+            float x = particles._positionX[index] + (particles._velocityX[index] * deltaTimeSec);
+            float y = particles._positionY[index] + (particles._velocityY[index] * deltaTimeSec);
+            float z = particles._positionZ[index] + (particles._velocityZ[index] * deltaTimeSec);
+            particles._positionX[index] = x;
+            particles._positionY[index] = y;
+            particles._positionZ[index] = z;
+
+            float centerToParticleX = x - regionCenterX;
+            float centerToParticleY = y - regionCenterY;
+            float distToParticleSqr = (centerToParticleX * centerToParticleX) +
+                (centerToParticleY * centerToParticleY) + (z * z);
+            if (distToParticleSqr > regionRadiusSqr)
+            {
+                particles._isActive[index] = 0;
+                freedIndices.push_back(index);
+            }
+
+            particles._hasCollidedAlreadyThisFrame[index] = 0;
+            particles._numberOfNearbyParticles[index] = 0;
+        }
+        return numActive;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Makes the sort item ((key << 32) | index, see CpuRadixSort) for each particle in
+        [begin, end), and records the active ones' Morton Codes, like
+        ParticleDataToIntermediateData.comp.  The vector versions also use this for what's
+        left over.
+    Parameters:
+        particles   Self-explanatory.
+        begin       The first particle.
+        end         One past the last particle.
+        sortItems   Entries [begin, end) are written.
+    Returns:
+        The number of active particles.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    static unsigned int MakeSortItemsScalar(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, unsigned long long *sortItems)
+    {
+        unsigned int numActive = 0;
+        for (unsigned int index = begin; index < end; index++)
+        {
+            unsigned int sortKey = MortonCode::INACTIVE_PARTICLE_SORT_KEY;
+            if (particles._isActive[index] != 0)
+            {
+                unsigned int mortonCode = MortonCode::PositionToMortonCode(particles._positionX[index],
+                    particles._positionY[index], particles._positionZ[index]);
+                particles._mortonCode[index] = mortonCode;
+                sortKey = MortonCode::ParticleSortKey(particles._sceneId[index], mortonCode);
+                numActive++;
+            }
+            sortItems[index] = (static_cast<unsigned long long>(sortKey) << 32) | index;
+        }
+        return numActive;
+    }
+
+#ifdef CPU_PARTICLE_KERNELS_X86
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Reads the CPU's feature flags, and the OS's, since AVX registers are only usable if
+        the OS saves them on a context switch.
+    Parameters: None
+    Returns:
+        A bit for each SimdLevel that this CPU can run, (1 << level).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    static unsigned int ReadCpuFeatures()
+    {
+        unsigned int leaf1[4] = { 0 };
+        unsigned int leaf7[4] = { 0 };
+        unsigned int maxLeaf = 0;
+#ifdef _MSC_VER
+        int registers[4];
+        __cpuid(registers, 0);
+        maxLeaf = static_cast<unsigned int>(registers[0]);
+        __cpuid(registers, 1);
+        memcpy(leaf1, registers, sizeof(leaf1));
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(registers, 7, 0);
+            memcpy(leaf7, registers, sizeof(leaf7));
+        }
+#else
+        maxLeaf = __get_cpuid_max(0, 0);
+        __get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+        if (maxLeaf >= 7)
+        {
+            __get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+        }
+#endif
+
+        // ECX bit 19
+        bool hasSse41 = (leaf1[2] & (1u << 19)) != 0;
+
+        // ECX bit 27 is OSXSAVE, and then XCR0 bits 1 and 2 say that the OS saves the SSE and
+        // AVX registers
+        bool osSavesAvx = false;
+        if ((leaf1[2] & (1u << 27)) != 0)
+        {
+#ifdef _MSC_VER
+            unsigned long long xcr0 = _xgetbv(0);
+#else
+            unsigned int xcr0Low = 0;
+            unsigned int xcr0High = 0;
+            __asm__ volatile ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            unsigned long long xcr0 = (static_cast<unsigned long long>(xcr0High) << 32) | xcr0Low;
+#endif
+            osSavesAvx = (xcr0 & 0x6) == 0x6;
+        }
+
+        // leaf 7 EBX bit 5
+        bool hasAvx2 = osSavesAvx && ((leaf7[1] & (1u << 5)) != 0);
+
+        unsigned int supportedLevels = (1u << SIMD_LEVEL_SCALAR);
+        if (hasSse41)
+        {
+            supportedLevels |= (1u << SIMD_LEVEL_SSE41);
+        }
+        if (hasSse41 && hasAvx2)
+        {
+            supportedLevels |= (1u << SIMD_LEVEL_AVX2);
+        }
+        return supportedLevels;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        MortonCode::ExpandBits(...) for 4 at a time.  Shifts and ORs instead of multiplies
+        (the input is < 1024, so the shifted copies never overlap and it's the same thing).
+    Parameters:
+        i   Four unsigned integers within the range 0-1023.
+    Returns:
+        Four 30bit versions of the input.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_SSE41 static inline __m128i ExpandBits4(__m128i i)
+    {
+        i = _mm_and_si128(_mm_or_si128(i, _mm_slli_epi32(i, 16)), _mm_set1_epi32(0xFF0000FF));
+        i = _mm_and_si128(_mm_or_si128(i, _mm_slli_epi32(i, 8)), _mm_set1_epi32(0x0F00F00F));
+        i = _mm_and_si128(_mm_or_si128(i, _mm_slli_epi32(i, 4)), _mm_set1_epi32(0xC30C30C3));
+        i = _mm_and_si128(_mm_or_si128(i, _mm_slli_epi32(i, 2)), _mm_set1_epi32(0x49249249));
+        return i;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        ExpandBits4(...), but 8 at a time.
+    Parameters:
+        i   Eight unsigned integers within the range 0-1023.
+    Returns:
+        Eight 30bit versions of the input.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_AVX2 static inline __m256i ExpandBits8(__m256i i)
+    {
+        i = _mm256_and_si256(_mm256_or_si256(i, _mm256_slli_epi32(i, 16)), _mm256_set1_epi32(0xFF0000FF));
+        i = _mm256_and_si256(_mm256_or_si256(i, _mm256_slli_epi32(i, 8)), _mm256_set1_epi32(0x0F00F00F));
+        i = _mm256_and_si256(_mm256_or_si256(i, _mm256_slli_epi32(i, 4)), _mm256_set1_epi32(0xC30C30C3));
+        i = _mm256_and_si256(_mm256_or_si256(i, _mm256_slli_epi32(i, 2)), _mm256_set1_epi32(0x49249249));
+        return i;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        UpdateParticlesScalar(...), 4 particles at a time.  Inactive particles are left alone
+        by blending their old values back in.
+    Parameters:
+        See UpdateParticlesScalar(...).
+    Returns:
+        See UpdateParticlesScalar(...).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_SSE41 static unsigned int UpdateParticlesSse41(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, float deltaTimeSec, std::vector<unsigned int> &freedIndices)
+    {
+        float regionRadius = static_cast<float>(PARTICLE_REGION_RADIUS);
+        __m128 deltaTime = _mm_set1_ps(deltaTimeSec);
+        __m128 regionCenterX = _mm_set1_ps(static_cast<float>(PARTICLE_REGION_CENTER_X));
+        __m128 regionCenterY = _mm_set1_ps(static_cast<float>(PARTICLE_REGION_CENTER_Y));
+        __m128 regionRadiusSqr = _mm_set1_ps(regionRadius * regionRadius);
+        __m128i zero = _mm_setzero_si128();
+
+        unsigned int numActive = 0;
+        unsigned int index = begin;
+        for (; index + 4 <= end; index += 4)
+        {
+            int isActiveBytes = 0;
+            memcpy(&isActiveBytes, particles._isActive + index, 4);
+            __m128i inactiveByteMask = _mm_cmpeq_epi8(_mm_cvtsi32_si128(isActiveBytes), zero);
+            __m128i inactiveMask = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(isActiveBytes)), zero);
+            unsigned int activeBits = ~static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(inactiveMask))) & 0xf;
+            if (activeBits == 0)
+            {
+                continue;
+            }
+            numActive += CountBits(activeBits);
+
+            __m128 x = _mm_loadu_ps(particles._positionX + index);
+            __m128 y = _mm_loadu_ps(particles._positionY + index);
+            __m128 z = _mm_loadu_ps(particles._positionZ + index);
+            __m128 newX = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(particles._velocityX + index), deltaTime));
+            __m128 newY = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(particles._velocityY + index), deltaTime));
+            __m128 newZ = _mm_add_ps(z, _mm_mul_ps(_mm_loadu_ps(particles._velocityZ + index), deltaTime));
+            __m128 keepOld = _mm_castsi128_ps(inactiveMask);
+            _mm_storeu_ps(particles._positionX + index, _mm_blendv_ps(newX, x, keepOld));
+            _mm_storeu_ps(particles._positionY + index, _mm_blendv_ps(newY, y, keepOld));
+            _mm_storeu_ps(particles._positionZ + index, _mm_blendv_ps(newZ, z, keepOld));
+
+            __m128 centerToParticleX = _mm_sub_ps(newX, regionCenterX);
+            __m128 centerToParticleY = _mm_sub_ps(newY, regionCenterY);
+            __m128 distToParticleSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerToParticleX, centerToParticleX),
+                _mm_mul_ps(centerToParticleY, centerToParticleY)), _mm_mul_ps(newZ, newZ));
+            unsigned int leftRegionBits =
+                static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpgt_ps(distToParticleSqr, regionRadiusSqr))) & activeBits;
+
+            // the active ones' flags and counts go to 0
+            __m128i nearbyCounts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(particles._numberOfNearbyParticles + index));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(particles._numberOfNearbyParticles + index),
+                _mm_and_si128(nearbyCounts, inactiveMask));
+            int hasCollidedBytes = 0;
+            memcpy(&hasCollidedBytes, particles._hasCollidedAlreadyThisFrame + index, 4);
+            hasCollidedBytes = _mm_cvtsi128_si32(_mm_and_si128(_mm_cvtsi32_si128(hasCollidedBytes), inactiveByteMask));
+            memcpy(particles._hasCollidedAlreadyThisFrame + index, &hasCollidedBytes, 4);
+
+            while (leftRegionBits != 0)
+            {
+                unsigned int lane = 0;
+                while ((leftRegionBits & (1u << lane)) == 0)
+                {
+                    lane++;
+                }
+                particles._isActive[index + lane] = 0;
+                freedIndices.push_back(index + lane);
+                leftRegionBits &= leftRegionBits - 1;
+            }
+        }
+
+        return numActive + UpdateParticlesScalar(particles, index, end, deltaTimeSec, freedIndices);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        UpdateParticlesSse41(...), but 8 particles at a time.
+    Parameters:
+        See UpdateParticlesScalar(...).
+    Returns:
+        See UpdateParticlesScalar(...).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_AVX2 static unsigned int UpdateParticlesAvx2(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, float deltaTimeSec, std::vector<unsigned int> &freedIndices)
+    {
+        float regionRadius = static_cast<float>(PARTICLE_REGION_RADIUS);
+        __m256 deltaTime = _mm256_set1_ps(deltaTimeSec);
+        __m256 regionCenterX = _mm256_set1_ps(static_cast<float>(PARTICLE_REGION_CENTER_X));
+        __m256 regionCenterY = _mm256_set1_ps(static_cast<float>(PARTICLE_REGION_CENTER_Y));
+        __m256 regionRadiusSqr = _mm256_set1_ps(regionRadius * regionRadius);
+
+        unsigned int numActive = 0;
+        unsigned int index = begin;
+        for (; index + 8 <= end; index += 8)
+        {
+            __m128i isActiveBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(particles._isActive + index));
+            __m128i inactiveByteMask = _mm_cmpeq_epi8(isActiveBytes, _mm_setzero_si128());
+            __m256i inactiveMask = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(isActiveBytes), _mm256_setzero_si256());
+            unsigned int activeBits = ~static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(inactiveMask))) & 0xff;
+            if (activeBits == 0)
+            {
+                continue;
+            }
+            numActive += CountBits(activeBits);
+
+            __m256 x = _mm256_loadu_ps(particles._positionX + index);
+            __m256 y = _mm256_loadu_ps(particles._positionY + index);
+            __m256 z = _mm256_loadu_ps(particles._positionZ + index);
+            __m256 newX = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(particles._velocityX + index), deltaTime));
+            __m256 newY = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(particles._velocityY + index), deltaTime));
+            __m256 newZ = _mm256_add_ps(z, _mm256_mul_ps(_mm256_loadu_ps(particles._velocityZ + index), deltaTime));
+            __m256 keepOld = _mm256_castsi256_ps(inactiveMask);
+            _mm256_storeu_ps(particles._positionX + index, _mm256_blendv_ps(newX, x, keepOld));
+            _mm256_storeu_ps(particles._positionY + index, _mm256_blendv_ps(newY, y, keepOld));
+            _mm256_storeu_ps(particles._positionZ + index, _mm256_blendv_ps(newZ, z, keepOld));
+
+            __m256 centerToParticleX = _mm256_sub_ps(newX, regionCenterX);
+            __m256 centerToParticleY = _mm256_sub_ps(newY, regionCenterY);
+            __m256 distToParticleSqr = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(centerToParticleX, centerToParticleX),
+                _mm256_mul_ps(centerToParticleY, centerToParticleY)), _mm256_mul_ps(newZ, newZ));
+            unsigned int leftRegionBits = static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(distToParticleSqr, regionRadiusSqr, _CMP_GT_OQ))) & activeBits;
+
+            // the active ones' flags and counts go to 0
+            __m256i nearbyCounts = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(particles._numberOfNearbyParticles + index));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(particles._numberOfNearbyParticles + index),
+                _mm256_and_si256(nearbyCounts, inactiveMask));
+            __m128i hasCollidedBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(particles._hasCollidedAlreadyThisFrame + index));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(particles._hasCollidedAlreadyThisFrame + index),
+                _mm_and_si128(hasCollidedBytes, inactiveByteMask));
+
+            while (leftRegionBits != 0)
+            {
+                unsigned int lane = 0;
+                while ((leftRegionBits & (1u << lane)) == 0)
+                {
+                    lane++;
+                }
+                particles._isActive[index + lane] = 0;
+                freedIndices.push_back(index + lane);
+                leftRegionBits &= leftRegionBits - 1;
+            }
+        }
+
+        // avoid the penalty for mixing AVX with the SSE code that the compiler makes elsewhere
+        _mm256_zeroupper();
+        return numActive + UpdateParticlesScalar(particles, index, end, deltaTimeSec, freedIndices);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        MakeSortItemsScalar(...), 4 particles at a time.  Follows MortonCode.h step by step.
+    Parameters:
+        See MakeSortItemsScalar(...).
+    Returns:
+        See MakeSortItemsScalar(...).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_SSE41 static unsigned int MakeSortItemsSse41(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, unsigned long long *sortItems)
+    {
+        __m128 inverseParticleRange = _mm_set1_ps(1.0f / (2.0f * static_cast<float>(PARTICLE_REGION_RADIUS)));
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 half = _mm_set1_ps(0.5f);
+        __m128 gridSize = _mm_set1_ps(1024.0f);
+        __m128 maxGridCoordinate = _mm_set1_ps(1023.0f);
+        __m128 zeroF = _mm_setzero_ps();
+        __m128i zero = _mm_setzero_si128();
+        __m128i inactiveKey = _mm_set1_epi32(static_cast<int>(MortonCode::INACTIVE_PARTICLE_SORT_KEY));
+        __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+        unsigned int numActive = 0;
+        unsigned int index = begin;
+        for (; index + 4 <= end; index += 4)
+        {
+            int isActiveBytes = 0;
+            memcpy(&isActiveBytes, particles._isActive + index, 4);
+            __m128i inactiveMask = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(isActiveBytes)), zero);
+            unsigned int activeBits = ~static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(inactiveMask))) & 0xf;
+            numActive += CountBits(activeBits);
+
+            // [-radius,+radius] -> [0,1] -> [0,1023]
+            __m128 x = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(particles._positionX + index), inverseParticleRange), one), half);
+            __m128 y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(particles._positionY + index), inverseParticleRange), one), half);
+            __m128 z = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(particles._positionZ + index), inverseParticleRange), one), half);
+            __m128i gridX = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(x, gridSize), zeroF), maxGridCoordinate));
+            __m128i gridY = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(y, gridSize), zeroF), maxGridCoordinate));
+            __m128i gridZ = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(z, gridSize), zeroF), maxGridCoordinate));
+            __m128i mortonCode = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(ExpandBits4(gridX), 2),
+                _mm_slli_epi32(ExpandBits4(gridY), 1)), ExpandBits4(gridZ));
+
+            // only the active ones record their Morton Codes
+            __m128i oldMortonCode = _mm_loadu_si128(reinterpret_cast<const __m128i *>(particles._mortonCode + index));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(particles._mortonCode + index),
+                _mm_blendv_epi8(mortonCode, oldMortonCode, inactiveMask));
+
+            int sceneIdBytes = 0;
+            memcpy(&sceneIdBytes, particles._sceneId + index, 4);
+            __m128i sceneId = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(sceneIdBytes));
+            __m128i sortKey = _mm_or_si128(_mm_slli_epi32(sceneId, PARTICLE_SORT_KEY_SCENE_ID_SHIFT),
+                _mm_srli_epi32(mortonCode, PARTICLE_SORT_KEY_MORTON_CODE_SHIFT));
+            sortKey = _mm_blendv_epi8(sortKey, inactiveKey, inactiveMask);
+
+            // the index in the bottom 32 bits, the key in the top
+            __m128i indices = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(index)), laneOffsets);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sortItems + index), _mm_unpacklo_epi32(indices, sortKey));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sortItems + index + 2), _mm_unpackhi_epi32(indices, sortKey));
+        }
+
+        return numActive + MakeSortItemsScalar(particles, index, end, sortItems);
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        MakeSortItemsSse41(...), but 8 particles at a time.
+    Parameters:
+        See MakeSortItemsScalar(...).
+    Returns:
+        See MakeSortItemsScalar(...).
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    TARGET_AVX2 static unsigned int MakeSortItemsAvx2(const ParticleFields &particles, unsigned int begin,
+        unsigned int end, unsigned long long *sortItems)
+    {
+        __m256 inverseParticleRange = _mm256_set1_ps(1.0f / (2.0f * static_cast<float>(PARTICLE_REGION_RADIUS)));
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 half = _mm256_set1_ps(0.5f);
+        __m256 gridSize = _mm256_set1_ps(1024.0f);
+        __m256 maxGridCoordinate = _mm256_set1_ps(1023.0f);
+        __m256 zeroF = _mm256_setzero_ps();
+        __m256i inactiveKey = _mm256_set1_epi32(static_cast<int>(MortonCode::INACTIVE_PARTICLE_SORT_KEY));
+        __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        unsigned int numActive = 0;
+        unsigned int index = begin;
+        for (; index + 8 <= end; index += 8)
+        {
+            __m128i isActiveBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(particles._isActive + index));
+            __m256i inactiveMask = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(isActiveBytes), _mm256_setzero_si256());
+            unsigned int activeBits = ~static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(inactiveMask))) & 0xff;
+            numActive += CountBits(activeBits);
+
+            // [-radius,+radius] -> [0,1] -> [0,1023]
+            __m256 x = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(particles._positionX + index), inverseParticleRange), one), half);
+            __m256 y = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(particles._positionY + index), inverseParticleRange), one), half);
+            __m256 z = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(particles._positionZ + index), inverseParticleRange), one), half);
+            __m256i gridX = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(x, gridSize), zeroF), maxGridCoordinate));
+            __m256i gridY = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(y, gridSize), zeroF), maxGridCoordinate));
+            __m256i gridZ = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(z, gridSize), zeroF), maxGridCoordinate));
+            __m256i mortonCode = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(ExpandBits8(gridX), 2),
+                _mm256_slli_epi32(ExpandBits8(gridY), 1)), ExpandBits8(gridZ));
+
+            // only the active ones record their Morton Codes
+            __m256i oldMortonCode = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(particles._mortonCode + index));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(particles._mortonCode + index),
+                _mm256_blendv_epi8(mortonCode, oldMortonCode, inactiveMask));
+
+            __m128i sceneIdBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(particles._sceneId + index));
+            __m256i sceneId = _mm256_cvtepu8_epi32(sceneIdBytes);
+            __m256i sortKey = _mm256_or_si256(_mm256_slli_epi32(sceneId, PARTICLE_SORT_KEY_SCENE_ID_SHIFT),
+                _mm256_srli_epi32(mortonCode, PARTICLE_SORT_KEY_MORTON_CODE_SHIFT));
+            sortKey = _mm256_blendv_epi8(sortKey, inactiveKey, inactiveMask);
+
+            // the index in the bottom 32 bits, the key in the top
+            // Note: The unpacks work within each 128bit half, so they give items 0,1,4,5 and
+            // 2,3,6,7, and then the permutes put them back in order.
+            __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(index)), laneOffsets);
+            __m256i items0145 = _mm256_unpacklo_epi32(indices, sortKey);
+            __m256i items2367 = _mm256_unpackhi_epi32(indices, sortKey);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(sortItems + index),
+                _mm256_permute2x128_si256(items0145, items2367, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(sortItems + index + 4),
+                _mm256_permute2x128_si256(items0145, items2367, 0x31));
+        }
+
+        _mm256_zeroupper();
+        return numActive + MakeSortItemsScalar(particles, index, end, sortItems);
+    }
+#endif
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        For printing.
+    Parameters:
+        level   Self-explanatory.
+    Returns:
+        "scalar", "sse4.1", or "avx2".
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    const char *SimdLevelName(SimdLevel level)
+    {
+        if (level < 0 || level >= NUM_SIMD_LEVELS)
+        {
+            return "unknown";
+        }
+        return SIMD_LEVEL_NAMES[level];
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The reverse of SimdLevelName(...), for the command line.
+    Parameters:
+        name    "scalar", "sse4.1", or "avx2".
+        level   Receives the level if the name is one of those.
+    Returns:
+        False if the name isn't one of those, otherwise true.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool SimdLevelFromName(const std::string &name, SimdLevel &level)
+    {
+        for (int levelIndex = 0; levelIndex < NUM_SIMD_LEVELS; levelIndex++)
+        {
+            if (name == SIMD_LEVEL_NAMES[levelIndex])
+            {
+                level = static_cast<SimdLevel>(levelIndex);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Asks the CPU (once) what it can do.
+    Parameters:
+        level   Self-explanatory.
+    Returns:
+        True if this CPU (and OS) can run that level's kernels.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    bool IsSimdLevelSupported(SimdLevel level)
+    {
+#ifdef CPU_PARTICLE_KERNELS_X86
+        // Note: Static initialization is thread safe, so any thread can be the first to ask.
+        static const unsigned int supportedLevels = ReadCpuFeatures();
+        if (level < 0 || level >= NUM_SIMD_LEVELS)
+        {
+            return false;
+        }
+        return (supportedLevels & (1u << level)) != 0;
+#else
+        return (level == SIMD_LEVEL_SCALAR);
+#endif
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        The widest level that this CPU can run.
+    Parameters: None
+    Returns:
+        See description.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    SimdLevel BestSimdLevel()
+    {
+        for (int levelIndex = NUM_SIMD_LEVELS - 1; levelIndex > SIMD_LEVEL_SCALAR; levelIndex--)
+        {
+            if (IsSimdLevelSupported(static_cast<SimdLevel>(levelIndex)))
+            {
+                return static_cast<SimdLevel>(levelIndex);
+            }
+        }
+        return SIMD_LEVEL_SCALAR;
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Does ParticleUpdate.comp's work on the particles in [begin, end): moves the active ones
+        and turns off the ones that left the particle region.
+    Parameters:
+        level           Which version to run.  Must be supported (see IsSimdLevelSupported(...)).
+        particles       Self-explanatory.
+        begin           The first particle.
+        end             One past the last particle.
+        deltaTimeSec    Self-explanatory.
+        freedIndices    The particles that left the region are added to this, in order.
+    Returns:
+        The number of particles that were active before moving.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int UpdateParticles(SimdLevel level, const ParticleFields &particles, unsigned int begin,
+        unsigned int end, float deltaTimeSec, std::vector<unsigned int> &freedIndices)
+    {
+        switch (level)
+        {
+#ifdef CPU_PARTICLE_KERNELS_X86
+        case SIMD_LEVEL_AVX2:
+            return UpdateParticlesAvx2(particles, begin, end, deltaTimeSec, freedIndices);
+        case SIMD_LEVEL_SSE41:
+            return UpdateParticlesSse41(particles, begin, end, deltaTimeSec, freedIndices);
+#endif
+        default:
+            return UpdateParticlesScalar(particles, begin, end, deltaTimeSec, freedIndices);
+        }
+    }
+
+    /*--------------------------------------------------------------------------------------------
+    Description:
+        Makes the sort item ((key << 32) | index, see CpuRadixSort) for each particle in
+        [begin, end), and records the active ones' Morton Codes, like
+        ParticleDataToIntermediateData.comp.
+    Parameters:
+        level       Which version to run.  Must be supported (see IsSimdLevelSupported(...)).
+        particles   Self-explanatory.
+        begin       The first particle.
+        end         One past the last particle.
+        sortItems   Entries [begin, end) are written.
+    Returns:
+        The number of active particles.
+    Creator:    agent, 10/2026
+    --------------------------------------------------------------------------------------------*/
+    unsigned int MakeSortItems(SimdLevel level, const ParticleFields &particles, unsigned int begin,
+        unsigned int end, unsigned long long *sortItems)
+    {
+        switch (level)
+        {
+#ifdef CPU_PARTICLE_KERNELS_X86
+        case SIMD_LEVEL_AVX2:
+            return MakeSortItemsAvx2(particles, begin, end, sortItems);
+        case SIMD_LEVEL_SSE41:
+            return MakeSortItemsSse41(particles, begin, end, sortItems);
+#endif
+        default:
+            return MakeSortItemsScalar(particles, begin, end, sortItems);
+        }
+    }
+}
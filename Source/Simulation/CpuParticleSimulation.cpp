@@ -0,0 +1,933 @@
+#include "Include/Simulation/CpuParticleSimulation.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Include/Particles/CounterBasedRandom.h"
+#include "Include/Particles/MortonCode.h"
+#include "Include/ShaderControllers/ParticleReset.h"
+#include "Shaders/ParticleReset/ParticleEmitterTypes.comp"
+#include "Shaders/ParticleScenes.comp"
+#include "Shaders/CountNearbyParticlesLimits.comp"
+#include "ThirdParty/glm/vec4.hpp"
+#include "ThirdParty/glm/common.hpp"
+#include "ThirdParty/glm/geometric.hpp"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The CPU version of QuickNormalize.comp.
+Parameters:
+    v   The vec4 to be normalized.
+Returns:
+    A normalized copy of input v.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+static glm::vec4 QuickNormalize(const glm::vec4 &v)
+{
+    return (1.0f / sqrtf(glm::dot(v, v))) * v;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Sizes every array.  Particles that are added start out the same as the Particle
+    constructor (and ParticleBufferInit.comp) makes them: inactive and out of the depth range.
+    Particles that were already there keep their values.
+Parameters:
+    numParticles    Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::ParticleArrays::Resize(unsigned int numParticles)
+{
+    Particle defaultParticle;
+    _positionX.resize(numParticles, 0.0f);
+    _positionY.resize(numParticles, 0.0f);
+    _positionZ.resize(numParticles, +0.1f);
+    _velocityX.resize(numParticles, 0.0f);
+    _velocityY.resize(numParticles, 0.0f);
+    _velocityZ.resize(numParticles, 0.0f);
+    _numberOfNearbyParticles.resize(numParticles, defaultParticle._numberOfNearbyParticles);
+    _mass.resize(numParticles, defaultParticle._mass);
+    _collisionRadius.resize(numParticles, defaultParticle._collisionRadius);
+    _mortonCode.resize(numParticles, defaultParticle._mortonCode);
+    _hasCollidedAlreadyThisFrame.resize(numParticles, 0);
+    _isActive.resize(numParticles, 0);
+    _sceneId.resize(numParticles, 0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Copies every field of one particle to a slot in another set of arrays.  The sort's gather
+    step.
+Parameters:
+    fromIndex   Index into these arrays.
+    to          Self-explanatory.  Can't be these arrays.
+    toIndex     Index into "to".
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::ParticleArrays::CopyParticle(unsigned int fromIndex, ParticleArrays &to,
+    unsigned int toIndex) const
+{
+    to._positionX[toIndex] = _positionX[fromIndex];
+    to._positionY[toIndex] = _positionY[fromIndex];
+    to._positionZ[toIndex] = _positionZ[fromIndex];
+    to._velocityX[toIndex] = _velocityX[fromIndex];
+    to._velocityY[toIndex] = _velocityY[fromIndex];
+    to._velocityZ[toIndex] = _velocityZ[fromIndex];
+    to._numberOfNearbyParticles[toIndex] = _numberOfNearbyParticles[fromIndex];
+    to._mass[toIndex] = _mass[fromIndex];
+    to._collisionRadius[toIndex] = _collisionRadius[fromIndex];
+    to._mortonCode[toIndex] = _mortonCode[fromIndex];
+    to._hasCollidedAlreadyThisFrame[toIndex] = _hasCollidedAlreadyThisFrame[fromIndex];
+    to._isActive[toIndex] = _isActive[fromIndex];
+    to._sceneId[toIndex] = _sceneId[fromIndex];
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Adds up the size of every array.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+size_t CpuParticleSimulation::ParticleArrays::NumBytes() const
+{
+    size_t numParticles = _positionX.size();
+    return numParticles * ((sizeof(float) * 8) + (sizeof(unsigned int) * 2) + (sizeof(unsigned char) * 3));
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Points at every array that CpuParticleKernels uses.  The pointers are only good until the
+    next Resize(...).
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+CpuParticleKernels::ParticleFields CpuParticleSimulation::ParticleArrays::Fields()
+{
+    CpuParticleKernels::ParticleFields fields;
+    fields._positionX = _positionX.data();
+    fields._positionY = _positionY.data();
+    fields._positionZ = _positionZ.data();
+    fields._velocityX = _velocityX.data();
+    fields._velocityY = _velocityY.data();
+    fields._velocityZ = _velocityZ.data();
+    fields._numberOfNearbyParticles = _numberOfNearbyParticles.data();
+    fields._mortonCode = _mortonCode.data();
+    fields._hasCollidedAlreadyThisFrame = _hasCollidedAlreadyThisFrame.data();
+    fields._isActive = _isActive.data();
+    fields._sceneId = _sceneId.data();
+    return fields;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values, starts the threads, and makes every particle inactive and
+    free, like ParticleSsbo does on the GPU.
+Parameters:
+    numParticles    The starting number of particles.
+    numThreads      How many threads run each stage.  0 means one per hardware thread.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+CpuParticleSimulation::CpuParticleSimulation(unsigned int numParticles, unsigned int numThreads) :
+    _threadPool(numThreads),
+    _simdLevel(CpuParticleKernels::BestSimdLevel()),
+    _numParticles(0),
+    _numActiveParticles(0),
+    _radixSort(_threadPool),
+    _randomSeed(ShaderControllers::ParticleReset::DEFAULT_RANDOM_SEED),
+    _frameNumber(0),
+    _renderSsbo(nullptr)
+{
+    _emitterDescriptors.reserve(ShaderControllers::ParticleReset::MAX_EMITTERS);
+    Resize(numParticles);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: None
+Returns:
+    "CPU"
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+const char *CpuParticleSimulation::BackendName() const
+{
+    return "CPU";
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of threads that run each stage.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int CpuParticleSimulation::NumThreads() const
+{
+    return _threadPool.NumThreads();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Picks which versions of the update and sort key loops run.  The default is the widest
+    that the CPU has.  Every version gives the same results, so this is only for comparing
+    their speed.
+Parameters:
+    level   Self-explanatory.
+Returns:
+    False if the CPU can't run that level (nothing changes), otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool CpuParticleSimulation::SetSimdLevel(CpuParticleKernels::SimdLevel level)
+{
+    if (!CpuParticleKernels::IsSimdLevelSupported(level))
+    {
+        fprintf(stderr, "CpuParticleSimulation: this CPU can't run the '%s' kernels\n",
+            CpuParticleKernels::SimdLevelName(level));
+        return false;
+    }
+    _simdLevel = level;
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for what SetSimdLevel(...) set.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+CpuParticleKernels::SimdLevel CpuParticleSimulation::GetSimdLevel() const
+{
+    return _simdLevel;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::AddEmitter(...).
+Parameters:
+    pointEmitter    Self-explanatory.
+    sceneId         The scene that the emitter's particles belong to.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId)
+{
+    if (sceneId >= MAX_PARTICLE_SCENES)
+    {
+        fprintf(stderr, "CpuParticleSimulation::AddEmitter(...): scene ID %u is out of range (max %u scenes); emitter ignored\n",
+            sceneId, MAX_PARTICLE_SCENES);
+        return;
+    }
+    if (_pointEmitters.size() + _barEmitters.size() >= ShaderControllers::ParticleReset::MAX_EMITTERS)
+    {
+        fprintf(stderr, "CpuParticleSimulation::AddEmitter(...): already have the max of %u emitters; emitter ignored\n",
+            ShaderControllers::ParticleReset::MAX_EMITTERS);
+        return;
+    }
+
+    _pointEmitters.push_back(pointEmitter);
+    _pointEmitterSceneIds.push_back(sceneId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::AddEmitter(...).
+Parameters:
+    barEmitter  Self-explanatory.
+    sceneId     The scene that the emitter's particles belong to.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId)
+{
+    if (sceneId >= MAX_PARTICLE_SCENES)
+    {
+        fprintf(stderr, "CpuParticleSimulation::AddEmitter(...): scene ID %u is out of range (max %u scenes); emitter ignored\n",
+            sceneId, MAX_PARTICLE_SCENES);
+        return;
+    }
+    if (_pointEmitters.size() + _barEmitters.size() >= ShaderControllers::ParticleReset::MAX_EMITTERS)
+    {
+        fprintf(stderr, "CpuParticleSimulation::AddEmitter(...): already have the max of %u emitters; emitter ignored\n",
+            ShaderControllers::ParticleReset::MAX_EMITTERS);
+        return;
+    }
+
+    _barEmitters.push_back(barEmitter);
+    _barEmitterSceneIds.push_back(sceneId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::SetRandomSeed(...).
+Parameters:
+    seed    Any value.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::SetRandomSeed(unsigned int seed)
+{
+    _randomSeed = seed;
+    _frameNumber = 0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Does what ParticleReset::ResetParticles(...) and ParticleReset.comp do together.  The
+    emitters are described the same way, then each emission takes an index off of the free
+    list (in emitter order, one thread, because popping is cheap and the order should be the
+    same every time), and then the threads give the claimed particles their new positions and
+    velocities.
+Parameters:
+    particlesPerEmitterPerFrame     Limits the number of particles that are reset per frame
+                                    so that they don't all spawn at once.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::ResetParticles(unsigned int particlesPerEmitterPerFrame)
+{
+    if (_pointEmitters.empty() && _barEmitters.empty())
+    {
+        return;
+    }
+
+    // same frame count as ParticleReset so that the random numbers match
+    unsigned int frameNumber = _frameNumber++;
+
+    _emitterDescriptors.clear();
+    for (size_t pointEmitterCount = 0; pointEmitterCount < _pointEmitters.size(); pointEmitterCount++)
+    {
+        const ParticleEmitterPoint::CONST_SHARED_PTR &emitter = _pointEmitters[pointEmitterCount];
+        ParticleEmitterDescriptor descriptor;
+        descriptor._p1 = emitter->GetPos();
+        descriptor._minVelocity = emitter->GetMinVelocity();
+        descriptor._maxVelocity = emitter->GetMaxVelocity();
+        descriptor._emitterType = PARTICLE_EMITTER_TYPE_POINT;
+        descriptor._maxParticleEmitCount = particlesPerEmitterPerFrame;
+        descriptor._sceneId = _pointEmitterSceneIds[pointEmitterCount];
+        _emitterDescriptors.push_back(descriptor);
+    }
+    for (size_t barEmitterCount = 0; barEmitterCount < _barEmitters.size(); barEmitterCount++)
+    {
+        const ParticleEmitterBar::CONST_SHARED_PTR &emitter = _barEmitters[barEmitterCount];
+        ParticleEmitterDescriptor descriptor;
+        descriptor._p1 = emitter->GetBarStart();
+        descriptor._p2 = emitter->GetBarEnd();
+        descriptor._emitDir = emitter->GetEmitDir();
+        descriptor._minVelocity = emitter->GetMinVelocity();
+        descriptor._maxVelocity = emitter->GetMaxVelocity();
+        descriptor._emitterType = PARTICLE_EMITTER_TYPE_BAR;
+        descriptor._maxParticleEmitCount = particlesPerEmitterPerFrame;
+        descriptor._sceneId = _barEmitterSceneIds[barEmitterCount];
+        _emitterDescriptors.push_back(descriptor);
+    }
+
+    // AddEmitter(...) refuses any past ParticleReset::MAX_EMITTERS, like the GPU's
+    unsigned int numEmitters = static_cast<unsigned int>(_emitterDescriptors.size());
+
+    _particleClaims.clear();
+    for (unsigned int emitterIndex = 0; emitterIndex < numEmitters && !_freeParticleIndices.empty(); emitterIndex++)
+    {
+        unsigned int maxEmissions = _emitterDescriptors[emitterIndex]._maxParticleEmitCount;
+        for (unsigned int emissionIndex = 0; emissionIndex < maxEmissions && !_freeParticleIndices.empty(); emissionIndex++)
+        {
+            ParticleClaim claim;
+            claim._emitterIndex = emitterIndex;
+            claim._emissionIndex = emissionIndex;
+            claim._particleIndex = _freeParticleIndices.back();
+            _freeParticleIndices.pop_back();
+            _particleClaims.push_back(claim);
+        }
+    }
+
+    unsigned int numClaims = static_cast<unsigned int>(_particleClaims.size());
+    _threadPool.ParallelFor(numClaims, MIN_PARTICLES_PER_CHUNK,
+        [this, frameNumber](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int claimIndex = begin; claimIndex < end; claimIndex++)
+        {
+            const ParticleClaim &claim = _particleClaims[claimIndex];
+            const ParticleEmitterDescriptor &emitter = _emitterDescriptors[claim._emitterIndex];
+            glm::vec4 random0 = CounterBasedRandom::RandomVec4On0To1(_randomSeed, frameNumber,
+                claim._emitterIndex, claim._emissionIndex, 0);
+            glm::vec4 random1 = CounterBasedRandom::RandomVec4On0To1(_randomSeed, frameNumber,
+                claim._emitterIndex, claim._emissionIndex, 1);
+
+            glm::vec4 position;
+            glm::vec4 velocity;
+            if (emitter._emitterType == PARTICLE_EMITTER_TYPE_POINT)
+            {
+                // see ParticleResetPointEmitter.comp
+                float newPosX = (random0.x * 2.0f) - 1.0f;
+                float newPosY = (random0.y * 2.0f) - 1.0f;
+                glm::vec4 cloudRingLimit = (0.1f * QuickNormalize(glm::vec4(newPosX, newPosY, 0.0f, 0.0f)));
+                position = glm::mix(emitter._p1, emitter._p1 + cloudRingLimit, random0.z);
+
+                float newVelX = (random0.w * 2.0f) - 1.0f;
+                float newVelY = (random1.x * 2.0f) - 1.0f;
+                glm::vec4 randomVelocityVector = QuickNormalize(glm::vec4(newVelX, newVelY, 0.0f, 0.0f));
+                velocity = glm::mix(emitter._minVelocity * randomVelocityVector,
+                    emitter._maxVelocity * randomVelocityVector, random1.y);
+            }
+            else
+            {
+                // see ParticleResetBarEmitter.comp
+                position = glm::mix(emitter._p1, emitter._p2, random0.x);
+                glm::vec4 velocityDir = QuickNormalize(emitter._emitDir);
+                velocity = glm::mix(emitter._minVelocity * velocityDir,
+                    emitter._maxVelocity * velocityDir, random0.y);
+            }
+
+            unsigned int particleIndex = claim._particleIndex;
+            _particles._positionX[particleIndex] = position.x;
+            _particles._positionY[particleIndex] = position.y;
+            _particles._positionZ[particleIndex] = position.z;
+            _particles._velocityX[particleIndex] = velocity.x;
+            _particles._velocityY[particleIndex] = velocity.y;
+            _particles._velocityZ[particleIndex] = velocity.z;
+            _particles._isActive[particleIndex] = 1;
+            _particles._sceneId[particleIndex] = static_cast<unsigned char>(emitter._sceneId);
+        }
+    });
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Does what ParticleUpdate.comp does: moves the active particles, turns off the ones that
+    left the particle region, and clears the collision flag and the nearby count.
+
+    Each chunk is one call to CpuParticleKernels::UpdateParticles(...).  The particles that
+    were turned off go on the free list, and the active particles are counted, per chunk, and
+    then the chunks are combined in order.
+Parameters:
+    deltaTimeSec    Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::Update(float deltaTimeSec)
+{
+    unsigned int numChunks = _threadPool.NumChunks(_numParticles, MIN_PARTICLES_PER_CHUNK);
+    _chunkCounts.assign(numChunks, 0);
+    if (_chunkIndices.size() < numChunks)
+    {
+        _chunkIndices.resize(numChunks);
+    }
+
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this, deltaTimeSec](unsigned int chunkIndex, unsigned int begin, unsigned int end)
+    {
+        std::vector<unsigned int> &freedIndices = _chunkIndices[chunkIndex];
+        freedIndices.clear();
+        _chunkCounts[chunkIndex] = CpuParticleKernels::UpdateParticles(_simdLevel, _particles.Fields(), 
+            begin, end, deltaTimeSec, freedIndices);
+    });
+
+    _numActiveParticles = 0;
+    for (unsigned int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+    {
+        _numActiveParticles += _chunkCounts[chunkIndex];
+        const std::vector<unsigned int> &freedIndices = _chunkIndices[chunkIndex];
+        _freeParticleIndices.insert(_freeParticleIndices.end(), freedIndices.begin(), freedIndices.end());
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Does what ParallelSort does, in three steps:
+    (1) The threads make every particle's sort key, exactly like
+    ParticleDataToIntermediateData.comp (the active particles' Morton Codes are recorded too,
+    see CpuParticleKernels::MakeSortItems(...)).
+    (2) The keys are radix sorted (see CpuRadixSort).
+    (3) The threads copy the particles into their sorted places in the other set of arrays,
+    which then becomes the current one.
+
+    Then the free list is rebuilt.  The inactive particles all sorted to the back, so it is
+    just the indices from the number of active particles to the end.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::Sort()
+{
+    unsigned int numChunks = _threadPool.NumChunks(_numParticles, MIN_PARTICLES_PER_CHUNK);
+    _chunkCounts.assign(numChunks, 0);
+    _sortItems.resize(_numParticles);
+
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this](unsigned int chunkIndex, unsigned int begin, unsigned int end)
+    {
+        _chunkCounts[chunkIndex] = CpuParticleKernels::MakeSortItems(_simdLevel, _particles.Fields(), 
+            begin, end, _sortItems.data());
+    });
+
+    _radixSort.Sort(_sortItems);
+
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int destinationIndex = begin; destinationIndex < end; destinationIndex++)
+        {
+            unsigned int sourceIndex = static_cast<unsigned int>(_sortItems[destinationIndex] & 0xffffffff);
+            _particles.CopyParticle(sourceIndex, _sortedParticles, destinationIndex);
+        }
+    });
+    std::swap(_particles, _sortedParticles);
+
+    unsigned int numActive = 0;
+    for (unsigned int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+    {
+        numActive += _chunkCounts[chunkIndex];
+    }
+    // lowest index on top, like SortParticleData.comp
+    _freeParticleIndices.clear();
+    for (unsigned int index = _numParticles; index > numActive; index--)
+    {
+        _freeParticleIndices.push_back(index - 1);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Does what ParticleCollide does: collides particle pairs (0,1), (2,3), ..., and then
+    (1,2), (3,4), ....  The pairs in one pass don't share particles, so the threads can take
+    them in any order.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::DetectAndResolveCollisions()
+{
+    CollideParticlePairs(0);
+    CollideParticlePairs(1);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Does what CountNearbyParticles.comp does: counts the particles within
+    NUM_PARTICLES_TO_CHECK_ON_EACH_SIDE indices that are active, in the same scene, and
+    between the Morton Codes of the corners of the particle's "nearby" box.
+
+    Note: The loop limits are computed with unsigned ints exactly as the shader does, which
+    means that the first NUM_PARTICLES_TO_CHECK_ON_EACH_SIDE particles always count 0 (the
+    subtraction wraps around, so the loop starts after it ends).  Kept that way so that the two
+    backends agree.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::CountNearbyParticles()
+{
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        const unsigned int numToCheckOnEachSide = NUM_PARTICLES_TO_CHECK_ON_EACH_SIDE;
+        for (unsigned int index = begin; index < end; index++)
+        {
+            float x = _particles._positionX[index];
+            float y = _particles._positionY[index];
+            float z = _particles._positionZ[index];
+            unsigned int sceneId = _particles._sceneId[index];
+            float nearbyRadius = _particles._collisionRadius[index] * 1.0f;
+            unsigned int upperBoundMortonCode = MortonCode::PositionToMortonCode(x + nearbyRadius, y + nearbyRadius, z);
+            unsigned int lowerBoundMortonCode = MortonCode::PositionToMortonCode(x - nearbyRadius, y - nearbyRadius, z);
+
+            unsigned int maxOffsetIndex = (index + numToCheckOnEachSide < _numParticles) ?
+                numToCheckOnEachSide : (_numParticles - index);
+            unsigned int minOffsetIndex = (index - numToCheckOnEachSide > 0) ?
+                numToCheckOnEachSide : index;
+            unsigned int otherBegin = index - minOffsetIndex;
+            unsigned int otherEnd = index + maxOffsetIndex;
+            unsigned int nearbyParticles = 0;
+            for (unsigned int otherIndex = otherBegin; otherIndex < otherEnd; otherIndex++)
+            {
+                unsigned int otherMortonCode = _particles._mortonCode[otherIndex];
+                if (_particles._isActive[otherIndex] == 1 &&
+                    _particles._sceneId[otherIndex] == sceneId &&
+                    otherMortonCode < upperBoundMortonCode &&
+                    otherMortonCode > lowerBoundMortonCode)
+                {
+                    nearbyParticles++;
+                }
+            }
+            _particles._numberOfNearbyParticles[index] = nearbyParticles;
+        }
+    });
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Every stage is done by the time that it returns, so there is nothing to wait for.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::Finish()
+{
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The number of particles that were active at the start of the last Update(...), same as
+    ParticleUpdate::NumActiveParticles().
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int CpuParticleSimulation::NumActiveParticles() const
+{
+    return _numActiveParticles;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles, active or not.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int CpuParticleSimulation::NumParticles() const
+{
+    return _numParticles;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes room for more particles, like ParticleSsbo::Resize(...): the existing particles keep
+    their indices and the new ones start inactive and go on the free list.  The sort's arrays
+    grow the next time that it runs.
+Parameters:
+    numParticles    Must be more than NumParticles().
+Returns:
+    False if it isn't, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool CpuParticleSimulation::Resize(unsigned int numParticles)
+{
+    if (numParticles <= _numParticles)
+    {
+        fprintf(stderr, "CpuParticleSimulation can only grow, not go from %u to %u particles\n",
+            _numParticles, numParticles);
+        return false;
+    }
+
+    unsigned int oldNumParticles = _numParticles;
+    _particles.Resize(numParticles);
+    _sortedParticles.Resize(numParticles);
+    // lowest new index on top, like ParticleBufferInit.comp
+    _freeParticleIndices.reserve(numParticles);
+    for (unsigned int index = numParticles; index > oldNumParticles; index--)
+    {
+        _freeParticleIndices.push_back(index - 1);
+    }
+    _numParticles = numParticles;
+
+    if (_renderSsbo != nullptr)
+    {
+        _renderSsbo->Resize(numParticles);
+    }
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Puts the arrays back together into Particle structures.
+Parameters:
+    particles   Resized to NumParticles() and filled in.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::ReadParticles(std::vector<Particle> &particles)
+{
+    particles.resize(_numParticles);
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this, &particles](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int index = begin; index < end; index++)
+        {
+            Particle &p = particles[index];
+            p._position = glm::vec4(_particles._positionX[index], _particles._positionY[index],
+                _particles._positionZ[index], 1.0f);
+            p._velocity = glm::vec4(_particles._velocityX[index], _particles._velocityY[index],
+                _particles._velocityZ[index], 0.0f);
+            p._numberOfNearbyParticles = _particles._numberOfNearbyParticles[index];
+            p._mass = _particles._mass[index];
+            p._collisionRadius = _particles._collisionRadius[index];
+            p._mortonCode = _particles._mortonCode[index];
+            p._hasCollidedAlreadyThisFrame = _particles._hasCollidedAlreadyThisFrame[index];
+            p._isActive = _particles._isActive[index];
+            p._sceneId = _particles._sceneId[index];
+        }
+    });
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The reverse of ReadParticles(...): takes the particles apart into the arrays.  The free
+    list becomes every inactive particle.
+
+    This lets the differential check (see BackendComparison) start each CPU stage from
+    exactly what the GPU had, so that each stage is checked on its own instead of checking
+    how far the two backends have drifted apart.
+Parameters:
+    particles   Must be NumParticles() of them.
+Returns:
+    False if there are the wrong number of particles (nothing is changed), otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool CpuParticleSimulation::LoadParticles(const std::vector<Particle> &particles)
+{
+    if (particles.size() != _numParticles)
+    {
+        fprintf(stderr, "CpuParticleSimulation: can't load %u particles into %u\n",
+            static_cast<unsigned int>(particles.size()), _numParticles);
+        return false;
+    }
+
+    _threadPool.ParallelFor(_numParticles, MIN_PARTICLES_PER_CHUNK,
+        [this, &particles](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int index = begin; index < end; index++)
+        {
+            const Particle &p = particles[index];
+            _particles._positionX[index] = p._position.x;
+            _particles._positionY[index] = p._position.y;
+            _particles._positionZ[index] = p._position.z;
+            _particles._velocityX[index] = p._velocity.x;
+            _particles._velocityY[index] = p._velocity.y;
+            _particles._velocityZ[index] = p._velocity.z;
+            _particles._numberOfNearbyParticles[index] = p._numberOfNearbyParticles;
+            _particles._mass[index] = p._mass;
+            _particles._collisionRadius[index] = p._collisionRadius;
+            _particles._mortonCode[index] = p._mortonCode;
+            _particles._hasCollidedAlreadyThisFrame[index] = (p._hasCollidedAlreadyThisFrame != 0) ? 1 : 0;
+            _particles._isActive[index] = (p._isActive != 0) ? 1 : 0;
+            _particles._sceneId[index] = static_cast<unsigned char>(p._sceneId);
+        }
+    });
+
+    // lowest index on top, like the GPU's free list after a sort
+    _numActiveParticles = 0;
+    _freeParticleIndices.clear();
+    for (unsigned int index = _numParticles; index > 0; index--)
+    {
+        if (_particles._isActive[index - 1] != 0)
+        {
+            _numActiveParticles++;
+        }
+        else
+        {
+            _freeParticleIndices.push_back(index - 1);
+        }
+    }
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes the particles' render vertices (see ParticleRenderVertex.h) and uploads them into a
+    ParticleSsbo of its own (made on the first call) for RenderParticles to draw.  Requires an
+    OpenGL context and ParticleSsbo::SubmitShaders().
+
+    The draw count goes up to the last active particle.  After a sort that is the number of
+    active particles, like the GPU's count (see ParticleUpdate), and it is still right if
+    this is called between sorts.  Only the vertices up to the draw count are made and
+    uploaded.
+
+    Note: This used to read the particles back into Particle structures and upload all of
+    them, 64 bytes apiece whether they were active or not, every time that they were drawn.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleSsbo::SHARED_PTR CpuParticleSimulation::ParticlesForRendering()
+{
+    if (_renderSsbo == nullptr)
+    {
+        _renderSsbo = std::make_shared<ParticleSsbo>(_numParticles);
+    }
+
+    unsigned int drawCount = _numParticles;
+    while (drawCount > 0 && _particles._isActive[drawCount - 1] == 0)
+    {
+        drawCount--;
+    }
+
+    // same as CountNearbyParticles.comp
+    _renderVertices.resize(_numParticles);
+    _threadPool.ParallelFor(drawCount, MIN_PARTICLES_PER_CHUNK,
+        [this](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int index = begin; index < end; index++)
+        {
+            ParticleRenderVertex &vertex = _renderVertices[index];
+            vertex._positionX = _particles._positionX[index];
+            vertex._positionY = _particles._positionY[index];
+            if (_particles._isActive[index] == 0)
+            {
+                vertex._colorIndex = PARTICLE_RENDER_INACTIVE_COLOR_INDEX;
+            }
+            else
+            {
+                vertex._colorIndex = std::min(_particles._numberOfNearbyParticles[index],
+                    static_cast<unsigned int>(PARTICLE_RENDER_MAX_COLOR_INDEX));
+            }
+        }
+    });
+
+    _renderSsbo->UploadRenderVertices(_renderVertices, drawCount);
+    _renderSsbo->SetDrawCount(drawCount);
+    return _renderSsbo;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints how much memory the particles and the sort take.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::PrintMemoryReport() const
+{
+    size_t particleBytes = _particles.NumBytes();
+    size_t sortBytes = _sortedParticles.NumBytes() + (_sortItems.capacity() * sizeof(unsigned long long)) +
+        _radixSort.NumScratchBytes();
+    size_t freeListBytes = _freeParticleIndices.capacity() * sizeof(unsigned int);
+    printf("CPU simulation: %u threads, %s kernels, %.1lf KB total\n", _threadPool.NumThreads(),
+        CpuParticleKernels::SimdLevelName(_simdLevel),
+        (particleBytes + sortBytes + freeListBytes) / 1024.0);
+    printf("    %10.1lf KB  particles\n", particleBytes / 1024.0);
+    printf("    %10.1lf KB  sort\n", sortBytes / 1024.0);
+    printf("    %10.1lf KB  free list\n", freeListBytes / 1024.0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Starts the thread pool's stats over (see PrintWorkerReport()), ex: after warmup frames.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::ResetWorkerStats()
+{
+    _threadPool.ResetStats();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Prints how the thread pool's work was spread over its threads since the last
+    ResetWorkerStats(): each thread's time in loop bodies, that as a fraction of the time that
+    the loops took (utilization), how many chunks it ran, and how many ranges it stole.  The
+    imbalance is the busiest thread's time over the average; 1.0 is perfect.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::PrintWorkerReport() const
+{
+    double loopTime = _threadPool.TotalLoopTime();
+    double totalBusyTime = 0.0;
+    double maxBusyTime = 0.0;
+    printf("CPU workers: %u threads, %.3lf ms in parallel loops\n", _threadPool.NumThreads(), loopTime * 1000.0);
+    printf("    %6s %10s %8s %10s %8s\n", "thread", "busy ms", "util", "chunks", "steals");
+    for (unsigned int threadIndex = 0; threadIndex < _threadPool.NumThreads(); threadIndex++)
+    {
+        ThreadPool::WorkerStats stats = _threadPool.GetWorkerStats(threadIndex);
+        printf("    %6u %10.3lf %7.1lf%% %10llu %8llu\n", threadIndex, stats._busyTime * 1000.0,
+            (loopTime > 0.0) ? (100.0 * stats._busyTime / loopTime) : 0.0, stats._numChunksRun, stats._numSteals);
+        totalBusyTime += stats._busyTime;
+        maxBusyTime = std::max(maxBusyTime, stats._busyTime);
+    }
+    double averageBusyTime = totalBusyTime / _threadPool.NumThreads();
+    printf("    imbalance (max / average busy): %.2lf\n", (averageBusyTime > 0.0) ? (maxBusyTime / averageBusyTime) : 0.0);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    One pass of ParticleCollisions.comp.  See that file for the math.
+Parameters:
+    indexOffsetBy0Or1   0 for the pairs that start on even indices, 1 for odd.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuParticleSimulation::CollideParticlePairs(unsigned int indexOffsetBy0Or1)
+{
+    unsigned int numPairs = _numParticles / 2;
+    _threadPool.ParallelFor(numPairs, MIN_PARTICLES_PER_CHUNK / 2,
+        [this, indexOffsetBy0Or1](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int pairIndex = begin; pairIndex < end; pairIndex++)
+        {
+            unsigned int index = (pairIndex * 2) + indexOffsetBy0Or1;
+            unsigned int rightNeighborIndex = index + 1;
+            if (rightNeighborIndex >= _numParticles)
+            {
+                continue;
+            }
+
+            if (_particles._isActive[index] == 0 || _particles._isActive[rightNeighborIndex] == 0)
+            {
+                continue;
+            }
+            if (_particles._sceneId[index] != _particles._sceneId[rightNeighborIndex])
+            {
+                continue;
+            }
+            if (_particles._hasCollidedAlreadyThisFrame[index] != 0 ||
+                _particles._hasCollidedAlreadyThisFrame[rightNeighborIndex] != 0)
+            {
+                continue;
+            }
+
+            float minDistForCollision = _particles._collisionRadius[index] + _particles._collisionRadius[rightNeighborIndex];
+            float minDistForCollisionSqr = minDistForCollision * minDistForCollision;
+            float p1ToP2X = _particles._positionX[rightNeighborIndex] - _particles._positionX[index];
+            float p1ToP2Y = _particles._positionY[rightNeighborIndex] - _particles._positionY[index];
+            float p1ToP2Z = _particles._positionZ[rightNeighborIndex] - _particles._positionZ[index];
+            float distP1ToP2Sqr = (p1ToP2X * p1ToP2X) + (p1ToP2Y * p1ToP2Y) + (p1ToP2Z * p1ToP2Z);
+            if (distP1ToP2Sqr > minDistForCollisionSqr)
+            {
+                continue;
+            }
+
+            float v1X = _particles._velocityX[index];
+            float v1Y = _particles._velocityY[index];
+            float v1Z = _particles._velocityZ[index];
+            float v2X = _particles._velocityX[rightNeighborIndex];
+            float v2Y = _particles._velocityY[rightNeighborIndex];
+            float v2Z = _particles._velocityZ[rightNeighborIndex];
+            float m1 = _particles._mass[index];
+            float m2 = _particles._mass[rightNeighborIndex];
+
+            float inverseDist = 1.0f / sqrtf(distP1ToP2Sqr);
+            float lineOfContactX = inverseDist * p1ToP2X;
+            float lineOfContactY = inverseDist * p1ToP2Y;
+            float lineOfContactZ = inverseDist * p1ToP2Z;
+            float a1 = (v1X * p1ToP2X) + (v1Y * p1ToP2Y) + (v1Z * p1ToP2Z);
+            float a2 = (v2X * p1ToP2X) + (v2Y * p1ToP2Y) + (v2Z * p1ToP2Z);
+            float fraction = (2.0f * (a1 - a2)) / (m1 + m2);
+
+            _particles._velocityX[index] = v1X - (fraction * m2 * lineOfContactX);
+            _particles._velocityY[index] = v1Y - (fraction * m2 * lineOfContactY);
+            _particles._velocityZ[index] = v1Z - (fraction * m2 * lineOfContactZ);
+            _particles._hasCollidedAlreadyThisFrame[index] = 1;
+            _particles._velocityX[rightNeighborIndex] = v2X + (fraction * m1 * lineOfContactX);
+            _particles._velocityY[rightNeighborIndex] = v2Y + (fraction * m1 * lineOfContactY);
+            _particles._velocityZ[rightNeighborIndex] = v2Z + (fraction * m1 * lineOfContactZ);
+            _particles._hasCollidedAlreadyThisFrame[rightNeighborIndex] = 1;
+        }
+    });
+}
@@ -0,0 +1,211 @@
+#include "Include/Simulation/CpuRadixSort.h"
+
+#include <string.h>
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Only remembers the thread pool.  The scratch buffers are sized by the first sort.
+Parameters:
+    threadPool  Does the work.  Must outlive this object.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+CpuRadixSort::CpuRadixSort(ThreadPool &threadPool) :
+    _threadPool(threadPool)
+{
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Sorts the items by their keys (the top 32 bits), keeping items with equal keys in the
+    order that they came in.  See the class description for how.
+Parameters:
+    keysAndIndices  (key << 32) | index for each item.  Sorted in place.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuRadixSort::Sort(std::vector<unsigned long long> &keysAndIndices)
+{
+    if (keysAndIndices.size() < 2)
+    {
+        return;
+    }
+    _scratchItems.resize(keysAndIndices.size());
+
+    bool resultIsInScratch = false;
+    for (unsigned int passIndex = 0; passIndex < NUM_PASSES; passIndex++)
+    {
+        unsigned int digitShift = 32 + (passIndex * BITS_PER_DIGIT);
+        bool moved = resultIsInScratch ?
+            SortOnDigit(_scratchItems, keysAndIndices, digitShift) :
+            SortOnDigit(keysAndIndices, _scratchItems, digitShift);
+        if (moved)
+        {
+            resultIsInScratch = !resultIsInScratch;
+        }
+    }
+
+    if (resultIsInScratch)
+    {
+        // no copy; the old array becomes the scratch buffer
+        keysAndIndices.swap(_scratchItems);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    For when there's nothing to carry along but the keys' own positions: sorts the keys and
+    says where each sorted key came from.
+Parameters:
+    keys        Self-explanatory.  Not changed.
+    permutation Resized to the number of keys.  Entry N is the index (in keys) of the Nth
+                smallest key.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void CpuRadixSort::SortToPermutation(const std::vector<unsigned int> &keys, std::vector<unsigned int> &permutation)
+{
+    unsigned int numItems = static_cast<unsigned int>(keys.size());
+    std::vector<unsigned long long> keysAndIndices(numItems);
+    _threadPool.ParallelFor(numItems, MIN_ITEMS_PER_CHUNK,
+        [&keys, &keysAndIndices](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int index = begin; index < end; index++)
+        {
+            keysAndIndices[index] = (static_cast<unsigned long long>(keys[index]) << 32) | index;
+        }
+    });
+
+    Sort(keysAndIndices);
+
+    permutation.resize(numItems);
+    _threadPool.ParallelFor(numItems, MIN_ITEMS_PER_CHUNK,
+        [&keysAndIndices, &permutation](unsigned int /*chunkIndex*/, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int index = begin; index < end; index++)
+        {
+            permutation[index] = static_cast<unsigned int>(keysAndIndices[index] & 0xffffffff);
+        }
+    });
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How much memory the sort keeps between calls.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+size_t CpuRadixSort::NumScratchBytes() const
+{
+    return (_scratchItems.capacity() * sizeof(unsigned long long)) +
+        (_chunkDigitOffsets.capacity() * sizeof(unsigned int));
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    One pass of the sort: counts, then offsets, then scatters (see the class description).
+Parameters:
+    from        The items, sorted by every lower digit.
+    to          Receives the items, sorted by this digit too.  Must be as big as "from".
+    digitShift  Where the digit starts in the 64-bit item.
+Returns:
+    False if every item has the same digit, in which case nothing was written to "to" and
+    "from" is already sorted by this digit.  Otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool CpuRadixSort::SortOnDigit(const std::vector<unsigned long long> &from, std::vector<unsigned long long> &to,
+    unsigned int digitShift)
+{
+    unsigned int numItems = static_cast<unsigned int>(from.size());
+    unsigned int numChunks = _threadPool.NumChunks(numItems, MIN_ITEMS_PER_CHUNK);
+    _chunkDigitOffsets.resize(numChunks * NUM_DIGIT_VALUES);
+
+    // (1) count
+    _threadPool.ParallelFor(numItems, MIN_ITEMS_PER_CHUNK,
+        [this, &from, digitShift](unsigned int chunkIndex, unsigned int begin, unsigned int end)
+    {
+        unsigned int *digitCounts = &_chunkDigitOffsets[chunkIndex * NUM_DIGIT_VALUES];
+        memset(digitCounts, 0, NUM_DIGIT_VALUES * sizeof(unsigned int));
+        for (unsigned int index = begin; index < end; index++)
+        {
+            unsigned int digit = static_cast<unsigned int>(from[index] >> digitShift) & (NUM_DIGIT_VALUES - 1);
+            digitCounts[digit]++;
+        }
+    });
+
+    // (2) offsets, digit by digit and then chunk by chunk
+    // Note: Only 256 * chunks, so not worth threading.
+    unsigned int offset = 0;
+    for (unsigned int digit = 0; digit < NUM_DIGIT_VALUES; digit++)
+    {
+        unsigned int digitBegin = offset;
+        for (unsigned int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+        {
+            unsigned int &countThenOffset = _chunkDigitOffsets[(chunkIndex * NUM_DIGIT_VALUES) + digit];
+            unsigned int count = countThenOffset;
+            countThenOffset = offset;
+            offset += count;
+        }
+
+        if (offset - digitBegin == numItems)
+        {
+            // all the same
+            return false;
+        }
+    }
+
+    // (3) scatter
+    _threadPool.ParallelFor(numItems, MIN_ITEMS_PER_CHUNK,
+        [this, &from, &to, digitShift](unsigned int chunkIndex, unsigned int begin, unsigned int end)
+    {
+        unsigned int *digitOffsets = &_chunkDigitOffsets[chunkIndex * NUM_DIGIT_VALUES];
+        unsigned long long *toItems = to.data();
+
+        // on the stack so that each thread has its own
+        alignas(64) unsigned long long buffers[NUM_DIGIT_VALUES][ITEMS_PER_WRITE_COMBINING_BUFFER];
+        unsigned int numBuffered[NUM_DIGIT_VALUES] = { 0 };
+
+        for (unsigned int index = begin; index < end; index++)
+        {
+            unsigned long long item = from[index];
+            unsigned int digit = static_cast<unsigned int>(item >> digitShift) & (NUM_DIGIT_VALUES - 1);
+            unsigned int bufferCount = numBuffered[digit];
+            buffers[digit][bufferCount] = item;
+            bufferCount++;
+
+            // write when the buffer reaches the end of a cache line in the destination, so
+            // that every write after a digit's first one is a whole line
+            unsigned int writeIndex = digitOffsets[digit];
+            // Note: Only a digit's first write can be short.  A constant size lets the compiler
+            // turn the rest into a few wide stores instead of a call.
+            if (((writeIndex + bufferCount) % ITEMS_PER_WRITE_COMBINING_BUFFER) == 0)
+            {
+                if (bufferCount == ITEMS_PER_WRITE_COMBINING_BUFFER)
+                {
+                    memcpy(toItems + writeIndex, buffers[digit], sizeof(buffers[digit]));
+                }
+                else
+                {
+                    memcpy(toItems + writeIndex, buffers[digit], bufferCount * sizeof(unsigned long long));
+                }
+                digitOffsets[digit] = writeIndex + bufferCount;
+                bufferCount = 0;
+            }
+            numBuffered[digit] = bufferCount;
+        }
+
+        // whatever is left over
+        for (unsigned int digit = 0; digit < NUM_DIGIT_VALUES; digit++)
+        {
+            if (numBuffered[digit] > 0)
+            {
+                memcpy(toItems + digitOffsets[digit], buffers[digit], numBuffered[digit] * sizeof(unsigned long long));
+            }
+        }
+    });
+
+    return true;
+}
@@ -0,0 +1,279 @@
+#include "Include/Simulation/GpuParticleSimulation.h"
+
+#include <stdio.h>
+
+#include "ThirdParty/glload/include/glload/gl_4_4.h"
+#include "Include/Buffers/GpuBufferArena.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Makes the particle buffer and every controller, in the same order that main.cpp used to.
+    Call SubmitShaders(...) first so that the programs compile while the buffers are made.
+Parameters:
+    numParticles    The particle buffer's starting size.
+    variant         The work group sizes and feature defines to build the shaders with.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+GpuParticleSimulation::GpuParticleSimulation(unsigned int numParticles,
+    const ShaderControllers::ComputeShaderVariant &variant) :
+    _particleBuffer(nullptr)
+{
+    _particleBuffer = std::make_shared<ParticleSsbo>(numParticles);
+    _particleResetter = std::make_unique<ShaderControllers::ParticleReset>(_particleBuffer, variant);
+    _particleUpdater = std::make_unique<ShaderControllers::ParticleUpdate>(_particleBuffer, variant);
+    _parallelSort = std::make_unique<ShaderControllers::ParallelSort>(_particleBuffer, variant);
+    _particleCollisions = std::make_unique<ShaderControllers::ParticleCollide>(_particleBuffer, variant);
+    _nearbyParticleCounter = std::make_unique<ShaderControllers::CountNearbyParticles>(_particleBuffer, variant);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Hands every program that the simulation needs to the driver so that they can compile at
+    the same time (see ParallelSort::SubmitShaders(...)).
+Parameters:
+    variant     The work group sizes and feature defines to build the shaders with.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::SubmitShaders(const ShaderControllers::ComputeShaderVariant &variant)
+{
+    ParticleSsbo::SubmitShaders();
+    ShaderControllers::ParticleReset::SubmitShaders(variant);
+    ShaderControllers::ParticleUpdate::SubmitShaders(variant);
+    ShaderControllers::ParallelSort::SubmitShaders(variant);
+    ShaderControllers::ParticleCollide::SubmitShaders(variant);
+    ShaderControllers::CountNearbyParticles::SubmitShaders(variant);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: None
+Returns:
+    "GPU"
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+const char *GpuParticleSimulation::BackendName() const
+{
+    return "GPU";
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::AddEmitter(...).
+Parameters:
+    pointEmitter    Self-explanatory.
+    sceneId         The scene that the emitter's particles belong to.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::AddEmitter(const ParticleEmitterPoint::CONST_SHARED_PTR pointEmitter, unsigned int sceneId)
+{
+    _particleResetter->AddEmitter(pointEmitter, sceneId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::AddEmitter(...).
+Parameters:
+    barEmitter  Self-explanatory.
+    sceneId     The scene that the emitter's particles belong to.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::AddEmitter(const ParticleEmitterBar::CONST_SHARED_PTR barEmitter, unsigned int sceneId)
+{
+    _particleResetter->AddEmitter(barEmitter, sceneId);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::SetRandomSeed(...).
+Parameters:
+    seed    Any value.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::SetRandomSeed(unsigned int seed)
+{
+    _particleResetter->SetRandomSeed(seed);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleReset::ResetParticles(...).
+Parameters:
+    particlesPerEmitterPerFrame     Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::ResetParticles(unsigned int particlesPerEmitterPerFrame)
+{
+    _particleResetter->ResetParticles(particlesPerEmitterPerFrame);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleUpdate::Update(...).
+Parameters:
+    deltaTimeSec    Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::Update(float deltaTimeSec)
+{
+    _particleUpdater->Update(deltaTimeSec);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParallelSort::SortWithoutProfiling().
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::Sort()
+{
+    _parallelSort->SortWithoutProfiling();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleCollide::DetectAndResolveCollisions().
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::DetectAndResolveCollisions()
+{
+    _particleCollisions->DetectAndResolveCollisions();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See CountNearbyParticles::Count().
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::CountNearbyParticles()
+{
+    _nearbyParticleCounter->Count();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Waits for the GPU to finish everything.  It stalls the pipeline, so don't call it every
+    frame unless that's the point (timing, reading back, etc.).
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::Finish()
+{
+    glFinish();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleUpdate::NumActiveParticles().
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuParticleSimulation::NumActiveParticles() const
+{
+    return _particleUpdater->NumActiveParticles();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the particle buffer's size.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int GpuParticleSimulation::NumParticles() const
+{
+    return _particleBuffer->NumItems();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Grows the particle buffer (see ParticleSsbo::Resize(...)) and has every controller that
+    sized something by the old capacity redo it.  The particles that are already in flight
+    carry on as if nothing happened.
+
+    Note: The caller must also redo anything that it set up with ParticlesForRendering()
+    (RenderParticles::ConfigureSsboForRendering(...)), because the particles moved.
+Parameters:
+    numParticles    Must be more than NumParticles().
+Returns:
+    False if the variant's work group sizes can't handle that many particles (nothing is
+    changed) or if the sort couldn't be rebuilt at the new size (the buffer has grown, but the 
+    sort is disabled; see ParallelSort::ParticleBufferResized()), otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool GpuParticleSimulation::Resize(unsigned int numParticles)
+{
+    if (!_parallelSort->CanSort(numParticles))
+    {
+        fprintf(stderr, "GpuParticleSimulation: can't grow to %u particles with this variant\n",
+            numParticles);
+        return false;
+    }
+
+    _particleBuffer->Resize(numParticles);
+
+    // every program that has the buffer size uniform and every dispatch size
+    _particleResetter->ParticleBufferResized(_particleBuffer);
+    _particleUpdater->ParticleBufferResized(_particleBuffer);
+    bool sortResized = _parallelSort->ParticleBufferResized();
+    _particleCollisions->ParticleBufferResized(_particleBuffer);
+    _nearbyParticleCounter->ParticleBufferResized(_particleBuffer);
+    return sortResized;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    See ParticleSsbo::ReadParticles(...).
+Parameters:
+    particles   Resized to NumParticles() and filled in.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::ReadParticles(std::vector<Particle> &particles)
+{
+    _particleBuffer->ReadParticles(particles);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    The particles are already on the GPU, so this is just the particle buffer.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ParticleSsbo::SHARED_PTR GpuParticleSimulation::ParticlesForRendering()
+{
+    return _particleBuffer;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Every SSBO is in the arena, and the sort's scratch buffers are in a transient pool on top
+    of that, so print both.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GpuParticleSimulation::PrintMemoryReport() const
+{
+    GpuBufferArena::GetInstance().PrintMemoryReport();
+    _parallelSort->PrintTransientBufferReport();
+}
@@ -0,0 +1,376 @@
+#include "Include/Simulation/ThreadPool.h"
+
+#include <algorithm>
+
+#include "Include/RenderFrameRate/Stopwatch.h"
+
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Starts the worker threads and makes everybody's deque.  The workers sleep until
+    ParallelFor(...) has something for them.
+Parameters:
+    numThreads  How many threads work on each loop, counting the one that calls
+                ParallelFor(...).  0 means one per hardware thread.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ThreadPool::ThreadPool(unsigned int numThreads) :
+    _numThreads(numThreads),
+    _loopBody(0),
+    _loopNumItems(0),
+    _loopNumChunks(0),
+    _numChunksLeft(0),
+    _loopGeneration(0),
+    _numWorkersBusy(0),
+    _shuttingDown(false),
+    _totalLoopTime(0.0)
+{
+    if (_numThreads == 0)
+    {
+        // may be 0 if it can't tell
+        _numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (unsigned int threadIndex = 0; threadIndex < _numThreads; threadIndex++)
+    {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    ResetStats();
+
+    // the caller is thread 0
+    _workers.reserve(_numThreads - 1);
+    for (unsigned int threadIndex = 1; threadIndex < _numThreads; threadIndex++)
+    {
+        _workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, threadIndex));
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Wakes the workers up to tell them to quit, and waits for them to do it.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shuttingDown = true;
+    }
+    _loopStarted.notify_all();
+
+    for (size_t workerIndex = 0; workerIndex < _workers.size(); workerIndex++)
+    {
+        _workers[workerIndex].join();
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of threads that work on each loop, including the one that
+    calls ParallelFor(...).
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ThreadPool::NumThreads() const
+{
+    return _numThreads;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How many chunks ParallelFor(...) will cut a loop into.  Callers that keep per-chunk
+    results use this to size them.
+Parameters:
+    numItems            Self-explanatory.
+    minItemsPerChunk    Small loops aren't worth waking every thread for, so no chunk is
+                        smaller than this (except the last one may be).
+Returns:
+    See description.  0 if numItems is 0.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+unsigned int ThreadPool::NumChunks(unsigned int numItems, unsigned int minItemsPerChunk) const
+{
+    if (numItems == 0)
+    {
+        return 0;
+    }
+
+    minItemsPerChunk = std::max(minItemsPerChunk, 1u);
+    unsigned int maxChunksBySize = (numItems / minItemsPerChunk) + ((numItems % minItemsPerChunk) ? 1 : 0);
+    return std::min(_numThreads * CHUNKS_PER_THREAD, maxChunksBySize);
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Runs the loop body over [0, numItems) in NumChunks(...) chunks of (nearly) equal size,
+    spread over all the threads, and returns when every chunk is done.  Every thread's deque
+    starts with an equal share of the chunks, and then they balance it out by stealing (see
+    the class description).  The caller works on chunks too instead of just waiting.
+
+    If there is only one chunk, then it is run right here without waking anybody.
+Parameters:
+    numItems            Self-explanatory.
+    minItemsPerChunk    See NumChunks(...).
+    loopBody            Called once per chunk with the chunk's index and its [begin, end).
+                        Called from several threads at once.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ThreadPool::ParallelFor(unsigned int numItems, unsigned int minItemsPerChunk, const LOOP_BODY &loopBody)
+{
+    unsigned int numChunks = NumChunks(numItems, minItemsPerChunk);
+    if (numChunks == 0)
+    {
+        return;
+    }
+
+    Stopwatch loopTimer;
+    loopTimer.Start();
+
+    // the workers aren't running, so nobody else is touching the deques
+    unsigned int numSharingThreads = (numChunks > 1) ? _numThreads : 1;
+    for (unsigned int threadIndex = 0; threadIndex < numSharingThreads; threadIndex++)
+    {
+        ChunkRange share;
+        share._begin = (numChunks * threadIndex) / numSharingThreads;
+        share._end = (numChunks * (threadIndex + 1)) / numSharingThreads;
+        if (share._end > share._begin)
+        {
+            _queues[threadIndex]->_ranges.push_back(share);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _loopBody = &loopBody;
+        _loopNumItems = numItems;
+        _loopNumChunks = numChunks;
+        _numChunksLeft = numChunks;
+        if (numChunks > 1)
+        {
+            _numWorkersBusy = static_cast<unsigned int>(_workers.size());
+            _loopGeneration++;
+        }
+    }
+
+    if (numChunks > 1)
+    {
+        _loopStarted.notify_all();
+    }
+    RunChunks(0);
+
+    // the workers may still be in RunChunks(...) after the last chunk is done, and they must 
+    // be out of it before the loop body goes away
+    std::unique_lock<std::mutex> lock(_mutex);
+    _loopFinished.wait(lock, [this]() { return _numWorkersBusy == 0; });
+    _loopBody = 0;
+    _totalLoopTime += loopTimer.TotalTime();
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    A simple getter for what one thread has done since the last ResetStats().
+
+    Note: Only call this between loops.  The workers write their stats while a loop runs.
+Parameters:
+    threadIndex     0 is the thread that calls ParallelFor(...), 1 and up are the workers.
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+ThreadPool::WorkerStats ThreadPool::GetWorkerStats(unsigned int threadIndex) const
+{
+    return _queues[threadIndex]->_stats;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    How long ParallelFor(...) took, added up since the last ResetStats().  A thread's
+    utilization is its busy time over this.
+Parameters: None
+Returns:
+    See description.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+double ThreadPool::TotalLoopTime() const
+{
+    return _totalLoopTime;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Zeroes every thread's stats and the total loop time.  Only call this between loops.
+Parameters: None
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ThreadPool::ResetStats()
+{
+    for (size_t threadIndex = 0; threadIndex < _queues.size(); threadIndex++)
+    {
+        WorkerStats &stats = _queues[threadIndex]->_stats;
+        stats._busyTime = 0.0;
+        stats._numChunksRun = 0;
+        stats._numSteals = 0;
+    }
+    _totalLoopTime = 0.0;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    What each worker thread does: sleep until there is a new loop, help with it, and go back
+    to sleep.
+Parameters:
+    threadIndex     Which deque is this thread's.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ThreadPool::WorkerLoop(unsigned int threadIndex)
+{
+    unsigned int lastLoopGeneration = 0;
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _loopStarted.wait(lock, [this, lastLoopGeneration]()
+        {
+            return _shuttingDown || (_loopGeneration != lastLoopGeneration);
+        });
+        if (_shuttingDown)
+        {
+            return;
+        }
+        lastLoopGeneration = _loopGeneration;
+        lock.unlock();
+
+        RunChunks(threadIndex);
+
+        lock.lock();
+        _numWorkersBusy--;
+        if (_numWorkersBusy == 0)
+        {
+            _loopFinished.notify_one();
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Runs chunks of the current loop until every chunk is done: from this thread's own deque
+    while it has any, then from the others'.  A range with more than one chunk is split (see
+    the class description) and only its first chunk is run.
+Parameters:
+    threadIndex     Which deque is this thread's.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ThreadPool::RunChunks(unsigned int threadIndex)
+{
+    WorkerStats &stats = _queues[threadIndex]->_stats;
+    while (_numChunksLeft.load() > 0)
+    {
+        ChunkRange range;
+        if (!PopOwnRange(threadIndex, range) && !StealRange(threadIndex, range))
+        {
+            // the last chunks are running on other threads
+            std::this_thread::yield();
+            continue;
+        }
+
+        while (range._end - range._begin > 1)
+        {
+            ChunkRange backHalf;
+            backHalf._begin = range._begin + ((range._end - range._begin) / 2);
+            backHalf._end = range._end;
+            PushOwnRange(threadIndex, backHalf);
+            range._end = backHalf._begin;
+        }
+
+        // 64 bits so that the multiply can't overflow
+        unsigned int chunkIndex = range._begin;
+        unsigned long long numItems = _loopNumItems;
+        unsigned int begin = static_cast<unsigned int>((numItems * chunkIndex) / _loopNumChunks);
+        unsigned int end = static_cast<unsigned int>((numItems * (chunkIndex + 1)) / _loopNumChunks);
+        Stopwatch chunkTimer;
+        chunkTimer.Start();
+        (*_loopBody)(chunkIndex, begin, end);
+        stats._busyTime += chunkTimer.TotalTime();
+        stats._numChunksRun++;
+
+        // last so that nobody leaves while there is still a chunk running
+        _numChunksLeft.fetch_sub(1);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Takes the range at the back of this thread's own deque (the smallest, and the next one
+    in order).
+Parameters:
+    threadIndex     Self-explanatory.
+    range           Receives the range.
+Returns:
+    False if the deque was empty, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool ThreadPool::PopOwnRange(unsigned int threadIndex, ChunkRange &range)
+{
+    WorkerQueue &queue = *_queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue._mutex);
+    if (queue._ranges.empty())
+    {
+        return false;
+    }
+    range = queue._ranges.back();
+    queue._ranges.pop_back();
+    return true;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Takes the range at the front of another thread's deque (the biggest that it has left).
+    The others are tried in order starting with the next thread so that the thieves don't
+    all go after the same one.
+Parameters:
+    threadIndex     The thief.
+    range           Receives the range.
+Returns:
+    False if every other deque was empty, otherwise true.
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+bool ThreadPool::StealRange(unsigned int threadIndex, ChunkRange &range)
+{
+    for (unsigned int victimCount = 1; victimCount < _numThreads; victimCount++)
+    {
+        WorkerQueue &victim = *_queues[(threadIndex + victimCount) % _numThreads];
+        std::lock_guard<std::mutex> lock(victim._mutex);
+        if (!victim._ranges.empty())
+        {
+            range = victim._ranges.front();
+            victim._ranges.pop_front();
+            _queues[threadIndex]->_stats._numSteals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*------------------------------------------------------------------------------------------------
+Description:
+    Puts a range on the back of this thread's own deque.
+Parameters:
+    threadIndex     Self-explanatory.
+    range           Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void ThreadPool::PushOwnRange(unsigned int threadIndex, const ChunkRange &range)
+{
+    WorkerQueue &queue = *_queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue._mutex);
+    queue._ranges.push_back(range);
+}
@@ -34,6 +34,8 @@
 #pragma comment (lib, "ThirdParty/freetype-2.6.1/objs/vc2010/Win32/freetype261d.lib")
 
 #include <stdio.h>
+#include <stdlib.h>     // for strtoul(...)
+#include <string.h>     // for strcmp(...)
 #include <memory>
 #include <algorithm>    // for generating demo data
 
@@ -48,30 +50,48 @@
 #include "Include/Particles/Particle.h"
 #include "Include/Buffers/SSBOs/ParticleSsbo.h"
 #include "Include/Buffers/PersistentAtomicCounterBuffer.h"
-#include "Include/ShaderControllers/ParticleReset.h"
-#include "Include/ShaderControllers/ParticleUpdate.h"
-#include "Include/ShaderControllers/ParallelSort.h"
-#include "Include/ShaderControllers/ParticleCollide.h"
-#include "Include/ShaderControllers/CountNearbyParticles.h"
 #include "Include/ShaderControllers/RenderParticles.h"
+#include "Include/ShaderControllers/ComputeShaderVariant.h"
+#include "Include/Simulation/GpuParticleSimulation.h"
+#include "Include/Simulation/CpuParticleSimulation.h"
 
 
 // for the frame rate counter
 #include "Include/RenderFrameRate/FreeTypeEncapsulated.h"
 #include "Include/RenderFrameRate/Stopwatch.h"
+#include "Include/RenderFrameRate/FramePacer.h"
+#include "Include/RenderFrameRate/FixedTimestep.h"
 
 Stopwatch gTimer;
 FreeTypeEncapsulated gTextAtlases;
 
-ParticleSsbo::SHARED_PTR particleBuffer = nullptr;
-std::unique_ptr<ShaderControllers::ParticleReset> particleResetter = nullptr;
-std::unique_ptr<ShaderControllers::ParticleUpdate> particleUpdater = nullptr;
-std::unique_ptr<ShaderControllers::ParallelSort> parallelSort = nullptr;
-std::unique_ptr<ShaderControllers::ParticleCollide> particleCollisions = nullptr;
-std::unique_ptr<ShaderControllers::CountNearbyParticles> nearbyParticleCounter = nullptr;
+// the simulation and the rendering each get their own ring of fences so that the wait times 
+// say which of them the GPU is behind on
+std::unique_ptr<FramePacer> gSimulationPacer = nullptr;
+std::unique_ptr<FramePacer> gRenderPacer = nullptr;
+
+// the simulation runs in fixed steps, as many as wall time calls for, regardless of how fast 
+// the frames are rendered
+std::unique_ptr<FixedTimestep> gSimulationTimestep = nullptr;
+const float SIMULATION_STEP_SEC = 0.01f;
+const unsigned int MAX_SIMULATION_STEPS_PER_FRAME = 4;
+
+// sorting is by far the most expensive stage, and particles don't move far in one step, so 
+// the sort is skipped on some steps (see UpdateAllTheThings())
+const unsigned int MAX_SIMULATION_STEPS_BETWEEN_SORTS = 2;
+const unsigned int PARTICLES_PER_EMITTER_PER_STEP = 20;
+
+// reset, update, sort, collide, and count nearby, on the GPU or the CPU (see "--backend")
+IParticleSimulation::UNIQUE_PTR particleSimulation = nullptr;
+bool gUseCpuBackend = false;
+unsigned int gNumCpuThreads = 0;
 std::unique_ptr<ShaderControllers::RenderParticles> particleRenderer = nullptr;
 
-const unsigned int MAX_PARTICLE_COUNT = 20000;
+// the starting capacity, unless "--particles N" says otherwise
+// Note: The buffers can grow while running (see GrowParticleCapacity(...)), so this is no 
+// longer a hard limit, and a deployment that needs more doesn't need a rebuild.
+const unsigned int DEFAULT_PARTICLE_CAPACITY = 20000;
+unsigned int gParticleCapacity = DEFAULT_PARTICLE_CAPACITY;
 
 
 /*------------------------------------------------------------------------------------------------
@@ -112,7 +132,45 @@ void Init()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // compiling the shaders is most of the startup time, so keep the linked programs around 
+    // between runs (see ShaderStorage::UseProgramBinaryCache(...))
+    Stopwatch startupTimer;
+    startupTimer.Start();
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    shaderStorageRef.UseProgramBinaryCache("ShaderCache");
+
+    // the work group sizes that the headless runner's --tune found fastest on this renderer, 
+    // if it has been run
+    // Note: A profile that was tuned with fewer particles might not be able to sort this many 
+    // (see ComputeShaderVariant::IsSupported(...)), so fall back to the defaults.
+    ShaderControllers::ComputeShaderVariant computeVariant;
+    if (computeVariant.LoadProfile("ComputeProfile.txt"))
+    {
+        if (computeVariant.IsSupported(gParticleCapacity))
+        {
+            printf("compute shader variant: %s\n", computeVariant.Name().c_str());
+        }
+        else
+        {
+            computeVariant = ShaderControllers::ComputeShaderVariant();
+        }
+    }
+
+    // hand every program to the driver before anything asks for one so that they can compile 
+    // at the same time (or at least while the CPU does other setup)
+    // Note: Each controller's constructor gets its program(s) from ShaderStorage, which waits 
+    // for only that program.
+    // Also Note: The CPU backend still draws from a ParticleSsbo, which needs its own 
+    // programs to fill it.
+    if (gUseCpuBackend)
+    {
+        ParticleSsbo::SubmitShaders();
+    }
+    else
+    {
+        GpuParticleSimulation::SubmitShaders(computeVariant);
+    }
+    ShaderControllers::RenderParticles::SubmitShaders();
 
     // FreeType initialization
     std::string freeTypeShaderKey = "freetype";
@@ -128,7 +186,14 @@ void Init()
     // needing to pass the SSBO into it.  GPU computing in multiple steps creates coupling 
     // between the SSBOs and the shaders, but the compute headers lessen the coupling that needs 
     // to happen on the CPU side.
-    particleBuffer = std::make_unique<ParticleSsbo>(MAX_PARTICLE_COUNT);
+    if (gUseCpuBackend)
+    {
+        particleSimulation = std::make_unique<CpuParticleSimulation>(gParticleCapacity, gNumCpuThreads);
+    }
+    else
+    {
+        particleSimulation = std::make_unique<GpuParticleSimulation>(gParticleCapacity, computeVariant);
+    }
 
     // set up the particle region
     // Note: This mat4 is a convenience for easily moving the particle region center and all 
@@ -141,8 +206,6 @@ void Init()
     // for resetting particles
     // Note: Put the bar emitters across from each and spraying particles toward each other and 
     // up so that the particles collide near the middle with a slight upward velocity.
-    particleResetter = std::make_unique<ShaderControllers::ParticleReset>(particleBuffer);
-
     // bar on the left and emitting up and right
     glm::vec2 bar1P1(-0.8f, +0.2f);
     glm::vec2 bar1P2(-0.8f, -0.2f);
@@ -151,7 +214,7 @@ void Init()
     float maxVel = 0.5f;
     ParticleEmitterBar::SHARED_PTR barEmitter1 = std::make_shared<ParticleEmitterBar>(bar1P1, bar1P2, emitDir1, minVel, maxVel);
     barEmitter1->SetTransform(windowSpaceTransform);
-    particleResetter->AddEmitter(barEmitter1);
+    particleSimulation->AddEmitter(barEmitter1);
 
     // bar on the right and emitting up and left
     //glm::vec2 bar2P1 = glm::vec2(-0.5f, -0.8f);
@@ -162,24 +225,18 @@ void Init()
     glm::vec2 emitDir2 = glm::vec2(-1.0f, +0.1f);
     ParticleEmitterBar::SHARED_PTR barEmitter2 = std::make_shared<ParticleEmitterBar>(bar2P1, bar2P2, emitDir2, minVel, maxVel);
     barEmitter2->SetTransform(windowSpaceTransform);
-    particleResetter->AddEmitter(barEmitter2);
-
-    // for moving particles
-    particleUpdater = std::make_unique<ShaderControllers::ParticleUpdate>(particleBuffer);
-
-    // for sorting particles once they've been updated
-    parallelSort = std::make_unique<ShaderControllers::ParallelSort>(particleBuffer);
-
-    // for detecting and resolving collisions once the particles have been sorted
-    particleCollisions = std::make_unique<ShaderControllers::ParticleCollide>(particleBuffer);
-
-    // determines particle color
-    nearbyParticleCounter = std::make_unique<ShaderControllers::CountNearbyParticles>(particleBuffer);
+    particleSimulation->AddEmitter(barEmitter2);
 
     // for rendering particles
     particleRenderer = std::make_unique<ShaderControllers::RenderParticles>();
-    particleRenderer->ConfigureSsboForRendering(particleBuffer);
+    particleRenderer->ConfigureSsboForRendering(particleSimulation->ParticlesForRendering());
+    printf("startup: %.1lf ms (shader programs: %u from cache, %u compiled)\n", 
+        startupTimer.TotalTime() * 1000.0, shaderStorageRef.NumProgramCacheHits(), 
+        shaderStorageRef.NumProgramCacheMisses());
 
+    // every buffer has been made by now
+    printf("simulation backend: %s\n", particleSimulation->BackendName());
+    particleSimulation->PrintMemoryReport();
 
 
     //// for profiling 
@@ -189,8 +246,14 @@ void Init()
     //parallelSort->SortWithProfiling();
     //parallelSort->SortWithProfiling();
 
+    // keeps the CPU from running too far ahead of the GPU
+    gSimulationPacer = std::make_unique<FramePacer>(FramePacer::DEFAULT_MAX_FRAMES_IN_FLIGHT);
+    gRenderPacer = std::make_unique<FramePacer>(FramePacer::DEFAULT_MAX_FRAMES_IN_FLIGHT);
+
     // the timer will be used for framerate calculations
     gTimer.Start();
+    gSimulationTimestep = std::make_unique<FixedTimestep>(SIMULATION_STEP_SEC, MAX_SIMULATION_STEPS_PER_FRAME);
+    gSimulationTimestep->Start();
 }
 
 #include <chrono>
@@ -200,6 +263,19 @@ void Init()
 Description:
     Updates particle positions, generates the quad tree for the particles' new positions, and 
     commands a new draw.
+
+    Runs as many fixed-size simulation steps as the time since the last call calls for (see 
+    FixedTimestep), which may be none.  
+
+    The sort only needs to run when the sorted order might be wrong enough to matter.  The 
+    collision shader only checks neighbors in the sorted order, so particles that have moved a 
+    little since the last sort are still close enough to their neighbors.  New particles though 
+    are placed in whatever inactive slot is free, which could be anywhere in the buffer, so 
+    resets are held back until a step that sorts, and then all of the held back emissions 
+    happen at once.  The sort runs when either:
+    (1) It has been MAX_SIMULATION_STEPS_BETWEEN_SORTS steps since the last sort, or
+    (2) It is the last step before rendering, so that the particle colors (see 
+        CountNearbyParticles) are calculated with a good sort.
 Parameters: None
 Returns:    None
 Exception:  Safe
@@ -210,54 +286,39 @@ void UpdateAllTheThings()
     using namespace std::chrono;
     steady_clock::time_point start = high_resolution_clock::now();
     
-    // just hard-code it for this demo
-    float deltaTimeSec = 0.01f;
-
-    particleResetter->ResetParticles(20);
-    particleUpdater->Update(deltaTimeSec);
-    parallelSort->SortWithoutProfiling();
-    //parallelSort->SortWithProfiling();
-    particleCollisions->DetectAndResolveCollisions();
-    nearbyParticleCounter->Count();
-
-    
-    
-    
-    
-    
-    //glFinish();
-
-    // okay to declare static; they won't be initialized until the first call to this function, 
-    // before which Init() was already called, so the OpenGL context will be initialized by the 
-    // time that the code gets here
-    static GLsync updateSyncFences[3] = //{ 0,0,0 };
-    {
-        0,  // the "current" index will make a new fence sync object here at the end of the first time through, so don't give it one on startup
-        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
-        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)
-    };
-    static int currentSyncFenceIndex = 0;
-    static int waitSyncFenceIndex = 1;
-
-    GLenum waitReturn = GL_UNSIGNALED;
-    while (waitReturn != GL_ALREADY_SIGNALED && waitReturn != GL_CONDITION_SATISFIED)
+    unsigned int numSteps = gSimulationTimestep->StepsThisFrame();
+    if (numSteps > 0)
     {
-        waitReturn = glClientWaitSync(updateSyncFences[waitSyncFenceIndex], GL_SYNC_FLUSH_COMMANDS_BIT, 1);
+        // wait (without spinning) if the GPU is still working on the last few frames
+        gSimulationPacer->BeginFrame();
+
+        unsigned int stepsSinceLastSort = 0;
+        for (unsigned int stepCount = 0; stepCount < numSteps; stepCount++)
+        {
+            stepsSinceLastSort++;
+            bool isLastStep = (stepCount == (numSteps - 1));
+            bool sortThisStep = isLastStep || (stepsSinceLastSort >= MAX_SIMULATION_STEPS_BETWEEN_SORTS);
+
+            if (sortThisStep)
+            {
+                // make up for the steps that didn't emit
+                particleSimulation->ResetParticles(PARTICLES_PER_EMITTER_PER_STEP * stepsSinceLastSort);
+            }
+            particleSimulation->Update(gSimulationTimestep->StepSize());
+            if (sortThisStep)
+            {
+                particleSimulation->Sort();
+                stepsSinceLastSort = 0;
+            }
+            particleSimulation->DetectAndResolveCollisions();
+        }
+
+        // only the last step's colors are ever seen
+        particleSimulation->CountNearbyParticles();
+
+        // don't let the CPU get too far ahead
+        gSimulationPacer->EndFrame();
     }
-    glDeleteSync(updateSyncFences[waitSyncFenceIndex]);
-
-    // new sync
-    updateSyncFences[currentSyncFenceIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-
-    // update indices
-    currentSyncFenceIndex = (currentSyncFenceIndex == 2) ? 0 : currentSyncFenceIndex + 1;
-    waitSyncFenceIndex = (waitSyncFenceIndex == 2) ? 0 : waitSyncFenceIndex + 1;
-
-
-
-
-
-
 
     // tell glut to call this display() function again on the next iteration of the main loop
     // Note: https://www.opengl.org/discussion_boards/showthread.php/168717-I-dont-understand-what-glutPostRedisplay()-does
@@ -290,11 +351,13 @@ void Display()
     using namespace std::chrono;
     steady_clock::time_point start = high_resolution_clock::now();
 
+    gRenderPacer->BeginFrame();
+
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClearDepth(1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    particleRenderer->Render(particleBuffer);
+    particleRenderer->Render(particleSimulation->ParticlesForRendering());
 
     static int counter = 0;
     counter++;
@@ -312,14 +375,20 @@ void Display()
         frameRate = (double)elapsedFramesPerSecond / elapsedTime;
         elapsedFramesPerSecond = 0;
         elapsedTime -= 1.0f;
-        printf("frame rate: %.2lf, counter = %d\n", frameRate, counter);
+        printf("frame rate: %.2lf, counter = %d, CPU wait per frame: update %.3lf ms, render %.3lf ms, dropped sim steps: %u\n", 
+            frameRate, counter, 
+            gSimulationPacer->AverageFrameWaitTime() * 1000.0, 
+            gRenderPacer->AverageFrameWaitTime() * 1000.0,
+            gSimulationTimestep->NumDroppedSteps());
+        gSimulationPacer->ResetWaitStats();
+        gRenderPacer->ResetWaitStats();
         counter = 0;
     }
     sprintf(frameRateStr, "%.2lf", frameRate);
 
     // number of active particles
     char activeParticleCountStr[32];
-    sprintf(activeParticleCountStr, "active: %d", particleUpdater->NumActiveParticles());
+    sprintf(activeParticleCountStr, "active: %d", particleSimulation->NumActiveParticles());
 
     // Note: The font textures' orgin is their lower left corner, so the "lower left" in screen 
     // space is just above [-1.0f, -1.0f].
@@ -335,6 +404,7 @@ void Display()
 
     // tell the GPU to swap out the displayed buffer with the one that was just rendered
     glutSwapBuffers();
+    gRenderPacer->EndFrame();
 
     steady_clock::time_point end = high_resolution_clock::now();
     //std::cout << "Display(): " << duration_cast<milliseconds>(end - start).count() << " milliseconds" << std::endl;
@@ -358,6 +428,42 @@ void Reshape(int w, int h)
     glViewport(0, 0, w, h);
 }
 
+/*------------------------------------------------------------------------------------------------
+Description:
+    Grows the particle buffer (geometrically, see ParticleSsbo::GrownCapacity(...)) to hold at 
+    least the requested number of particles (see IParticleSimulation::Resize(...)), and then 
+    points the renderer at the new buffer.  The particles that are already in flight carry on 
+    as if nothing happened.
+
+    Does nothing if the simulation refuses the new capacity.  If the buffer grew but the 
+    simulation still failed (the sort couldn't be rebuilt), the renderer is pointed at the new 
+    buffer anyway, since the old one is gone.
+Parameters:
+    minNumParticles     Self-explanatory.
+Returns:    None
+Creator:    agent, 10/2026
+------------------------------------------------------------------------------------------------*/
+void GrowParticleCapacity(unsigned int minNumParticles)
+{
+    unsigned int newCapacity = ParticleSsbo::GrownCapacity(particleSimulation->NumParticles(), minNumParticles);
+    if (newCapacity == particleSimulation->NumParticles())
+    {
+        return;
+    }
+    if (!particleSimulation->Resize(newCapacity) && particleSimulation->NumParticles() != newCapacity)
+    {
+        // refused; already said why
+        return;
+    }
+    gParticleCapacity = newCapacity;
+
+    // the VAO
+    particleRenderer->ConfigureSsboForRendering(particleSimulation->ParticlesForRendering());
+
+    printf("particle capacity: %u\n", newCapacity);
+    particleSimulation->PrintMemoryReport();
+}
+
 /*------------------------------------------------------------------------------------------------
 Description:
     Executes when the user presses a key on the keyboard.
@@ -386,6 +492,12 @@ void Keyboard(unsigned char key, int x, int y)
         glutLeaveMainLoop();
         return;
     }
+    case '+':
+    {
+        // double the capacity
+        GrowParticleCapacity(particleSimulation->NumParticles() + 1);
+        return;
+    }
     default:
         break;
     }
@@ -429,11 +541,22 @@ Creator:    John Cox (2-13-2016)
 ------------------------------------------------------------------------------------------------*/
 void CleanupAll()
 {
+    // the controllers give their programs back to ShaderStorage, so they need to go while the 
+    // context (and the storage singleton) are still around
+    particleRenderer = nullptr;
+    particleSimulation = nullptr;
 }
 
 /*------------------------------------------------------------------------------------------------
 Description:
     Program start and end.
+
+    "--particles N" sets the starting particle capacity (default DEFAULT_PARTICLE_CAPACITY).  
+    The '+' key doubles it while running.
+
+    "--backend cpu" runs the simulation on the CPU (see CpuParticleSimulation) instead of with 
+    the compute shaders, and "--threads N" sets how many threads it uses (default: one per 
+    hardware thread).
 Parameters:
     argc    The number of strings in argv.
     argv    A pointer to an array of null-terminated, C-style strings.
@@ -445,6 +568,38 @@ int main(int argc, char *argv[])
 {
     glutInit(&argc, argv);
 
+    // glutInit(...) takes out the arguments that are meant for it
+    for (int argIndex = 1; argIndex + 1 < argc; argIndex++)
+    {
+        if (strcmp(argv[argIndex], "--particles") == 0)
+        {
+            unsigned int capacity = static_cast<unsigned int>(strtoul(argv[argIndex + 1], 0, 10));
+            if (capacity == 0)
+            {
+                fprintf(stderr, "--particles must be a number greater than 0\n");
+                return 1;
+            }
+            gParticleCapacity = capacity;
+            argIndex++;
+        }
+        else if (strcmp(argv[argIndex], "--backend") == 0)
+        {
+            const char *backend = argv[argIndex + 1];
+            if (strcmp(backend, "cpu") != 0 && strcmp(backend, "gpu") != 0)
+            {
+                fprintf(stderr, "--backend must be gpu or cpu\n");
+                return 1;
+            }
+            gUseCpuBackend = (strcmp(backend, "cpu") == 0);
+            argIndex++;
+        }
+        else if (strcmp(argv[argIndex], "--threads") == 0)
+        {
+            gNumCpuThreads = static_cast<unsigned int>(strtoul(argv[argIndex + 1], 0, 10));
+            argIndex++;
+        }
+    }
+
     int width = 500;
     int height = 500;
     unsigned int displayMode = GLUT_DOUBLE | GLUT_ALPHA | GLUT_DEPTH | GLUT_STENCIL;